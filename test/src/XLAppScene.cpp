@@ -28,6 +28,8 @@
 #include "XLPlatform.h"
 
 #include "XLGlRenderQueue.h"
+#include "XLGlSwapchain.h"
+#include "XLGlView.h"
 #include "XLDefaultShaders.h"
 
 #include "XLVkImageAttachment.h"
@@ -42,8 +44,11 @@ static void AppScene_makeRenderQueue(gl::RenderQueue::Builder &builder, Extent2
 	// extent will be resized automatically to screen size
 	gl::ImageInfo info(extent, gl::ImageUsage::ColorAttachment, platform::graphic::getCommonFormat());
 
+	// compact vertex format for 2D scene
+	auto vertexFormat = gl::VertexFormat::V2F_C4B_T2H_2U;
+
 	// load shaders by ref - do not copy content into engine
-	auto materialFrag = builder.addProgramByRef("Loader_MaterialVert", xenolith::shaders::MaterialVert);
+	auto materialFrag = builder.addProgramByRef("Loader_MaterialVert", xenolith::shaders::getMaterialVertexShader(vertexFormat));
 	auto materialVert = builder.addProgramByRef("Loader_MaterialFrag", xenolith::shaders::MaterialFrag);
 
 
@@ -87,13 +92,23 @@ static void AppScene_makeRenderQueue(gl::RenderQueue::Builder &builder, Extent2
 
 	// Vertex input attachment - per-frame vertex list
 	auto vertexInput = Rc<vk::VertexMaterialAttachment>::create("VertexInput",
-			gl::BufferInfo(gl::BufferUsage::StorageBuffer), materialInput);
+			gl::BufferInfo(gl::BufferUsage::StorageBuffer), materialInput, vertexFormat);
 	vertexInput->setInputCallback(move(cb));
 
+	// Transform attachment - per-frame transformation matrices, filled with vertex input
+	auto transformInput = Rc<vk::MaterialTransformAttachment>::create("TransformInput",
+			gl::BufferInfo(gl::BufferUsage::StorageBuffer), vertexInput);
+
+	// Instance attachment - per-frame instanced quads data, filled with vertex input
+	auto instanceInput = Rc<vk::MaterialInstanceAttachment>::create("InstanceInput",
+			gl::BufferInfo(gl::BufferUsage::StorageBuffer), vertexInput);
+
 	// define pass input-output
 	builder.addPassInput(pass, 0, samplers); // 0
 	builder.addPassInput(pass, 0, vertexInput); // 1
 	builder.addPassInput(pass, 0, materialInput); // 2
+	builder.addPassInput(pass, 0, transformInput); // 3
+	builder.addPassInput(pass, 0, instanceInput); // 4
 	builder.addPassOutput(pass, 0, out);
 
 	// define global input-output
@@ -119,14 +134,27 @@ bool AppScene::init(Extent2 extent) {
 		return false;
 	}
 
+	initNodes();
+	return true;
+}
+
+bool AppScene::init(const Rc<gl::RenderQueue> &queue) {
+	// use queue, compiled for another AppScene
+	if (!Scene::init(queue)) {
+		return false;
+	}
+
+	initNodes();
+	return true;
+}
+
+void AppScene::initNodes() {
 	_sprite = addChild(Rc<Sprite>::create("Xenolith.png"));
 
 	_node1 = addChild(Rc<Sprite>::create());
 	_node1->setColor(Color::Teal_400);
 
 	scheduleUpdate();
-
-	return true;
 }
 
 void AppScene::update(const UpdateTime &time) {
@@ -135,6 +163,8 @@ void AppScene::update(const UpdateTime &time) {
 	auto t = time.app % 1_usec;
 
 	_sprite->setRotation(M_PI * 2.0 * (float(t) / 1_usec));
+
+	updateStat(time);
 }
 
 void AppScene::onEnter(Scene *scene) {
@@ -160,4 +190,71 @@ void AppScene::onContentSizeDirty() {
 	_node1->setAnchorPoint(Anchor::Middle);
 }
 
+void AppScene::onFrameEnded(gl::FrameHandle &frame) {
+	Scene::onFrameEnded(frame);
+
+	if (auto swapchain = frame.getSwapchain()) {
+		if (auto view = swapchain->getView()) {
+			if (auto &dir = view->getDirector()) {
+				if (auto scene = dynamic_cast<AppScene *>(dir->getScene().get())) {
+					scene->addFrameInterval(platform::device::_clock());
+				}
+			}
+		}
+	}
+}
+
+void AppScene::addFrameInterval(uint64_t now) {
+	auto prev = _lastFrameEnd.exchange(now);
+	if (prev && now > prev) {
+		_frameIntervals.add(now - prev);
+	}
+}
+
+void AppScene::updateStat(const UpdateTime &time) {
+	auto &stat = _director->getInputStat();
+	if (stat.events > 0) {
+		++ _input.frames;
+		_input.events += stat.events;
+		_input.coalesced += stat.coalesced;
+		_input.processTime += stat.processTime;
+		_input.processTimeMax = std::max(_input.processTimeMax, stat.processTime);
+		_input.scroll += _director->getPointerWheel().amount;
+		_input.rawMotion += _director->getRawPointerDelta();
+		for (auto &it : _director->getInputEvents()) {
+			if (it.event == InputEventName::Begin || it.event == InputEventName::End) {
+				++ _input.buttons;
+			}
+		}
+	}
+
+	if (!_statTime) {
+		_statTime = time.global;
+		return;
+	}
+
+	if (time.global - _statTime < 1_usec) {
+		return;
+	}
+
+	_statTime = time.global;
+
+	auto frames = _frameIntervals.getStat(true);
+	log::vtext("AppScene", "Frames: ", frames.count, " interval p50: ", frames.p50, " p95: ", frames.p95,
+			" p99: ", frames.p99, " max: ", frames.max);
+
+	auto snapshots = _director->getSnapshotStat();
+	log::vtext("AppScene", "Snapshots: requested: ", snapshots.requested, " built: ", snapshots.built,
+			" capture: ", snapshots.captureTime, " visit: ", snapshots.visitTime, " overlap: ", snapshots.overlapTime,
+			" age: ", snapshots.age);
+
+	if (_input.frames > 0) {
+		log::vtext("AppScene", "Input: frames: ", _input.frames, " events: ", _input.events, " coalesced: ", _input.coalesced,
+				" buttons: ", _input.buttons, " dropped: ", stat.dropped,
+				" process avg: ", _input.processTime / _input.frames, " max: ", _input.processTimeMax,
+				" scrollX: ", _input.scroll.x, " scrollY: ", _input.scroll.y, " rawX: ", _input.rawMotion.x, " rawY: ", _input.rawMotion.y);
+		_input = InputSummary();
+	}
+}
+
 }
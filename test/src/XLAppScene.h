@@ -33,6 +33,7 @@ public:
 	virtual ~AppScene() { }
 
 	virtual bool init(Extent2 extent);
+	virtual bool init(const Rc<gl::RenderQueue> &);
 
 	virtual void update(const UpdateTime &) override;
 
@@ -40,9 +41,36 @@ public:
 	virtual void onExit() override;
 	virtual void onContentSizeDirty() override;
 
+	// queue callbacks are bound to scene, that compiled the queue, frame is forwarded to scene of its view
+	virtual void onFrameEnded(gl::FrameHandle &) override;
+
 protected:
+	// input of current frame, summed for stat interval
+	struct InputSummary {
+		uint32_t frames = 0; // updates with input events
+		uint32_t events = 0;
+		uint32_t coalesced = 0;
+		uint32_t buttons = 0; // Begin and End events
+		uint64_t processTime = 0;
+		uint64_t processTimeMax = 0;
+		Vec2 scroll;
+		Vec2 rawMotion;
+	};
+
+	void initNodes();
+
+	void addFrameInterval(uint64_t now);
+	void updateStat(const UpdateTime &);
+
 	Sprite *_sprite = nullptr;
 	Sprite *_node1 = nullptr;
+
+	// frame intervals on GL thread and input processing on main thread, logged once per second,
+	// parsed by tests in test/xvfb
+	gl::LatencyHistogram _frameIntervals;
+	std::atomic<uint64_t> _lastFrameEnd = 0;
+	InputSummary _input;
+	uint64_t _statTime = 0;
 };
 
 }
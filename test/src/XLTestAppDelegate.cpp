@@ -27,6 +27,7 @@
 #include "XLAppScene.h"
 #include "XLAppShaders.h"
 #include "XLDefaultShaders.h"
+#include "XLTestSuite.h"
 
 namespace stappler::xenolith::app {
 
@@ -45,11 +46,16 @@ bool AppDelegate::onFinishLaunching() {
 }
 
 bool AppDelegate::onMainLoop() {
+	// queue is compiled once, every view presents own scene with it,
+	// swapchain images and framebuffers are owned by view's swapchain
 	auto scene = Rc<AppScene>::create(Extent2(1024, 768));
 
-	_glLoop->compileRenderQueue(scene->getRenderQueue(), [&] (bool success) {
-		performOnMainThread([&] {
-			runMainView(move(scene));
+	_glLoop->compileRenderQueue(scene->getRenderQueue(), [this, scene] (bool success) {
+		performOnMainThread([this, scene] {
+			for (uint32_t i = 1; i < _data.views; ++ i) {
+				runMainView(Rc<AppScene>::create(scene->getRenderQueue()), i);
+			}
+			runMainView(Rc<Scene>(scene), 0);
 		});
 		log::text("App", "Compiled");
 	});
@@ -57,15 +63,17 @@ bool AppDelegate::onMainLoop() {
 	return _loop->run();
 }
 
-void AppDelegate::runMainView(Rc<Scene> &&scene) {
+bool AppDelegate::onTest(StringView filter) {
+	return TestSuite::run(filter);
+}
+
+void AppDelegate::runMainView(Rc<Scene> &&scene, uint32_t idx) {
 	auto dir = Rc<Director>::create(this, move(scene));
 
-	auto view = platform::graphic::createView(_loop, _glLoop, "Xenolith",
-			URect{0, 0, uint32_t(_data.screenSize.width), uint32_t(_data.screenSize.height)});
+	auto name = (idx == 0) ? String("Xenolith") : toString("Xenolith #", idx + 1);
+	auto offset = idx * 32;
 
-	view->begin(dir, [this] {
-		_loop->pushEvent(AppEvent::Terminate);
-	});
+	openView(dir, name, URect{offset, offset, uint32_t(_data.screenSize.width), uint32_t(_data.screenSize.height)});
 }
 
 }
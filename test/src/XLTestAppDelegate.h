@@ -34,9 +34,10 @@ public:
 
     virtual bool onFinishLaunching() override;
 	virtual bool onMainLoop() override;
+	virtual bool onTest(StringView) override;
 
 protected:
-	void runMainView(Rc<Scene> &&scene);
+	void runMainView(Rc<Scene> &&scene, uint32_t idx);
 };
 
 }
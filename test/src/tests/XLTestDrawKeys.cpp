@@ -0,0 +1,103 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLTestSuite.h"
+#include "XLVkDrawKeys.h"
+
+namespace stappler::xenolith::app {
+
+static Vector<Pair<uint64_t, uint32_t>> TestDrawKeys_makeKeys(size_t count, uint64_t seed, uint64_t mask) {
+	Vector<Pair<uint64_t, uint32_t>> ret;
+	ret.reserve(count);
+	for (size_t i = 0; i < count; ++ i) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		ret.emplace_back(seed & mask, uint32_t(i));
+	}
+	return ret;
+}
+
+// radix sort should be stable and match std::stable_sort by key
+static bool TestDrawKeys_check(TestSuite &test, Vector<Pair<uint64_t, uint32_t>> keys, StringView what) {
+	auto expected = keys;
+	std::stable_sort(expected.begin(), expected.end(), [] (const Pair<uint64_t, uint32_t> &l, const Pair<uint64_t, uint32_t> &r) {
+		return l.first < r.first;
+	});
+
+	vk::sortDrawKeys(keys);
+	return test.expect(keys == expected, toString(what, ": ", keys.size(), " keys"));
+}
+
+static TestSuite s_drawKeysTest("vk.DrawKeys", [] (TestSuite &test) -> bool {
+	// fields are ordered: subpass, pass, pipeline, texture set, depth
+	test.expect(vk::makeDrawKey(0, true, 0x7FFF, 0xFFFF, 0x0FFF'FFFF) < vk::makeDrawKey(1, false, 0, 0, 0), "subpass is most significant");
+	test.expect(vk::makeDrawKey(0, false, 0x7FFF, 0xFFFF, 0x0FFF'FFFF) < vk::makeDrawKey(0, true, 0, 0, 0), "opaque draws go before translucent");
+	test.expect(vk::makeDrawKey(0, false, 1, 0xFFFF, 0x0FFF'FFFF) < vk::makeDrawKey(0, false, 2, 0, 0), "pipeline goes before texture set");
+	test.expect(vk::makeDrawKey(0, false, 1, 1, 0x0FFF'FFFF) < vk::makeDrawKey(0, false, 1, 2, 0), "texture set goes before depth");
+	test.expect(vk::makeDrawKey(0, false, 1, 1, 1) < vk::makeDrawKey(0, false, 1, 1, 2), "depth is least significant");
+
+	// out of range values do not overflow into other fields
+	test.expect(vk::makeDrawKey(0, false, 0, 0, 0x1000'0000) == vk::makeDrawKey(0, false, 0, 0, 0), "depth is masked");
+	test.expect(vk::makeDrawKey(0, false, 0x8000, 0, 0) == vk::makeDrawKey(0, false, 0, 0, 0), "pipeline is masked");
+
+	for (size_t count : { 0, 1, 2, 3, 17, 256, 1000, 4097 }) {
+		TestDrawKeys_check(test, TestDrawKeys_makeKeys(count, count, maxOf<uint64_t>()), "random keys");
+
+		// many equal keys, order of values should be preserved
+		TestDrawKeys_check(test, TestDrawKeys_makeKeys(count, count, 0x0300'0000'0000'0003ULL), "duplicate keys");
+	}
+
+	// all digits are equal, every pass is skipped
+	TestDrawKeys_check(test, Vector<Pair<uint64_t, uint32_t>>(64, Pair<uint64_t, uint32_t>(0x1234, 0)), "equal keys");
+
+	// keys, that differ only in single byte, result stays in temporary buffer after odd number of passes
+	TestDrawKeys_check(test, TestDrawKeys_makeKeys(512, 7, 0xFF00'0000'0000'0000ULL), "single digit");
+
+	return true;
+});
+
+static TestSuite s_drawKeysBenchmark("vk.DrawKeys.bench", [] (TestSuite &test) -> bool {
+	// typical frame: tens of pipelines and texture sets, depth from submission order
+	Vector<Pair<uint64_t, uint32_t>> keys;
+	uint64_t seed = 1;
+	for (uint32_t i = 0; i < 100'000; ++ i) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		keys.emplace_back(vk::makeDrawKey(0, (seed >> 20) % 4 == 0, uint32_t(seed >> 32) % 32, uint32_t(seed >> 40) % 64, i), i);
+	}
+
+	auto radix = keys;
+	test.benchmark("radix sort, 100000 keys", 20, [&] {
+		radix = keys;
+		vk::sortDrawKeys(radix);
+	});
+
+	auto comparison = keys;
+	test.benchmark("std::sort, 100000 keys", 20, [&] {
+		comparison = keys;
+		std::sort(comparison.begin(), comparison.end(), [] (const Pair<uint64_t, uint32_t> &l, const Pair<uint64_t, uint32_t> &r) {
+			return l.first < r.first;
+		});
+	});
+
+	return test.expect(radix == comparison, "results are equal");
+});
+
+}
@@ -0,0 +1,213 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLTestSuite.h"
+#include "XLInputQueue.h"
+#include "XLDirector.h"
+#include "XLApplication.h"
+
+namespace stappler::xenolith::app {
+
+// allows to start queue near counter overflow
+class TestInputQueue : public InputQueue {
+public:
+	void setPosition(uint32_t pos) {
+		_head.store(pos);
+		_tail.store(pos);
+	}
+};
+
+static InputEventData TestInputQueue_event(InputEventName name, uint32_t id, float x, float y, uint64_t time) {
+	InputEventData ret;
+	ret.id = id;
+	ret.event = name;
+	ret.x = x;
+	ret.y = y;
+	ret.time = time;
+	return ret;
+}
+
+static bool TestInputQueue_checkOrder(TestSuite &test, InputQueue &queue, uint32_t first, uint32_t count, StringView what) {
+	uint32_t next = first;
+	bool ordered = true;
+	auto popped = queue.pop([&] (const InputEventData &event) {
+		ordered = ordered && event.id == next;
+		++ next;
+	});
+	return test.expect(ordered && popped == count && next == first + count, toString(what, ": popped ", popped, " of ", count));
+}
+
+static TestSuite s_inputQueueTest("core.InputQueue", [] (TestSuite &test) -> bool {
+	// capacity is rounded up to power of two, events over capacity are dropped
+	auto queue = Rc<TestInputQueue>::create(1000);
+	for (uint32_t i = 0; i < 1100; ++ i) {
+		queue->push(TestInputQueue_event(InputEventName::MouseMove, i, 0.0f, 0.0f, i));
+	}
+	test.expect(queue->getDropped() == 1100 - 1024, toString("dropped ", queue->getDropped()));
+	TestInputQueue_checkOrder(test, *queue, 0, 1024, "full queue");
+	test.expect(queue->pop([] (const InputEventData &) { }) == 0, "empty queue");
+
+	// counters overflow in the middle of queue
+	queue->setPosition(maxOf<uint32_t>() - 10);
+	for (uint32_t i = 0; i < 20; ++ i) {
+		queue->push(TestInputQueue_event(InputEventName::MouseMove, i, 0.0f, 0.0f, i));
+	}
+	TestInputQueue_checkOrder(test, *queue, 0, 20, "counter overflow");
+
+	for (uint32_t i = 0; i < 1024; ++ i) {
+		queue->push(TestInputQueue_event(InputEventName::MouseMove, i, 0.0f, 0.0f, i));
+	}
+	test.expect(!queue->push(InputEventData()), "full after overflow");
+	TestInputQueue_checkOrder(test, *queue, 0, 1024, "full queue after overflow");
+
+	// producer and consumer threads, producer retries when queue is full, so nothing should be lost
+	static constexpr uint32_t Count = 1'000'000;
+	auto spsc = Rc<InputQueue>::create(64);
+	std::thread producer([&] {
+		for (uint32_t i = 0; i < Count; ++ i) {
+			while (!spsc->push(TestInputQueue_event(InputEventName::MouseMove, i, float(i), 0.0f, i))) {
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	uint32_t next = 0;
+	bool ordered = true;
+	while (next < Count) {
+		spsc->pop([&] (const InputEventData &event) {
+			ordered = ordered && event.id == next && event.x == float(next) && event.time == next;
+			++ next;
+		});
+	}
+	producer.join();
+
+	test.expect(ordered && next == Count, toString("concurrent: ", next, " events in order"));
+
+	return true;
+});
+
+static TestSuite s_inputMotionHistoryTest("core.InputMotionHistory", [] (TestSuite &test) -> bool {
+	InputMotionHistory history;
+	test.expect(history.getVelocity() == Vec2::ZERO, "no samples");
+
+	history.add(Vec2(10.0f, 10.0f), 1'000);
+	test.expect(history.getVelocity() == Vec2::ZERO, "single sample");
+
+	history.add(Vec2(20.0f, 10.0f), 1'000);
+	test.expect(history.getVelocity() == Vec2::ZERO, "same time");
+
+	// 100 points per second along x, -50 along y, sample every 10ms
+	history.clear();
+	for (uint32_t i = 0; i < 100; ++ i) {
+		history.add(Vec2(float(i), -float(i) * 0.5f), uint64_t(i) * 10'000);
+	}
+
+	test.expect(history.size() == config::InputMotionHistorySize, toString("size ", history.size()));
+
+	auto samples = history.get();
+	bool ordered = samples.size() == config::InputMotionHistorySize;
+	for (size_t i = 0; i < samples.size() && ordered; ++ i) {
+		auto idx = 100 - config::InputMotionHistorySize + i;
+		ordered = samples[i].time == idx * 10'000 && samples[i].point.x == float(idx);
+	}
+	test.expect(ordered, "samples are ordered, newest last");
+
+	auto v = history.getVelocity();
+	test.expect(std::abs(v.x - 100.0f) < 0.01f && std::abs(v.y + 50.0f) < 0.01f, toString("velocity ", v));
+
+	// only samples within velocity interval are used: slow start, fast end
+	history.clear();
+	uint64_t t = 0;
+	float x = 0.0f;
+	for (uint32_t i = 0; i < 20; ++ i) {
+		history.add(Vec2(x, 0.0f), t);
+		x += 1.0f;
+		t += 10'000;
+	}
+	for (uint32_t i = 0; i < 10; ++ i) {
+		history.add(Vec2(x, 0.0f), t);
+		x += 10.0f;
+		t += 10'000;
+	}
+
+	// last sample is x = 110 at 290ms, first one within 100ms interval is slow sample x = 19 at 190ms
+	v = history.getVelocity();
+	auto expected = (110.0f - 19.0f) * 10.0f;
+	test.expect(std::abs(v.x - expected) < 0.5f, toString("velocity within interval ", v.x, ", expected ", expected));
+
+	return true;
+});
+
+// motion, scroll and raw motion are coalesced within frame, history keeps every sample
+static TestSuite s_directorInputTest("core.Director.input", [] (TestSuite &test) -> bool {
+	auto dir = Rc<Director>::create(Application::getInstance(), nullptr);
+
+	dir->pushInputEvent(TestInputQueue_event(InputEventName::Begin, 1, 0.0f, 0.0f, 0));
+	for (uint32_t i = 1; i <= 5; ++ i) {
+		dir->pushInputEvent(TestInputQueue_event(InputEventName::Move, 1, float(i) * 10.0f, 0.0f, i * 10'000));
+	}
+
+	auto scroll = TestInputQueue_event(InputEventName::Scroll, 0, 5.0f, 5.0f, 60'000);
+	for (uint32_t i = 0; i < 3; ++ i) {
+		scroll.valueY = 1.0f;
+		scroll.time += 1'000;
+		dir->pushInputEvent(scroll);
+	}
+
+	auto raw = TestInputQueue_event(InputEventName::RawMotion, 0, 0.0f, 0.0f, 70'000);
+	raw.valueX = 2.0f;
+	dir->pushInputEvent(raw);
+	dir->pushInputEvent(raw);
+
+	dir->pushInputEvent(TestInputQueue_event(InputEventName::End, 1, 60.0f, 0.0f, 80'000));
+
+	dir->update();
+
+	auto &events = dir->getInputEvents();
+	if (!test.expect(events.size() == 5, toString("events ", events.size()))) {
+		return false;
+	}
+
+	test.expect(events[0].event == InputEventName::Begin, "begin");
+	test.expect(events[1].event == InputEventName::Move && events[1].x == 50.0f && events[1].coalesced == 4
+			&& events[1].time == 50'000, "moves are merged into last one");
+	test.expect(events[2].event == InputEventName::Scroll && events[2].valueY == 3.0f && events[2].coalesced == 2, "scroll is summed");
+	test.expect(events[3].event == InputEventName::RawMotion && events[3].valueX == 4.0f, "raw motion is summed");
+	test.expect(events[4].event == InputEventName::End, "end");
+
+	test.expect(dir->getInputStat().coalesced == 4 + 2 + 1, toString("coalesced ", dir->getInputStat().coalesced));
+	test.expect(dir->getRawPointerDelta() == Vec2(4.0f, 0.0f), "raw delta");
+	test.expect(dir->getPointerWheel().amount == Vec2(0.0f, 3.0f), "wheel amount");
+
+	// begin, 5 moves and end are all in history, 1 point per ms
+	test.expect(dir->getMotionHistory().size() == 7, toString("motion samples ", dir->getMotionHistory().size()));
+	auto v = dir->getPointerVelocity();
+	test.expect(std::abs(v.x - 750.0f) < 0.5f, toString("pointer velocity ", v));
+
+	// next frame starts with empty event list
+	dir->update();
+	test.expect(dir->getInputEvents().empty() && dir->getRawPointerDelta() == Vec2::ZERO, "events are cleared");
+
+	return true;
+});
+
+}
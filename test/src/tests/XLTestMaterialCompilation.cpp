@@ -0,0 +1,147 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLTestSuite.h"
+#include "XLVkMaterialCompilationAttachment.h"
+#include "XLVkMaterialRenderPass.h"
+
+namespace stappler::xenolith::app {
+
+static constexpr uint32_t TestMaterialCompilation_Count = 10'000;
+
+static Rc<gl::Material> TestMaterialCompilation_make(uint32_t i) {
+	// material data of different sizes, so byte budget is also reached
+	return Rc<gl::Material>::create(nullptr, Vector<gl::MaterialImage>(), Bytes((i % 7) * 64, uint8_t(i)));
+}
+
+// emulates Device::compileMaterials: new requests are coalesced in queue, every frame compiles one budgeted batch
+static TestSuite s_materialCompilationTest("vk.MaterialCompilation", [] (TestSuite &test) -> bool {
+	auto attachment = Rc<vk::MaterialVertexAttachment>::create("MaterialInput", gl::BufferInfo(gl::BufferUsage::StorageBuffer));
+	auto pass = Rc<vk::MaterialCompilationRenderPass>::create("MaterialRenderPass");
+	auto objectSize = attachment->getMaterialObjectSize();
+
+	Vector<Rc<gl::Material>> materials;
+	materials.reserve(TestMaterialCompilation_Count);
+	for (uint32_t i = 0; i < TestMaterialCompilation_Count; ++ i) {
+		materials.emplace_back(TestMaterialCompilation_make(i));
+	}
+
+	Map<gl::MaterialId, uint32_t> compiled;
+	uint32_t frames = 0;
+
+	auto runFrame = [&] {
+		auto req = pass->popRequest(attachment);
+		if (!test.expect(req && req->attachment == attachment.get() && !req->materials.empty(), "frame has materials")) {
+			return false;
+		}
+
+		size_t bytes = 0;
+		for (auto &it : req->materials) {
+			bytes += objectSize + it->getData().size();
+			++ compiled[it->getId()];
+		}
+
+		test.expect(req->materials.size() <= config::MaxMaterialsPerCompilation,
+				toString("frame ", frames, ": ", req->materials.size(), " materials"));
+		test.expect(bytes <= config::MaxMaterialBytesPerCompilation || req->materials.size() == 1,
+				toString("frame ", frames, ": ", bytes, " bytes"));
+		++ frames;
+		return true;
+	};
+
+	// burst of small requests (scrolling gallery): one request per sprite, compilation frames run in between
+	uint32_t requests = 0;
+	for (uint32_t i = 0; i < TestMaterialCompilation_Count; i += 10) {
+		pass->appendRequest(attachment, Vector<Rc<gl::Material>>(materials.begin() + i, materials.begin() + i + 10));
+		++ requests;
+		if (i % 2000 == 0 && pass->hasRequest(attachment)) {
+			runFrame();
+		}
+	}
+
+	// some materials are updated while still queued, only latest version should be compiled
+	for (uint32_t i = TestMaterialCompilation_Count - 100; i < TestMaterialCompilation_Count; ++ i) {
+		pass->appendRequest(attachment, Vector<Rc<gl::Material>>({ materials[i] }));
+		++ requests;
+	}
+
+	while (pass->hasRequest(attachment)) {
+		if (!runFrame()) {
+			break;
+		}
+	}
+
+	test.expect(compiled.size() == TestMaterialCompilation_Count, toString("compiled ", compiled.size(), " materials"));
+
+	bool once = true;
+	for (auto &it : compiled) {
+		once = once && it.second == 1;
+	}
+	test.expect(once, "every material compiled once");
+
+	// frame count is bounded with budget, not with number of requests:
+	// every full frame is limited by count or by bytes (minus largest material), plus partial frames within burst
+	size_t totalBytes = 0;
+	for (auto &it : materials) {
+		totalBytes += objectSize + it->getData().size();
+	}
+	auto maxFrames = 5 + 1 + TestMaterialCompilation_Count / config::MaxMaterialsPerCompilation
+			+ totalBytes / (config::MaxMaterialBytesPerCompilation - objectSize - 6 * 64);
+	test.expect(frames < requests && frames <= maxFrames, toString(frames, " frames for ", requests, " requests, expected at most ", maxFrames));
+
+	// oversized material is compiled alone, so queue always makes progress
+	auto huge = Rc<gl::Material>::create(nullptr, Vector<gl::MaterialImage>(), Bytes(config::MaxMaterialBytesPerCompilation * 2));
+	pass->appendRequest(attachment, Vector<Rc<gl::Material>>({ huge, materials.front() }));
+	auto first = pass->popRequest(attachment);
+	auto second = pass->popRequest(attachment);
+	test.expect(first && second && first->materials.size() + second->materials.size() == 2 && !pass->hasRequest(attachment), "oversized material");
+
+	log::vtext("Test", "vk.MaterialCompilation: ", TestMaterialCompilation_Count, " materials, ",
+			requests, " requests, ", frames, " compilation frames");
+
+	return true;
+});
+
+static TestSuite s_materialCompilationBenchmark("vk.MaterialCompilation.bench", [] (TestSuite &test) -> bool {
+	auto attachment = Rc<vk::MaterialVertexAttachment>::create("MaterialInput", gl::BufferInfo(gl::BufferUsage::StorageBuffer));
+	auto pass = Rc<vk::MaterialCompilationRenderPass>::create("MaterialRenderPass");
+
+	Vector<Rc<gl::Material>> materials;
+	materials.reserve(TestMaterialCompilation_Count);
+	for (uint32_t i = 0; i < TestMaterialCompilation_Count; ++ i) {
+		materials.emplace_back(TestMaterialCompilation_make(i));
+	}
+
+	size_t batches = 0;
+	test.benchmark("coalesce and split 10000 single-material requests", 10, [&] {
+		for (auto &it : materials) {
+			pass->appendRequest(attachment, Vector<Rc<gl::Material>>({ it }));
+		}
+		while (pass->popRequest(attachment)) {
+			++ batches;
+		}
+	});
+
+	return test.expect(batches > 0 && !pass->hasRequest(attachment), "queue is empty");
+});
+
+}
@@ -0,0 +1,174 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLTestScene.h"
+#include "XLGlRenderQueue.h"
+#include "XLRenderFrameInfo.h"
+
+namespace stappler::xenolith::app {
+
+bool TestScene::init(Size size) {
+	gl::RenderQueue::Builder builder("TestScene", gl::RenderQueue::RenderOnDemand);
+	return Scene::init(move(builder), size);
+}
+
+void TestScene::present(Director *dir) {
+	_director = dir;
+	onEnter(this);
+}
+
+void TestScene::finish() {
+	onExit();
+	_director = nullptr;
+}
+
+Rc<gl::CommandList> TestScene::renderFrame(thread::TaskQueue *queue, const Rect &viewRect) {
+	Rc<gl::CommandList> ret;
+	auto pool = Rc<PoolRef>::alloc();
+	pool->perform([&] {
+		RenderFrameInfo info;
+		info.director = _director;
+		info.scene = this;
+		info.pool = pool->getPool();
+		info.transformStack.reserve(8);
+		info.zPath.reserve(8);
+		info.transformStack.push_back(Mat4::IDENTITY);
+		info.commands = Rc<gl::CommandList>::create(pool);
+		info.queue = queue;
+		info.viewRect = viewRect;
+
+		render(info);
+
+		ret = move(info.commands);
+	});
+	return ret;
+}
+
+Rc<gl::CommandList> TestScene::renderFrameOnWorker(thread::TaskQueue *queue, const Rect &viewRect) {
+	auto pool = Rc<PoolRef>::alloc();
+	Rc<gl::CommandList> ret;
+	pool->perform([&] {
+		RenderFrameInfo info;
+		info.director = _director;
+		info.scene = this;
+		info.pool = pool->getPool();
+		info.transformStack.push_back(Mat4::IDENTITY);
+		info.commands = Rc<gl::CommandList>::create(pool);
+
+		capture(info);
+
+		ret = move(info.commands);
+	});
+
+	Mutex mutex;
+	std::condition_variable cond;
+	bool completed = false;
+
+	queue->perform(Rc<thread::Task>::create([&] (const thread::Task &) -> bool {
+		pool->perform([&] {
+			RenderFrameInfo info;
+			info.director = _director;
+			info.scene = this;
+			info.pool = pool->getPool();
+			info.transformStack.reserve(8);
+			info.zPath.reserve(8);
+			info.transformStack.push_back(Mat4::IDENTITY);
+			info.commands = ret;
+			info.queue = queue;
+			info.viewRect = viewRect;
+
+			emit(info);
+		});
+
+		std::unique_lock<Mutex> lock(mutex);
+		completed = true;
+		cond.notify_all();
+		return true;
+	}));
+
+	std::unique_lock<Mutex> lock(mutex);
+	cond.wait(lock, [&] { return completed; });
+	return ret;
+}
+
+bool TestQuadNode::init(const Rc<gl::VertexData> &data, gl::MaterialId material) {
+	if (!Node::init()) {
+		return false;
+	}
+
+	_data = data;
+	_material = material;
+	return true;
+}
+
+void TestQuadNode::draw(RenderFrameInfo &info, NodeFlags flags) {
+	info.commands->pushVertexArray(_data, info.transformStack.back(), info.zPath, _material);
+}
+
+bool compareCommandLists(const gl::CommandList &l, const gl::CommandList &r, String &error, bool compareDamage) {
+	auto a = l.getFirst();
+	auto b = r.getFirst();
+	size_t idx = 0;
+	while (a && b) {
+		if (a->type != b->type) {
+			error = toString("command ", idx, ": type mismatch");
+			return false;
+		}
+
+		if (a->type == gl::CommandType::VertexArray) {
+			auto da = (const gl::CmdVertexArray *)a->data;
+			auto db = (const gl::CmdVertexArray *)b->data;
+			if (da->vertexes != db->vertexes || da->material != db->material) {
+				error = toString("command ", idx, ": data mismatch");
+				return false;
+			}
+			if (memcmp(da->transform.m, db->transform.m, sizeof(Mat4::m)) != 0) {
+				error = toString("command ", idx, ": transform mismatch");
+				return false;
+			}
+			if (da->zPath.size() != db->zPath.size()
+					|| memcmp(da->zPath.data(), db->zPath.data(), da->zPath.size() * sizeof(int16_t)) != 0) {
+				error = toString("command ", idx, ": z-path mismatch");
+				return false;
+			}
+		}
+
+		a = a->next;
+		b = b->next;
+		++ idx;
+	}
+
+	if (a || b) {
+		error = toString("command count mismatch after ", idx, " commands");
+		return false;
+	}
+
+	if (compareDamage && (l.isFullDamage() != r.isFullDamage()
+			|| (!l.isFullDamage() && l.getDamage() != r.getDamage()))) {
+		error = "damage mismatch";
+		return false;
+	}
+
+	return true;
+}
+
+}
@@ -0,0 +1,69 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#ifndef TEST_XENOLITH_SRC_TESTS_XLTESTSCENE_H_
+#define TEST_XENOLITH_SRC_TESTS_XLTESTSCENE_H_
+
+#include "XLScene.h"
+#include "XLDirector.h"
+#include "XLGlCommandList.h"
+
+namespace stappler::xenolith::app {
+
+// scene without compiled queue and view, it can be rendered into command list directly
+class TestScene : public Scene {
+public:
+	virtual ~TestScene() { }
+
+	virtual bool init(Size);
+
+	// enter scene without view and resource cache
+	void present(Director *);
+	void finish();
+
+	// render single frame on calling thread, with root transform that maps scene into viewRect
+	Rc<gl::CommandList> renderFrame(thread::TaskQueue *queue, const Rect &viewRect);
+
+	// render single frame as Director does: capture on calling thread, then visit on queue's worker
+	Rc<gl::CommandList> renderFrameOnWorker(thread::TaskQueue *queue, const Rect &viewRect);
+};
+
+// node, that draws shared vertex data with its own transform
+class TestQuadNode : public Node {
+public:
+	virtual ~TestQuadNode() { }
+
+	virtual bool init(const Rc<gl::VertexData> &, gl::MaterialId);
+
+	virtual void draw(RenderFrameInfo &, NodeFlags flags) override;
+
+protected:
+	Rc<gl::VertexData> _data;
+	gl::MaterialId _material = 0;
+};
+
+// compare command lists by type, data, transform, material and z-path, and damage, if requested
+bool compareCommandLists(const gl::CommandList &, const gl::CommandList &, String &error, bool compareDamage = true);
+
+}
+
+#endif /* TEST_XENOLITH_SRC_TESTS_XLTESTSCENE_H_ */
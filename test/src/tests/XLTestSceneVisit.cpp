@@ -0,0 +1,183 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLTestSuite.h"
+#include "XLTestScene.h"
+#include "XLApplication.h"
+#include "XLComponent.h"
+
+namespace stappler::xenolith::app {
+
+static constexpr uint32_t TestSceneVisit_Groups = 16;
+static constexpr uint32_t TestSceneVisit_GroupNodes = 320;
+
+// component, that draws with owner's transform, to test its order relative to children
+class TestSceneVisitComponent : public Component {
+public:
+	virtual ~TestSceneVisitComponent() { }
+
+	virtual bool init(const Rc<gl::VertexData> &data) {
+		if (!Component::init()) {
+			return false;
+		}
+		_data = data;
+		return true;
+	}
+
+	virtual void visit(RenderFrameInfo &info, NodeFlags parentFlags) override {
+		info.commands->pushVertexArray(_data, info.transformStack.back(), info.zPath, gl::MaterialId(5));
+	}
+
+protected:
+	Rc<gl::VertexData> _data;
+};
+
+// same tree for both scenes: groups with mixed z-order, some groups are out of view or bounded
+static void TestSceneVisit_fill(TestScene *scene, const Vector<Rc<gl::VertexData>> &data, Vector<Node *> &moving) {
+	scene->addComponent(Rc<TestSceneVisitComponent>::create(data.front()));
+
+	for (uint32_t i = 0; i < TestSceneVisit_Groups; ++ i) {
+		auto group = scene->addChild(Rc<Node>::create(), int32_t(i % 3) - 1);
+		group->setContentSize(Size(256.0f, 256.0f));
+		group->setPosition(Vec2(float(i % 4) * 256.0f, float(i / 4) * 192.0f));
+		group->setChildrenWithinBounds(i % 2 == 0);
+
+		for (uint32_t j = 0; j < TestSceneVisit_GroupNodes; ++ j) {
+			auto node = group->addChild(Rc<TestQuadNode>::create(data[(i + j) % data.size()], gl::MaterialId(1 + j % 4)),
+					int32_t(j % 5) - 2);
+			node->setContentSize(Size(8.0f, 8.0f));
+			node->setPosition(Vec2(float(j % 32) * 8.0f, float(j / 32) * 24.0f));
+			if (j % 64 == 0) {
+				moving.emplace_back(node);
+			}
+		}
+	}
+}
+
+// serial and parallel visits of identical scenes should produce identical command lists and damage
+static TestSuite s_sceneVisitTest("nodes.SceneVisit.parallel", [] (TestSuite &test) -> bool {
+	auto app = Application::getInstance();
+
+	auto queue = Rc<thread::TaskQueue>::alloc(4, nullptr, "TestSceneVisit");
+	if (!test.expect(queue->spawnWorkers(), "spawn workers")) {
+		return false;
+	}
+
+	Vector<Rc<gl::VertexData>> data;
+	for (uint32_t i = 0; i < 8; ++ i) {
+		data.emplace_back(Rc<gl::VertexData>::alloc());
+	}
+
+	Vector<Node *> serialMoving;
+	Vector<Node *> parallelMoving;
+
+	auto serial = Rc<TestScene>::create(Size(1024.0f, 768.0f));
+	auto parallel = Rc<TestScene>::create(Size(1024.0f, 768.0f));
+	parallel->setParallelVisit(true);
+
+	TestSceneVisit_fill(serial, data, serialMoving);
+	TestSceneVisit_fill(parallel, data, parallelMoving);
+
+	auto serialDirector = Rc<Director>::create(app, nullptr);
+	auto parallelDirector = Rc<Director>::create(app, nullptr);
+	serial->present(serialDirector);
+	parallel->present(parallelDirector);
+
+	// left half of scene, so culling is involved
+	auto viewRect = Rect(0.0f, 0.0f, 512.0f, 768.0f);
+
+	bool success = true;
+	for (uint32_t frame = 0; frame < 4 && success; ++ frame) {
+		auto a = serial->renderFrame(nullptr, viewRect);
+		auto b = parallel->renderFrame(queue, viewRect);
+
+		String error;
+		success = test.expect(compareCommandLists(*a, *b, error), toString("frame ", frame, ": ", error));
+
+		// move some nodes between frames, so damage and culled flags are tested too
+		for (size_t i = 0; i < serialMoving.size(); ++ i) {
+			auto offset = Vec3(float(frame + 1) * 37.0f, 0.0f, 0.0f);
+			serialMoving[i]->setPosition(serialMoving[i]->getPosition() + offset);
+			parallelMoving[i]->setPosition(parallelMoving[i]->getPosition() + offset);
+		}
+	}
+
+	test.expect(serial->getCulledNodes() == parallel->getCulledNodes(), "culled nodes count");
+
+	serial->finish();
+	parallel->finish();
+	queue->cancelWorkers();
+	return success;
+});
+
+// visit on worker after capture on calling thread, as director does, should produce same output as serial render
+static TestSuite s_sceneVisitWorkerTest("nodes.SceneVisit.worker", [] (TestSuite &test) -> bool {
+	auto app = Application::getInstance();
+
+	auto queue = Rc<thread::TaskQueue>::alloc(2, nullptr, "TestSceneVisitWorker");
+	if (!test.expect(queue->spawnWorkers(), "spawn workers")) {
+		return false;
+	}
+
+	Vector<Rc<gl::VertexData>> data;
+	for (uint32_t i = 0; i < 8; ++ i) {
+		data.emplace_back(Rc<gl::VertexData>::alloc());
+	}
+
+	Vector<Node *> serialMoving;
+	Vector<Node *> workerMoving;
+
+	auto serial = Rc<TestScene>::create(Size(1024.0f, 768.0f));
+	auto worker = Rc<TestScene>::create(Size(1024.0f, 768.0f));
+
+	TestSceneVisit_fill(serial, data, serialMoving);
+	TestSceneVisit_fill(worker, data, workerMoving);
+
+	auto serialDirector = Rc<Director>::create(app, nullptr);
+	auto workerDirector = Rc<Director>::create(app, nullptr);
+	serial->present(serialDirector);
+	worker->present(workerDirector);
+
+	auto viewRect = Rect(0.0f, 0.0f, 512.0f, 768.0f);
+
+	bool success = true;
+	for (uint32_t frame = 0; frame < 4 && success; ++ frame) {
+		auto a = serial->renderFrame(nullptr, viewRect);
+		auto b = worker->renderFrameOnWorker(queue, viewRect);
+
+		String error;
+		success = test.expect(compareCommandLists(*a, *b, error), toString("frame ", frame, ": ", error));
+
+		for (size_t i = 0; i < serialMoving.size(); ++ i) {
+			auto offset = Vec3(0.0f, float(frame + 1) * 29.0f, 0.0f);
+			serialMoving[i]->setPosition(serialMoving[i]->getPosition() + offset);
+			workerMoving[i]->setPosition(workerMoving[i]->getPosition() + offset);
+		}
+	}
+
+	serial->finish();
+	worker->finish();
+	queue->cancelWorkers();
+	return success;
+});
+
+}
@@ -0,0 +1,63 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+
+#include "XLTestSuite.h"
+#include "XLScheduler.h"
+
+namespace stappler::xenolith::app {
+
+// scheduled callbacks should not mark scene dirty by themselves, only actual changes do, so, scene can become idle
+static TestSuite s_schedulerIdleTest("core.Scheduler.idle", [] (TestSuite &test) -> bool {
+	auto scheduler = Rc<Scheduler>::create();
+
+	uint32_t calls = 0;
+	bool change = false;
+	int target = 0;
+	scheduler->schedulePerFrame([&] (const UpdateTime &) {
+		++ calls;
+		if (change) {
+			markSceneDirty();
+		}
+	}, &target, 0, false);
+
+	UpdateTime time;
+	time.global = 0;
+	time.app = 0;
+	time.delta = 0;
+
+	auto epoch = getSceneEpoch();
+	scheduler->update(time);
+	scheduler->update(time);
+
+	bool success = test.expect(calls == 2, "callback is called on each update");
+	success = test.expect(getSceneEpoch() == epoch, "callback without changes keeps scene epoch") && success;
+
+	change = true;
+	scheduler->update(time);
+	success = test.expect(getSceneEpoch() != epoch, "change from callback updates scene epoch") && success;
+
+	scheduler->unschedule(&target);
+	return success;
+});
+
+}
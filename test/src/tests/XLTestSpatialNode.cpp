@@ -0,0 +1,299 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLTestSuite.h"
+#include "XLTestScene.h"
+#include "XLSpatialNode.h"
+#include "XLApplication.h"
+
+namespace stappler::xenolith::app {
+
+// child, moved out of view, is not visited by SpatialNode, but area, drawn with previous frame, should be redrawn
+static TestSuite s_spatialDamageTest("nodes.SpatialNode.damage", [] (TestSuite &test) -> bool {
+	auto app = Application::getInstance();
+	auto data = Rc<gl::VertexData>::alloc();
+
+	auto scene = Rc<TestScene>::create(Size(1024.0f, 768.0f));
+	auto spatial = scene->addChild(Rc<SpatialNode>::create());
+	spatial->setContentSize(Size(4096.0f, 4096.0f));
+
+	auto node = spatial->addChild(Rc<TestQuadNode>::create(data, gl::MaterialId(1)));
+	node->setContentSize(Size(32.0f, 32.0f));
+	node->setPosition(Vec2(100.0f, 100.0f));
+
+	auto dir = Rc<Director>::create(app, nullptr);
+	scene->present(dir);
+
+	auto viewRect = Rect(0.0f, 0.0f, 1024.0f, 768.0f);
+
+	scene->renderFrame(nullptr, viewRect);
+	auto unchanged = scene->renderFrame(nullptr, viewRect);
+	test.expect(!unchanged->isFullDamage() && unchanged->getDamage().size.width == 0.0f, "no damage without changes");
+
+	node->setPosition(Vec2(3000.0f, 3000.0f));
+	auto moved = scene->renderFrame(nullptr, viewRect);
+	test.expect(spatial->getVisitedChildrenCount() == 0, "moved child is culled");
+	test.expect(moved->getFirst() == nullptr, "moved child is not drawn");
+	test.expect(!moved->isFullDamage() && moved->getDamage().size.width > 0.0f, "previous area of moved child is damaged");
+
+	auto next = scene->renderFrame(nullptr, viewRect);
+	test.expect(next->getDamage().size.width == 0.0f, "damage is not repeated");
+
+	scene->finish();
+	return true;
+});
+
+static void TestSpatialNode_fill(SpatialNode *spatial, const Vector<Rc<gl::VertexData>> &data, Vector<Node *> &nodes) {
+	spatial->setContentSize(Size(1024.0f, 768.0f));
+	for (uint32_t i = 0; i < 256; ++ i) {
+		auto node = spatial->addChild(Rc<TestQuadNode>::create(data[i % data.size()], gl::MaterialId(1 + i % 4)), int32_t(i % 3) - 1);
+		node->setContentSize(Size(16.0f, 16.0f));
+		node->setPosition(Vec2(float(i % 16) * 64.0f, float(i / 16) * 48.0f));
+		nodes.emplace_back(node);
+	}
+}
+
+// retained SpatialNode should replay the same commands, as SpatialNode, visited on every frame
+static TestSuite s_spatialRetainedTest("nodes.SpatialNode.retained", [] (TestSuite &test) -> bool {
+	auto app = Application::getInstance();
+
+	Vector<Rc<gl::VertexData>> data;
+	for (uint32_t i = 0; i < 4; ++ i) {
+		data.emplace_back(Rc<gl::VertexData>::alloc());
+	}
+
+	Vector<Node *> visitedNodes;
+	Vector<Node *> retainedNodes;
+
+	auto visitedScene = Rc<TestScene>::create(Size(1024.0f, 768.0f));
+	auto retainedScene = Rc<TestScene>::create(Size(1024.0f, 768.0f));
+
+	TestSpatialNode_fill(visitedScene->addChild(Rc<SpatialNode>::create()), data, visitedNodes);
+
+	auto retained = retainedScene->addChild(Rc<SpatialNode>::create());
+	retained->setRetainedSubtree(true);
+	TestSpatialNode_fill(retained, data, retainedNodes);
+
+	auto visitedDirector = Rc<Director>::create(app, nullptr);
+	auto retainedDirector = Rc<Director>::create(app, nullptr);
+	visitedScene->present(visitedDirector);
+	retainedScene->present(retainedDirector);
+
+	// whole content is within view, so, both nodes draw all children
+	auto viewRect = Rect(0.0f, 0.0f, 1024.0f, 768.0f);
+
+	for (uint32_t frame = 0; frame < 6; ++ frame) {
+		auto a = visitedScene->renderFrame(nullptr, viewRect);
+		auto b = retainedScene->renderFrame(nullptr, viewRect);
+
+		String error;
+		if (!test.expect(compareCommandLists(*a, *b, error, false), toString("frame ", frame, ": ", error))) {
+			break;
+		}
+
+		if (frame % 2 == 1) {
+			// subtree was not changed since it was recorded
+			test.expect(retainedScene->getRetainedCommands() == retainedNodes.size(), toString("frame ", frame, ": commands are replayed"));
+
+			// move child within view, subtree should be recorded again
+			auto offset = Vec2(float(frame) * 4.0f, 0.0f);
+			visitedNodes[frame]->setPosition(visitedNodes[frame]->getPosition() + offset);
+			retainedNodes[frame]->setPosition(retainedNodes[frame]->getPosition() + offset);
+		}
+	}
+
+	visitedScene->finish();
+	retainedScene->finish();
+	return true;
+});
+
+struct TestSpatialNode_Random {
+	uint64_t seed;
+
+	float next(float min, float max) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		return min + (max - min) * float(seed >> 40) / float(1 << 24);
+	}
+};
+
+static bool TestSpatialNode_intersects(const Rect &bounds, const Rect &rect) {
+	return bounds.origin.x <= rect.origin.x + rect.size.width
+		&& bounds.origin.x + bounds.size.width >= rect.origin.x
+		&& bounds.origin.y <= rect.origin.y + rect.size.height
+		&& bounds.origin.y + bounds.size.height >= rect.origin.y;
+}
+
+// queries and hit-tests should match brute force over all children, after incremental updates and rebuilds
+static TestSuite s_spatialBruteForceTest("nodes.SpatialNode.query", [] (TestSuite &test) -> bool {
+	TestSpatialNode_Random rnd{42};
+
+	auto spatial = Rc<SpatialNode>::create();
+	spatial->setContentSize(Size(2048.0f, 2048.0f));
+
+	Vector<Node *> nodes;
+	for (uint32_t i = 0; i < 2000; ++ i) {
+		auto node = spatial->addChild(Rc<Node>::create(), int32_t(rnd.next(-2.0f, 2.0f)));
+		auto size = (i % 10 == 0) ? rnd.next(200.0f, 1200.0f) : rnd.next(1.0f, 40.0f);
+		node->setContentSize(Size(size, rnd.next(1.0f, 40.0f)));
+		// some children are placed outside of content rect
+		node->setPosition(Vec2(rnd.next(-256.0f, 2304.0f), rnd.next(-256.0f, 2304.0f)));
+		if (i % 7 == 0) {
+			node->setRotation(rnd.next(0.0f, float(M_PI)));
+		}
+		if (i % 13 == 0) {
+			node->setVisible(false);
+		}
+		nodes.emplace_back(node);
+	}
+
+	auto check = [&] (StringView stage) {
+		for (uint32_t q = 0; q < 200; ++ q) {
+			Rect rect(rnd.next(-512.0f, 2048.0f), rnd.next(-512.0f, 2048.0f), rnd.next(0.0f, 1024.0f), rnd.next(0.0f, 1024.0f));
+
+			Set<Node *> found;
+			spatial->queryChildren(rect, [&] (Node *node) {
+				found.emplace(node);
+			});
+
+			Set<Node *> expected;
+			for (auto &it : nodes) {
+				if (it->isVisible() && TestSpatialNode_intersects(it->getBoundingBox(), rect)) {
+					expected.emplace(it);
+				}
+			}
+
+			if (!test.expect(found == expected, toString(stage, ": query ", q, ": ", found.size(), " found, ", expected.size(), " expected"))) {
+				return false;
+			}
+
+			Vec2 point(rnd.next(0.0f, 2048.0f), rnd.next(0.0f, 2048.0f));
+			Node *top = nullptr;
+			for (auto &it : nodes) {
+				if (!it->isVisible()) {
+					continue;
+				}
+
+				Vec3 local;
+				it->getParentToNodeTransform().transformPoint(Vec3(point.x, point.y, 0.0f), &local);
+				auto &size = it->getContentSize();
+				if (local.x < 0.0f || local.y < 0.0f || local.x > size.width || local.y > size.height) {
+					continue;
+				}
+
+				// later children are drawn above children with same z-order
+				if (!top || top->getLocalZOrder() <= it->getLocalZOrder()) {
+					top = it;
+				}
+			}
+
+			if (!test.expect(spatial->getChildAt(point) == top, toString(stage, ": hit-test ", q))) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	if (!check("initial")) {
+		return false;
+	}
+
+	// incremental updates
+	for (uint32_t i = 0; i < nodes.size(); i += 3) {
+		nodes[i]->setPosition(Vec2(rnd.next(-256.0f, 2304.0f), rnd.next(-256.0f, 2304.0f)));
+		if (i % 2 == 0) {
+			nodes[i]->setContentSize(Size(rnd.next(1.0f, 300.0f), rnd.next(1.0f, 300.0f)));
+		}
+	}
+
+	for (uint32_t i = 1; i < nodes.size(); i += 17) {
+		spatial->removeChild(nodes[i]);
+		nodes[i] = nullptr;
+	}
+	nodes.erase(std::remove(nodes.begin(), nodes.end(), nullptr), nodes.end());
+
+	if (!check("updated")) {
+		return false;
+	}
+
+	// cell sizes are changed, index is rebuilt
+	spatial->setContentSize(Size(1000.0f, 3000.0f));
+
+	return check("rebuilt");
+});
+
+static TestSuite s_spatialBenchmark("nodes.SpatialNode.bench", [] (TestSuite &test) -> bool {
+	static constexpr uint32_t Count = 1'000'000;
+
+	auto app = Application::getInstance();
+	auto data = Rc<gl::VertexData>::alloc();
+
+	TestSpatialNode_Random rnd{7};
+
+	auto scene = Rc<TestScene>::create(Size(1024.0f, 768.0f));
+	auto spatial = scene->addChild(Rc<SpatialNode>::create());
+	spatial->setContentSize(Size(65536.0f, 65536.0f));
+
+	for (uint32_t i = 0; i < Count; ++ i) {
+		auto node = spatial->addChild(Rc<TestQuadNode>::create(data, gl::MaterialId(1)));
+		node->setContentSize(Size(rnd.next(4.0f, 32.0f), rnd.next(4.0f, 32.0f)));
+		node->setPosition(Vec2(rnd.next(0.0f, 65536.0f), rnd.next(0.0f, 65536.0f)));
+	}
+
+	auto dir = Rc<Director>::create(app, nullptr);
+	scene->present(dir);
+
+	auto viewRect = Rect(0.0f, 0.0f, 1024.0f, 768.0f);
+
+	test.benchmark("index build, 1M children", 1, [&] {
+		spatial->queryChildren(Rect(0.0f, 0.0f, 1.0f, 1.0f), [] (Node *) { });
+	});
+
+	size_t visible = 0;
+	test.benchmark("query, 1024x768 rect", 1000, [&] {
+		visible = 0;
+		spatial->queryChildren(Rect(rnd.next(0.0f, 64000.0f), rnd.next(0.0f, 64000.0f), 1024.0f, 768.0f), [&] (Node *) {
+			++ visible;
+		});
+	});
+
+	test.benchmark("brute force, 1024x768 rect", 10, [&] {
+		Rect rect(rnd.next(0.0f, 64000.0f), rnd.next(0.0f, 64000.0f), 1024.0f, 768.0f);
+		visible = 0;
+		for (auto &it : spatial->getChildren()) {
+			if (TestSpatialNode_intersects(it->getBoundingBox(), rect)) {
+				++ visible;
+			}
+		}
+	});
+
+	scene->renderFrame(nullptr, viewRect);
+	test.benchmark("frame, 1M children", 100, [&] {
+		scene->renderFrame(nullptr, viewRect);
+	});
+
+	test.expect(spatial->getVisitedChildrenCount() < Count / 100, "only children within view are visited");
+
+	scene->finish();
+	return true;
+});
+
+}
@@ -0,0 +1,84 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLTestSuite.h"
+
+namespace stappler::xenolith::app {
+
+static Vector<TestSuite *> &TestSuite_getAll() {
+	static Vector<TestSuite *> s_tests;
+	return s_tests;
+}
+
+bool TestSuite::run(StringView filter) {
+	auto &tests = TestSuite_getAll();
+	std::sort(tests.begin(), tests.end(), [] (const TestSuite *l, const TestSuite *r) {
+		return l->getName() < r->getName();
+	});
+
+	uint32_t total = 0;
+	uint32_t failed = 0;
+	for (auto &it : tests) {
+		if (filter != "all" && !it->getName().starts_with(filter)) {
+			continue;
+		}
+
+		++ total;
+		it->_failed = 0;
+		auto success = it->_callback(*it) && it->_failed == 0;
+		if (!success) {
+			++ failed;
+		}
+		log::vtext("Test", "[", success ? "ok" : "FAIL", "] ", it->getName());
+	}
+
+	if (total == 0) {
+		log::vtext("Test", "No tests matched: ", filter);
+		return false;
+	}
+
+	log::vtext("Test", total - failed, "/", total, " passed");
+	return failed == 0;
+}
+
+TestSuite::TestSuite(StringView name, Callback cb) : _name(name), _callback(cb) {
+	TestSuite_getAll().emplace_back(this);
+}
+
+bool TestSuite::expect(bool value, StringView what) {
+	if (!value) {
+		++ _failed;
+		log::vtext("Test", _name, ": failed: ", what);
+	}
+	return value;
+}
+
+uint64_t TestSuite::now() const {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TestSuite::logBenchmark(StringView what, uint32_t count, uint64_t time) {
+	log::vtext("Test", _name, ": ", what, ": ", count ? double(time) / count : 0.0, " us (", count, " iterations)");
+}
+
+}
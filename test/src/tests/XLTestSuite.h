@@ -0,0 +1,71 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#ifndef TEST_XENOLITH_SRC_TESTS_XLTESTSUITE_H_
+#define TEST_XENOLITH_SRC_TESTS_XLTESTSUITE_H_
+
+#include "XLDefine.h"
+
+namespace stappler::xenolith::app {
+
+// CPU-side tests and benchmarks, runs with "test=<name prefix>" option, "test=all" runs everything
+// tests are registered with static TestSuite objects
+class TestSuite {
+public:
+	using Callback = bool (*) (TestSuite &);
+
+	static bool run(StringView filter);
+
+	TestSuite(StringView name, Callback);
+
+	StringView getName() const { return _name; }
+
+	// logs failure and returns value, so check can be used as "if (!expect(...)) return false;"
+	bool expect(bool value, StringView what);
+
+	// runs callback count times, logs time per iteration in microseconds and returns it
+	template <typename Callback>
+	double benchmark(StringView what, uint32_t count, const Callback &);
+
+protected:
+	uint64_t now() const;
+	void logBenchmark(StringView what, uint32_t count, uint64_t time);
+
+	StringView _name;
+	Callback _callback = nullptr;
+	uint32_t _failed = 0;
+};
+
+template <typename Callback>
+inline double TestSuite::benchmark(StringView what, uint32_t count, const Callback &cb) {
+	auto t = now();
+	for (uint32_t i = 0; i < count; ++ i) {
+		cb();
+	}
+	t = now() - t;
+	logBenchmark(what, count, t);
+	return count ? double(t) / count : 0.0;
+}
+
+}
+
+#endif /* TEST_XENOLITH_SRC_TESTS_XLTESTSUITE_H_ */
@@ -0,0 +1,193 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLTestSuite.h"
+#include "XLTestScene.h"
+#include "XLApplication.h"
+
+namespace stappler::xenolith::app {
+
+struct TestTransformStore_Tree {
+	uint64_t seed = 1;
+	Vector<Node *> nodes;
+	Map<const gl::VertexData *, Node *> nodesByData;
+
+	float next(float min, float max) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		return min + (max - min) * float(seed >> 40) / float(1 << 24);
+	}
+
+	void randomize(Node *node) {
+		node->setPosition(Vec2(next(-200.0f, 200.0f), next(-200.0f, 200.0f)));
+		node->setContentSize(Size(next(1.0f, 100.0f), next(1.0f, 100.0f)));
+		node->setAnchorPoint(Vec2(next(0.0f, 1.0f), next(0.0f, 1.0f)));
+		node->setScale(Vec2(next(0.5f, 1.5f), next(0.5f, 1.5f)));
+		node->setRotation(next(-3.0f, 3.0f));
+	}
+
+	Node *add(Node *parent) {
+		auto data = Rc<gl::VertexData>::alloc();
+		auto node = parent->addChild(Rc<TestQuadNode>::create(data, gl::MaterialId(1)));
+		randomize(node);
+		nodes.emplace_back(node);
+		nodesByData.emplace(data.get(), node);
+		return node;
+	}
+
+	void fill(Node *parent, uint32_t depth, uint32_t width) {
+		for (uint32_t i = 0; i < width; ++ i) {
+			auto node = add(parent);
+			if (depth > 0) {
+				fill(node, depth - 1, width);
+			}
+		}
+	}
+};
+
+// transforms, drawn with world transforms from store, should match recursive node-to-world transform
+static bool TestTransformStore_check(TestSuite &test, TestTransformStore_Tree &tree, const gl::CommandList &list, StringView stage) {
+	size_t count = 0;
+	auto cmd = list.getFirst();
+	while (cmd) {
+		if (cmd->type == gl::CommandType::VertexArray) {
+			auto data = (const gl::CmdVertexArray *)cmd->data;
+			auto it = tree.nodesByData.find(data->vertexes.get());
+			if (it != tree.nodesByData.end()) {
+				auto expected = it->second->getNodeToWorldTransform();
+				for (size_t i = 0; i < 16; ++ i) {
+					if (std::abs(expected.m[i] - data->transform.m[i]) > 1e-3f * (1.0f + std::abs(expected.m[i]))) {
+						return test.expect(false, toString(stage, ": transform mismatch for node ", count));
+					}
+				}
+				++ count;
+			}
+		}
+		cmd = cmd->next;
+	}
+
+	return test.expect(count == tree.nodes.size(), toString(stage, ": ", count, " of ", tree.nodes.size(), " nodes are drawn"));
+}
+
+static TestSuite s_transformStoreTest("nodes.TransformStore", [] (TestSuite &test) -> bool {
+	auto app = Application::getInstance();
+
+	TestTransformStore_Tree tree;
+	auto scene = Rc<TestScene>::create(Size(1024.0f, 768.0f));
+	tree.fill(scene, 4, 4);
+
+	auto dir = Rc<Director>::create(app, nullptr);
+	scene->present(dir);
+
+	// no culling, every node should be drawn
+	auto viewRect = Rect(-1.0e6f, -1.0e6f, 2.0e6f, 2.0e6f);
+
+	if (!TestTransformStore_check(test, tree, *scene->renderFrame(nullptr, viewRect), "initial")) {
+		return false;
+	}
+
+	// no changes, nothing is recomputed; layout, deferred to first visit, is applied with next frame
+	scene->renderFrame(nullptr, viewRect);
+	scene->renderFrame(nullptr, viewRect);
+	test.expect(scene->getTransformStore()->getUpdatedCount() == 0, "clean store is not updated");
+
+	for (uint32_t frame = 0; frame < 4; ++ frame) {
+		// change inner nodes and leafs
+		for (size_t i = frame; i < tree.nodes.size(); i += 7) {
+			tree.randomize(tree.nodes[i]);
+		}
+
+		// new nodes are added after existing ones, moved subtrees should keep topological order
+		for (size_t i = frame; i < tree.nodes.size(); i += 53) {
+			tree.add(tree.nodes[i]);
+		}
+
+		auto moved = tree.nodes[frame * 3 + 1];
+		Rc<Node> ref(moved);
+		auto target = tree.nodes[tree.nodes.size() - 1 - frame];
+		if (target != moved && moved->getParent()) {
+			bool isDescendant = false;
+			for (auto p = target; p; p = p->getParent()) {
+				if (p == moved) {
+					isDescendant = true;
+					break;
+				}
+			}
+			if (!isDescendant) {
+				moved->getParent()->removeChild(moved, false);
+				target->addChild(moved);
+			}
+		}
+
+		if (!TestTransformStore_check(test, tree, *scene->renderFrame(nullptr, viewRect), toString("frame ", frame))) {
+			break;
+		}
+	}
+
+	// scene transform is the root of all world transforms
+	scene->setScale(0.5f);
+	TestTransformStore_check(test, tree, *scene->renderFrame(nullptr, viewRect), "scene scale");
+
+	scene->finish();
+	return true;
+});
+
+static TestSuite s_transformStoreBenchmark("nodes.TransformStore.bench", [] (TestSuite &test) -> bool {
+	auto app = Application::getInstance();
+
+	TestTransformStore_Tree tree;
+	auto scene = Rc<TestScene>::create(Size(1024.0f, 768.0f));
+
+	// 8 + 64 + 512 + 4096 + 32768 nodes
+	tree.fill(scene, 4, 8);
+
+	auto dir = Rc<Director>::create(app, nullptr);
+	scene->present(dir);
+
+	auto viewRect = Rect(-1.0e6f, -1.0e6f, 2.0e6f, 2.0e6f);
+	scene->renderFrame(nullptr, viewRect);
+
+	auto &store = scene->getTransformStore();
+
+	test.benchmark(toString("store update, ", tree.nodes.size(), " nodes, 1% changed"), 100, [&] {
+		for (size_t i = 0; i < tree.nodes.size(); i += 100) {
+			tree.nodes[i]->setRotation(tree.next(-3.0f, 3.0f));
+		}
+		store->update(Mat4::IDENTITY);
+	});
+
+	test.benchmark(toString("recursive transforms, ", tree.nodes.size(), " nodes"), 10, [&] {
+		float sum = 0.0f;
+		for (auto &it : tree.nodes) {
+			sum += it->getNodeToWorldTransform().m[12];
+		}
+		test.expect(!std::isnan(sum), "valid transforms");
+	});
+
+	test.benchmark(toString("frame, ", tree.nodes.size(), " nodes"), 20, [&] {
+		scene->renderFrame(nullptr, viewRect);
+	});
+
+	scene->finish();
+	return true;
+});
+
+}
@@ -0,0 +1,191 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLTestSuite.h"
+#include "XLVkVertexCache.h"
+
+namespace stappler::xenolith::app {
+
+// reference model: map of used vertexes
+struct TestVertexCache_Model {
+	Vector<bool> used;
+	Set<uint32_t> slots;
+
+	// free runs as (offset, size)
+	Vector<Pair<uint32_t, uint32_t>> getFreeRuns() const {
+		Vector<Pair<uint32_t, uint32_t>> ret;
+		uint32_t i = 0;
+		while (i < used.size()) {
+			if (used[i]) {
+				++ i;
+				continue;
+			}
+			auto start = i;
+			while (i < used.size() && !used[i]) {
+				++ i;
+			}
+			ret.emplace_back(start, i - start);
+		}
+		return ret;
+	}
+};
+
+static void TestVertexCache_check(TestSuite &test, const vk::VertexRegionAllocator &alloc, const TestVertexCache_Model &model, StringView what) {
+	auto runs = model.getFreeRuns();
+	uint32_t freeSize = 0;
+	for (auto &it : runs) {
+		freeSize += it.second;
+	}
+
+	test.expect(alloc.getFreeSize() == freeSize, toString(what, ": free size ", alloc.getFreeSize(), ", expected ", freeSize));
+
+	// adjacent free blocks should be merged into single run
+	test.expect(alloc.getFreeBlocksCount() == runs.size(),
+			toString(what, ": free blocks ", alloc.getFreeBlocksCount(), ", expected ", runs.size()));
+}
+
+static bool TestVertexCache_allocate(TestSuite &test, vk::VertexRegionAllocator &alloc, TestVertexCache_Model &model,
+		uint32_t size, Vector<vk::VertexRegionAllocator::Block> &blocks) {
+	// first fit: lowest free run, that can hold size
+	Pair<uint32_t, uint32_t> expected(maxOf<uint32_t>(), 0);
+	for (auto &it : model.getFreeRuns()) {
+		if (it.second >= size) {
+			expected = it;
+			break;
+		}
+	}
+
+	vk::VertexRegionAllocator::Block block;
+	if (!alloc.allocate(size, block)) {
+		return test.expect(size > 0 && expected.first == maxOf<uint32_t>(), toString("allocation of ", size, " failed with free run at ", expected.first));
+	}
+
+	// empty data takes only object slot
+	if (!test.expect(size == 0 || (block.offset == expected.first && block.size == size),
+			toString("allocation of ", size, " at ", block.offset, ", expected ", expected.first))) {
+		return false;
+	}
+
+	if (!test.expect(model.slots.emplace(block.slot).second, toString("slot ", block.slot, " is already in use"))) {
+		return false;
+	}
+
+	for (uint32_t i = block.offset; i < block.offset + block.size; ++ i) {
+		model.used[i] = true;
+	}
+
+	blocks.emplace_back(block);
+	return true;
+}
+
+static void TestVertexCache_free(vk::VertexRegionAllocator &alloc, TestVertexCache_Model &model,
+		Vector<vk::VertexRegionAllocator::Block> &blocks, size_t idx) {
+	auto block = blocks[idx];
+	blocks.erase(blocks.begin() + idx);
+
+	for (uint32_t i = block.offset; i < block.offset + block.size; ++ i) {
+		model.used[i] = false;
+	}
+	model.slots.erase(block.slot);
+	alloc.free(block);
+}
+
+static TestSuite s_vertexCacheTest("vk.VertexCache", [] (TestSuite &test) -> bool {
+	static constexpr uint32_t Capacity = 4096;
+
+	vk::VertexRegionAllocator alloc;
+	TestVertexCache_Model model;
+	Vector<vk::VertexRegionAllocator::Block> blocks;
+
+	alloc.reset(Capacity);
+	model.used.resize(Capacity, false);
+
+	test.expect(alloc.getFreeSize() == Capacity && alloc.getFreeBlocksCount() == 1, "empty allocator");
+
+	// sequential allocation fills buffer from start
+	for (uint32_t i = 0; i < 16; ++ i) {
+		TestVertexCache_allocate(test, alloc, model, 4, blocks);
+	}
+	TestVertexCache_check(test, alloc, model, "sequential");
+	test.expect(alloc.getSlots() == 16, "one slot per region");
+
+	// holes are reused with first fit, neighbours are merged on free
+	TestVertexCache_free(alloc, model, blocks, 3); // vertexes 12-15
+	TestVertexCache_free(alloc, model, blocks, 4); // vertexes 20-23
+	TestVertexCache_check(test, alloc, model, "holes");
+	TestVertexCache_free(alloc, model, blocks, 3); // vertexes 16-19
+	TestVertexCache_check(test, alloc, model, "merge with previous and next");
+	TestVertexCache_allocate(test, alloc, model, 8, blocks);
+	TestVertexCache_check(test, alloc, model, "reuse hole");
+	test.expect(alloc.getSlots() == 16, "released slots are reused");
+
+	// does not fit
+	vk::VertexRegionAllocator::Block block;
+	test.expect(!alloc.allocate(Capacity, block), "oversized allocation fails");
+
+	// empty data does not consume free blocks
+	TestVertexCache_allocate(test, alloc, model, 0, blocks);
+	TestVertexCache_check(test, alloc, model, "empty data");
+	TestVertexCache_free(alloc, model, blocks, blocks.size() - 1);
+	TestVertexCache_check(test, alloc, model, "empty data released");
+
+	// random workload against reference model
+	uint64_t seed = 1;
+	auto next = [&] {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		return uint32_t(seed >> 33);
+	};
+
+	for (uint32_t i = 0; i < 20'000; ++ i) {
+		if (blocks.empty() || next() % 3 != 0) {
+			// quads and small meshes, sometimes empty data
+			uint32_t size = (next() % 16 == 0) ? 0 : 4 * (1 + next() % 24);
+			if (!TestVertexCache_allocate(test, alloc, model, size, blocks)) {
+				break;
+			}
+		} else {
+			TestVertexCache_free(alloc, model, blocks, next() % blocks.size());
+		}
+
+		if (i % 97 == 0) {
+			TestVertexCache_check(test, alloc, model, toString("random step ", i));
+		}
+	}
+
+	test.expect(alloc.getSlots() <= blocks.size() + (20'000 / 3), "slots are reused");
+
+	// after everything is released, buffer is a single free block again
+	while (!blocks.empty()) {
+		TestVertexCache_free(alloc, model, blocks, next() % blocks.size());
+	}
+	TestVertexCache_check(test, alloc, model, "release all");
+	test.expect(alloc.getFreeBlocksCount() == 1 && alloc.getFreeSize() == Capacity, "released buffer is a single block");
+
+	// reset on growth drops all blocks and slots
+	TestVertexCache_allocate(test, alloc, model, 4, blocks);
+	alloc.reset(Capacity * 2);
+	test.expect(alloc.getCapacity() == Capacity * 2 && alloc.getFreeSize() == Capacity * 2 && alloc.getSlots() == 0, "reset");
+
+	return true;
+});
+
+}
@@ -0,0 +1,114 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLTestSuite.h"
+#include "XLVkVertexKernels.h"
+
+namespace stappler::xenolith::app {
+
+static Vector<gl::Vertex_V4F_V4F_T2F2U> TestVertexKernels_makeVertexes(size_t count) {
+	Vector<gl::Vertex_V4F_V4F_T2F2U> ret; ret.resize(count);
+	for (size_t i = 0; i < count; ++ i) {
+		auto f = float(i);
+		ret[i].pos = Vec4(f, f + 0.5f, 0.0f, 1.0f);
+		ret[i].color = Vec4(f / count, 1.0f, 0.5f, 1.0f);
+		ret[i].tex = Vec2(f * 0.25f, -f);
+		ret[i].material = uint32_t(i * 7);
+		ret[i].object = uint32_t(i * 13);
+	}
+	return ret;
+}
+
+static Vector<uint32_t> TestVertexKernels_makeIndexes(size_t count, uint32_t max) {
+	Vector<uint32_t> ret; ret.resize(count);
+	for (size_t i = 0; i < count; ++ i) {
+		ret[i] = uint32_t((i * 2654435761u) % max);
+	}
+	return ret;
+}
+
+// every kernel should produce exactly the same output as scalar one, sizes cover all vector tails
+static TestSuite s_vertexKernelsTest("vk.VertexKernels", [] (TestSuite &test) -> bool {
+	auto &kernels = vk::getVertexKernels();
+	auto &scalar = vk::getScalarVertexKernels();
+
+	log::vtext("Test", test.getName(), ": using ", kernels.name);
+
+	for (size_t count = 0; count < 67; ++ count) {
+		auto source = TestVertexKernels_makeVertexes(count);
+		Vector<gl::Vertex_V4F_V4F_T2F2U> a; a.resize(count);
+		Vector<gl::Vertex_V4F_V4F_T2F2U> b; b.resize(count);
+
+		kernels.stampVertexes(a.data(), source.data(), count, 3, 12345);
+		scalar.stampVertexes(b.data(), source.data(), count, 3, 12345);
+		if (!test.expect(memcmp(a.data(), b.data(), count * sizeof(gl::Vertex_V4F_V4F_T2F2U)) == 0, toString("stamp ", count))) {
+			return false;
+		}
+
+		auto indexes = TestVertexKernels_makeIndexes(count, 30000);
+		Vector<uint32_t> l1; l1.resize(count);
+		Vector<uint32_t> l2; l2.resize(count);
+		kernels.rebaseIndexes(l1.data(), indexes.data(), count, 100000);
+		scalar.rebaseIndexes(l2.data(), indexes.data(), count, 100000);
+		if (!test.expect(l1 == l2, toString("rebase ", count))) {
+			return false;
+		}
+
+		// full 16-bit range, including values above 0x7FFF, that requires unsigned packing
+		Vector<uint16_t> s1; s1.resize(count);
+		Vector<uint16_t> s2; s2.resize(count);
+		kernels.rebaseShortIndexes(s1.data(), indexes.data(), count, 35535);
+		scalar.rebaseShortIndexes(s2.data(), indexes.data(), count, 35535);
+		if (!test.expect(s1 == s2, toString("short rebase ", count))) {
+			return false;
+		}
+	}
+
+	return true;
+});
+
+static TestSuite s_vertexKernelsBench("vk.VertexKernels.bench", [] (TestSuite &test) -> bool {
+	static constexpr size_t VertexCount = 1 << 20;
+	static constexpr uint32_t Iterations = 50;
+
+	auto source = TestVertexKernels_makeVertexes(VertexCount);
+	auto indexes = TestVertexKernels_makeIndexes(VertexCount * 3 / 2, 60000 - 1024);
+	Vector<gl::Vertex_V4F_V4F_T2F2U> target; target.resize(VertexCount);
+	Vector<uint32_t> longTarget; longTarget.resize(indexes.size());
+	Vector<uint16_t> shortTarget; shortTarget.resize(indexes.size());
+
+	for (auto k : { &vk::getScalarVertexKernels(), &vk::getVertexKernels() }) {
+		test.benchmark(toString(k->name, " stamp 1M vertexes"), Iterations, [&] {
+			k->stampVertexes(target.data(), source.data(), source.size(), 1, 2);
+		});
+		test.benchmark(toString(k->name, " rebase 1.5M indexes"), Iterations, [&] {
+			k->rebaseIndexes(longTarget.data(), indexes.data(), indexes.size(), 1024);
+		});
+		test.benchmark(toString(k->name, " rebase 1.5M short indexes"), Iterations, [&] {
+			k->rebaseShortIndexes(shortTarget.data(), indexes.data(), indexes.size(), 1024);
+		});
+	}
+
+	return true;
+});
+
+}
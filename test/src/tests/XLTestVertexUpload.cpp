@@ -0,0 +1,199 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLTestSuite.h"
+#include "XLVkMaterialRenderPass.h"
+
+namespace stappler::xenolith::app {
+
+using WriteTask = vk::VertexMaterialAttachmentHandle::WriteTask;
+using WriteTarget = vk::VertexMaterialAttachmentHandle::WriteTarget;
+
+// synthetic frame: mostly quads, every 16th command is a larger mesh, every 5th command is retained in cache
+struct TestVertexUpload_Frame {
+	Vector<Rc<gl::VertexData>> data;
+	Vector<gl::CmdVertexArray> commands;
+	Vector<WriteTask> tasks;
+	uint32_t vertexes = 0;
+	uint32_t longIndexes = 0;
+	uint32_t shortIndexes = 0;
+
+	TestVertexUpload_Frame(uint32_t count) {
+		for (uint32_t i = 0; i < 64; ++ i) {
+			auto d = Rc<gl::VertexData>::alloc();
+			auto size = (i % 16 == 0) ? 64 : 4;
+			d->data.resize(size);
+			for (uint32_t j = 0; j < size; ++ j) {
+				auto f = float(i * 64 + j);
+				d->data[j].pos = Vec4(f, -f, f * 0.5f, 1.0f);
+				d->data[j].color = Vec4(float(j) / size, 0.5f, 1.0f, 1.0f);
+				d->data[j].tex = Vec2(f * 0.125f, 1.0f - f * 0.125f);
+			}
+			for (uint32_t j = 0; j + 3 < size; j += 2) {
+				d->indexes.insert(d->indexes.end(), { j, j + 1, j + 2, j + 3, j + 2, j + 1 });
+			}
+			data.emplace_back(move(d));
+		}
+
+		commands.resize(count);
+		tasks.reserve(count);
+		for (uint32_t i = 0; i < count; ++ i) {
+			auto &cmd = commands[i];
+			cmd.transform = Mat4::IDENTITY;
+			cmd.transform.m[12] = float(i);
+			cmd.vertexes = data[i % data.size()];
+
+			bool isShort = (i % 2 == 0);
+			auto &indexOffset = isShort ? shortIndexes : longIndexes;
+			tasks.emplace_back(WriteTask{&cmd, i % 8, i, vertexes, indexOffset, vertexes, isShort, i % 5 != 0});
+			vertexes += cmd.vertexes->data.size();
+			indexOffset += cmd.vertexes->indexes.size();
+		}
+	}
+};
+
+struct TestVertexUpload_Buffers {
+	Vector<uint8_t> vertexes;
+	Vector<uint8_t> indexes;
+	Vector<uint8_t> transforms;
+	WriteTarget target;
+
+	TestVertexUpload_Buffers(const TestVertexUpload_Frame &frame, gl::VertexFormat format) {
+		vertexes.resize(frame.vertexes * gl::getVertexFormatSize(format));
+		indexes.resize(frame.longIndexes * sizeof(uint32_t) + frame.shortIndexes * sizeof(uint16_t));
+		transforms.resize(frame.commands.size() * sizeof(Mat4));
+		target = WriteTarget{vertexes.data(), indexes.data(), transforms.data(), frame.longIndexes * sizeof(uint32_t), format};
+	}
+
+	bool operator==(const TestVertexUpload_Buffers &other) const {
+		return vertexes == other.vertexes && indexes == other.indexes && transforms == other.transforms;
+	}
+};
+
+// writes chunks on threads of queue and on calling thread, like loop's queue does with scheduleWriteChunks
+static void TestVertexUpload_write(thread::TaskQueue *queue, uint32_t workers, const WriteTarget &target,
+		const Vector<Vector<WriteTask>> &chunks) {
+	std::atomic<size_t> next = 0;
+	std::atomic<size_t> done = 0;
+	std::atomic<uint32_t> exited = 0;
+
+	auto run = [&] {
+		size_t idx = 0;
+		while ((idx = next.fetch_add(1)) < chunks.size()) {
+			vk::VertexMaterialAttachmentHandle::writeVertexes(target, chunks[idx]);
+			done.fetch_add(1);
+		}
+	};
+
+	for (uint32_t i = 0; i < workers && queue; ++ i) {
+		queue->perform(Rc<thread::Task>::create([&] (const thread::Task &) -> bool {
+			run();
+			exited.fetch_add(1); // state on stack should not be used after this point
+			return true;
+		}));
+	}
+
+	run();
+	while (done.load() < chunks.size() || (queue && exited.load() < workers)) {
+		std::this_thread::yield();
+	}
+}
+
+// parallel chunked upload should produce exactly the same buffers as serial one
+static TestSuite s_vertexUploadTest("vk.VertexUpload", [] (TestSuite &test) -> bool {
+	auto queue = Rc<thread::TaskQueue>::alloc(4, nullptr, "TestVertexUpload");
+	if (!test.expect(queue->spawnWorkers(), "spawn workers")) {
+		return false;
+	}
+
+	for (uint32_t count : { 1, 100, 1'000, 10'000 }) {
+		TestVertexUpload_Frame frame(count);
+
+		// small chunk size, so even small frames are split
+		for (uint32_t chunkSize : { 1u, 256u, config::VertexUploadChunkSize }) {
+			auto chunks = vk::VertexMaterialAttachmentHandle::splitWriteTasks(frame.tasks, chunkSize);
+
+			// chunks cover all tasks in order, only last chunk can be smaller than chunk size
+			size_t idx = 0;
+			bool ordered = true;
+			for (size_t i = 0; i < chunks.size(); ++ i) {
+				uint32_t written = 0;
+				for (auto &it : chunks[i]) {
+					ordered = ordered && idx < frame.tasks.size() && it.cmd == frame.tasks[idx].cmd;
+					written += it.writeVertexes ? it.cmd->vertexes->data.size() : 0;
+					++ idx;
+				}
+				if (i + 1 < chunks.size()) {
+					ordered = ordered && written >= chunkSize;
+				}
+			}
+			test.expect(ordered && idx == frame.tasks.size(), toString(count, " commands, chunk ", chunkSize, ": split"));
+
+			for (auto format : { gl::VertexFormat::V4F_V4F_T2F2U, gl::VertexFormat::V2F_C4B_T2H_2U, gl::VertexFormat::V3F_C4B_T2H_2U }) {
+				TestVertexUpload_Buffers serial(frame, format);
+				TestVertexUpload_Buffers parallel(frame, format);
+
+				vk::VertexMaterialAttachmentHandle::writeVertexes(serial.target, frame.tasks);
+				TestVertexUpload_write(queue, 4, parallel.target, chunks);
+
+				test.expect(serial == parallel, toString(count, " commands, chunk ", chunkSize, ", format ", toInt(format), ": buffers"));
+			}
+		}
+	}
+
+	queue->cancelWorkers();
+	return true;
+});
+
+// per-core scaling of vertex upload, 1k-100k commands
+static TestSuite s_vertexUploadBenchmark("vk.VertexUpload.bench", [] (TestSuite &test) -> bool {
+	auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+
+	for (uint32_t count : { 1'000, 10'000, 100'000 }) {
+		TestVertexUpload_Frame frame(count);
+		TestVertexUpload_Buffers buffers(frame, gl::VertexFormat::V4F_V4F_T2F2U);
+		auto chunks = vk::VertexMaterialAttachmentHandle::splitWriteTasks(frame.tasks, config::VertexUploadChunkSize);
+
+		auto serial = test.benchmark(toString("serial, ", count, " commands, ", frame.vertexes, " vertexes"), 20, [&] {
+			vk::VertexMaterialAttachmentHandle::writeVertexes(buffers.target, frame.tasks);
+		});
+
+		for (uint32_t threads = 2; threads <= std::min(cores, 16u); threads *= 2) {
+			// calling thread is one of writers
+			auto queue = Rc<thread::TaskQueue>::alloc(threads - 1, nullptr, "TestVertexUpload");
+			if (!test.expect(queue->spawnWorkers(), "spawn workers")) {
+				return false;
+			}
+
+			auto t = test.benchmark(toString(threads, " threads, ", count, " commands, ", chunks.size(), " chunks"), 20, [&] {
+				TestVertexUpload_write(queue, threads - 1, buffers.target, chunks);
+			});
+
+			log::vtext("Test", test.getName(), ": ", count, " commands, ", threads, " threads: speedup ", t > 0.0 ? serial / t : 0.0);
+			queue->cancelWorkers();
+		}
+	}
+
+	return true;
+});
+
+}
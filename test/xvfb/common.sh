@@ -0,0 +1,77 @@
+# Shared helpers for tests, that run test application on virtual X server
+# Requires Xvfb and xdotool; application binary can be overridden with TESTAPP
+
+TESTAPP=${TESTAPP:-$(dirname "$0")/../stappler-build/host/debug/testapp}
+XVFB_DISPLAY=${XVFB_DISPLAY:-:97}
+XVFB_SCREEN=${XVFB_SCREEN:-1920x1080x24}
+APP_LOG=$(mktemp)
+
+xvfb_cleanup() {
+	[ -n "$APP_PID" ] && kill "$APP_PID" 2>/dev/null
+	[ -n "$XVFB_PID" ] && kill "$XVFB_PID" 2>/dev/null
+	rm -f "$APP_LOG"
+}
+
+trap xvfb_cleanup EXIT
+
+xvfb_start() {
+	Xvfb "$XVFB_DISPLAY" -screen 0 "$XVFB_SCREEN" +extension XInputExtension >/dev/null 2>&1 &
+	XVFB_PID=$!
+	export DISPLAY="$XVFB_DISPLAY"
+	sleep 1
+}
+
+# run application in background with options, its output is collected in APP_LOG
+app_start() {
+	"$TESTAPP" "$@" > "$APP_LOG" 2>&1 &
+	APP_PID=$!
+}
+
+# wait for window with name, prints window id
+app_window() {
+	timeout 10 xdotool search --sync --name "^$1\$" | head -n 1
+}
+
+app_stop() {
+	kill "$APP_PID" 2>/dev/null
+	wait "$APP_PID" 2>/dev/null
+	APP_PID=
+}
+
+app_log_count() {
+	grep -c "$1" "$APP_LOG"
+}
+
+# number of lines in application log, marks start of test phase for app_stat
+app_log_lines() {
+	wc -l < "$APP_LOG"
+}
+
+# application log after line <from>, or between lines for "<from>,<to>"
+app_log_range() {
+	case "$1" in
+	*,*) sed -n "$((${1%,*} + 1)),${1#*,}p" "$APP_LOG" ;;
+	*) tail -n +$(($1 + 1)) "$APP_LOG" ;;
+	esac
+}
+
+# values of numeric field from AppScene stat lines, logged after line number (or within range):
+# app_stat <line> <"Frames:" or "Input:"> <field name, e.g. "max:">
+app_stat() {
+	app_log_range "$1" | grep "AppScene.*$2" | sed -n "s/.* $3 \(-\{0,1\}[0-9.]*\).*/\1/p"
+}
+
+app_stat_max() {
+	app_stat "$@" | sort -g | tail -n 1
+}
+
+app_stat_sum() {
+	app_stat "$@" | awk '{ s += $1 } END { printf "%g\n", s }'
+}
+
+fail() {
+	echo "FAIL: $*"
+	echo "--- application log:"
+	tail -n 50 "$APP_LOG"
+	exit 1
+}
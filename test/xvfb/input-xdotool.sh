@@ -0,0 +1,55 @@
+#!/bin/sh
+# Synthetic pointer input with xdotool: drag and clicks should be delivered through input queue
+# without drops, motion faster than frame rate should be coalesced, input processing cost
+# per frame (from AppScene stat) is reported.
+
+. "$(dirname "$0")/common.sh"
+
+MOTIONS=${MOTIONS:-2000}
+CLICKS=${CLICKS:-10}
+MAX_INPUT_TIME=${MAX_INPUT_TIME:-2000} # microseconds per frame
+
+xvfb_start
+app_start w=800 h=600
+WID=$(app_window Xenolith) || fail "window was not created"
+
+sleep 1
+xdotool mousemove --window "$WID" 400 300
+sleep 0.5
+START=$(app_log_lines)
+
+# drag with single xdotool call, so motion is generated much faster, then frames
+ARGS="mousedown 1"
+i=0
+while [ $i -lt "$MOTIONS" ]; do
+	ARGS="$ARGS mousemove --window $WID $((100 + i % 600)) $((100 + (i / 600) * 100))"
+	i=$((i + 1))
+done
+xdotool $ARGS mouseup 1
+
+xdotool click --repeat "$CLICKS" --delay 50 1
+
+# wait for next stat interval
+sleep 1.5
+kill -0 "$APP_PID" 2>/dev/null || fail "application terminated"
+app_stop
+
+EVENTS=$(app_stat_sum "$START" "Input:" "events:")
+COALESCED=$(app_stat_sum "$START" "Input:" "coalesced:")
+BUTTONS=$(app_stat_sum "$START" "Input:" "buttons:")
+FRAMES=$(app_stat_sum "$START" "Input:" "frames:")
+DROPPED=$(app_stat_max "$START" "Input:" "dropped:")
+AVG=$(app_stat_max "$START" "Input:" "avg:")
+MAX=$(app_stat_max "$START" "Input:" "max:")
+
+echo "motions: $MOTIONS, clicks: $CLICKS"
+echo "input frames: $FRAMES, events: $EVENTS, coalesced: $COALESCED, buttons: $BUTTONS, dropped: ${DROPPED:-0}"
+echo "input processing per frame: avg ${AVG:-?} us, max ${MAX:-?} us"
+
+[ -n "$MAX" ] || fail "no input stat"
+[ "$BUTTONS" -ge $((2 + CLICKS * 2)) ] || fail "button events lost: $BUTTONS"
+[ $((EVENTS + COALESCED)) -ge $((MOTIONS * 9 / 10)) ] || fail "motion events lost: $((EVENTS + COALESCED)) of $MOTIONS"
+[ "$COALESCED" -gt 0 ] || fail "motion was not coalesced"
+[ "${DROPPED:-0}" -eq 0 ] || fail "input queue overflow: $DROPPED"
+[ "$MAX" -le "$MAX_INPUT_TIME" ] || fail "input processing too slow: $MAX us > $MAX_INPUT_TIME us"
+echo "OK"
@@ -0,0 +1,52 @@
+#!/bin/sh
+# XInput2 input: wheel clicks from XTest pointer are delivered as smooth scroll valuators,
+# relative motion as raw motion; both are summed per frame (from AppScene stat).
+# First valuator value only initializes scroll position, so one notch can be missing.
+
+. "$(dirname "$0")/common.sh"
+
+NOTCHES=${NOTCHES:-20}
+MOTIONS=${MOTIONS:-40}
+
+xvfb_start
+app_start w=800 h=600
+WID=$(app_window Xenolith) || fail "window was not created"
+
+sleep 1
+[ "$(app_log_count "XInput2: enabled")" -ge 1 ] || fail "XInput2 is not available"
+
+xdotool mousemove --window "$WID" 400 300
+sleep 0.5
+
+# button 4 scrolls up (positive), button 5 down
+UP_START=$(app_log_lines)
+xdotool click --repeat "$NOTCHES" --delay 10 4
+sleep 1.5
+
+DOWN_START=$(app_log_lines)
+xdotool click --repeat "$NOTCHES" --delay 10 5
+sleep 1.5
+
+RAW_START=$(app_log_lines)
+i=0
+while [ $i -lt "$MOTIONS" ]; do
+	xdotool mousemove_relative -- 5 0
+	i=$((i + 1))
+done
+sleep 1.5
+
+kill -0 "$APP_PID" 2>/dev/null || fail "application terminated"
+app_stop
+
+UP=$(app_stat_sum "$UP_START,$DOWN_START" "Input:" "scrollY:")
+DOWN=$(app_stat_sum "$DOWN_START,$RAW_START" "Input:" "scrollY:")
+RAW=$(app_stat_sum "$RAW_START" "Input:" "rawX:")
+
+echo "notches: $NOTCHES, scroll up: $UP, scroll down: $DOWN"
+echo "relative motion: $((MOTIONS * 5)), raw motion: $RAW"
+
+# compare with awk, values can be fractional
+awk -v v="$UP" -v n="$NOTCHES" 'BEGIN { exit !(v >= n - 1 && v <= n) }' || fail "scroll up: $UP, expected $NOTCHES"
+awk -v v="$DOWN" -v n="$NOTCHES" 'BEGIN { exit !(-v >= n - 1 && -v <= n) }' || fail "scroll down: $DOWN, expected -$NOTCHES"
+awk -v v="$RAW" -v n="$((MOTIONS * 5))" 'BEGIN { exit !(v >= n * 0.9) }' || fail "raw motion: $RAW, expected $((MOTIONS * 5))"
+echo "OK"
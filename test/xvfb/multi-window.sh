@@ -0,0 +1,35 @@
+#!/bin/sh
+# Several windows, driven by one compiled render queue: every window should be created,
+# resize of one window should rebuild only its own swapchain, other windows continue to work.
+
+. "$(dirname "$0")/common.sh"
+
+VIEWS=${VIEWS:-3}
+
+xvfb_start
+app_start w=640 h=480 views=$VIEWS
+
+WID=$(app_window Xenolith) || fail "window 1 was not created"
+i=2
+while [ $i -le "$VIEWS" ]; do
+	app_window "Xenolith #$i" > /dev/null || fail "window $i was not created"
+	i=$((i + 1))
+done
+
+sleep 1
+BEFORE=$(app_log_count "Swapchain recreation #")
+
+xdotool windowsize "$WID" 800 600
+sleep 1
+
+kill -0 "$APP_PID" 2>/dev/null || fail "application terminated"
+AFTER=$(app_log_count "Swapchain recreation #")
+ERRORS=$(app_log_count "Vk-Error\|VK-Error")
+app_stop
+
+COUNT=$((AFTER - BEFORE))
+echo "windows: $VIEWS, swapchain recreations: $COUNT, errors: $ERRORS"
+
+[ "$COUNT" -ge 1 ] || fail "swapchain was not rebuilt after resize"
+[ "$ERRORS" -eq 0 ] || fail "renderer errors in log"
+echo "OK"
@@ -0,0 +1,47 @@
+#!/bin/sh
+# Resize storm: window is resized every 5 ms for 2 seconds (400 resize events).
+# Swapchain rebuilds are throttled to one per frame and debounced, so recreation
+# count should be far below event count, and at least one final rebuild should happen.
+# Frame intervals (from AppScene stat) are compared with ones before the storm:
+# old swapchain is retired without device wait, so there should be no long stalls.
+
+. "$(dirname "$0")/common.sh"
+
+MAX_RECREATIONS=${MAX_RECREATIONS:-60}
+MAX_FRAME_INTERVAL=${MAX_FRAME_INTERVAL:-200000} # microseconds
+
+xvfb_start
+app_start w=800 h=600
+WID=$(app_window Xenolith) || fail "window was not created"
+
+# two stat intervals without resize as baseline
+sleep 2
+BEFORE=$(app_log_count "Swapchain recreation #")
+BASE_P99=$(app_stat_max 0 "Frames:" "p99:")
+STORM_START=$(app_log_lines)
+
+i=0
+while [ $i -lt 400 ]; do
+	xdotool windowsize "$WID" $((600 + (i * 7) % 400)) $((400 + (i * 5) % 300))
+	sleep 0.005
+	i=$((i + 1))
+done
+
+# wait for debounce interval and final rebuild
+sleep 1
+AFTER=$(app_log_count "Swapchain recreation #")
+app_stop
+
+COUNT=$((AFTER - BEFORE))
+STORM_P99=$(app_stat_max "$STORM_START" "Frames:" "p99:")
+STORM_MAX=$(app_stat_max "$STORM_START" "Frames:" "max:")
+STORM_FRAMES=$(app_stat_sum "$STORM_START" "Frames:" "Frames:")
+
+echo "resize events: 400, swapchain recreations: $COUNT"
+echo "frame interval p99 before: ${BASE_P99:-?} us, during storm: p99 ${STORM_P99:-?} us, max ${STORM_MAX:-?} us, frames: $STORM_FRAMES"
+
+[ "$COUNT" -ge 1 ] || fail "swapchain was not rebuilt after resize"
+[ "$COUNT" -le "$MAX_RECREATIONS" ] || fail "too many swapchain recreations: $COUNT > $MAX_RECREATIONS"
+[ -n "$STORM_MAX" ] || fail "no frame stat during resize storm"
+[ "$STORM_MAX" -le "$MAX_FRAME_INTERVAL" ] || fail "frame stall during resize: $STORM_MAX us > $MAX_FRAME_INTERVAL us"
+echo "OK"
@@ -30,15 +30,78 @@ namespace stappler::xenolith::config {
 /* Number of child slot, that will be preallocated on first child addition (not on node creation!) */
 static constexpr size_t NodePreallocateChilds = 4;
 
+/* Depth of SpatialNode loose quadtree, cell size on deepest level is content size / 2^depth */
+static constexpr uint32_t SpatialNodeMaxDepth = 10;
+
+/* Minimal number of nodes in scene, for which top-level subtrees are visited in parallel */
+static constexpr size_t ParallelVisitMinNodes = 4 * 1024;
+
+/* Interval (in microseconds) after last window resize event, after which resize is considered finished */
+static constexpr uint64_t ViewResizeDebounceInterval = 100'000;
+
+/* Capacity of input events queue between view and Director; events are dropped on overflow */
+static constexpr uint32_t InputQueueCapacity = 1024;
+
+/* Number of pointer motion samples, retained for velocity estimation */
+static constexpr size_t InputMotionHistorySize = 32;
+
+/* Interval (in microseconds) of motion history, used for pointer velocity estimation */
+static constexpr uint64_t InputVelocityInterval = 100'000;
+
+/* Bucket width (in microseconds) for gl::LatencyHistogram */
+static constexpr uint64_t LatencyHistogramBucketInterval = 250;
+
+/* Number of buckets in gl::LatencyHistogram, larger values are counted in last bucket */
+static constexpr size_t LatencyHistogramBuckets = 1024;
+
+/* Max presents, waiting for VK_GOOGLE_display_timing feedback, before oldest is dropped */
+static constexpr size_t InputLatencyPendingPresents = 16;
+
 /* Presentation Scheduler interval, used for non-blocking vkWaitForFence */
 static constexpr uint64_t PresentationSchedulerInterval = 500; // 500 ms or 1/32 of 60fps frame
 
+/* Safety margin (in microseconds), added to predicted frame cost, when frame start is delayed towards next vblank */
+static constexpr uint64_t FramePacingMargin = 1'000;
+
+/* Timeout (in microseconds) for single vkWaitForPresentKHR call, used for frame pacing feedback */
+static constexpr uint64_t PresentWaitTimeout = 100'000;
+
+/* Interval (in microseconds) between frame rate reports in swapchain benchmark mode */
+static constexpr uint64_t BenchmarkReportInterval = 1'000'000;
+
+/* Swapchain image is redrawn fully, when damaged region covers larger part of it */
+static constexpr float PartialRedrawMaxArea = 0.5f;
+
+/* Frames of damage history, retained for partial redraw; image, presented earlier, is redrawn fully */
+static constexpr uint64_t PartialRedrawHistory = 8;
+
+/* Interval (in microseconds) of view updates, while scene is not changed and no frames are rendered (if frame interval is not set) */
+static constexpr uint64_t IdleCheckInterval = 1'000'000 / 60;
+
+/* Interval of idle checks is doubled, while scene is not changed, up to this value; input wakes view immediately */
+static constexpr uint64_t IdleCheckMaxInterval = 250'000;
+
 /* Max sampled image descriptors per material texture set (can be actually lower due maxPerStageDescriptorSampledImages) */
 static constexpr uint32_t MaxTextureSetImages = 1024;
 
 /* Maximum images in single material */
 static constexpr size_t MaxMaterialImages = 4;
 
+/* Maximum materials, compiled within single material compilation frame, rest of requests will be deferred to next frame */
+static constexpr size_t MaxMaterialsPerCompilation = 1024;
+
+/* Maximum material data (in bytes), uploaded within single material compilation frame */
+static constexpr size_t MaxMaterialBytesPerCompilation = 1024 * 1024;
+
+/* Vertexes per single upload task; larger vertex inputs are split into chunks and written in parallel */
+static constexpr uint32_t VertexUploadChunkSize = 16 * 1024;
+
+/* Initial size (in vertexes) for retained vertex buffer */
+static constexpr uint32_t VertexCacheInitialSize = 16 * 1024;
+
+/* Frames, after which unused retained vertex data can be released (should be larger then number of frames in flight) */
+static constexpr uint64_t VertexCacheRetainFrames = 4;
+
 #if DEBUG
 static constexpr uint64_t MaxDirectorDeltaTime = 10'000'000 / 16;
 #else
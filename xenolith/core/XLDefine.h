@@ -135,6 +135,15 @@ protected:
 	memory::pool_t *_pool = nullptr;
 };
 
+// global counter of changes, that can affect rendered frames: nodes, scheduled updates, materials and resources;
+// while it stays the same, no new frames are rendered; can be used from any thread
+uint64_t getSceneEpoch();
+void markSceneDirty();
+
+// scene graphs are visited on workers, when frame snapshots are built; main thread code, that can modify nodes
+// outside of director's update (main thread tasks, view callbacks), should wait for visits to complete
+void waitSceneVisits();
+
 struct UpdateTime {
 	// global OS timer at the start of update in microseconds
 	uint64_t global;
@@ -123,6 +123,8 @@ class EventHandlerNode;
 
 class Application;
 class Director;
+struct FrameSnapshot;
+struct InputEventData;
 
 using Task = thread::Task;
 
@@ -39,6 +39,16 @@ struct RenderFrameInfo {
 	Rc<Scene> scene;
 
 	Rc<gl::CommandList> commands;
+
+	// queue for parallel scene traversal, scene is visited on calling thread, if not set
+	Rc<thread::TaskQueue> queue;
+
+	// visible area in space of root transform (normalized device coordinates for scene)
+	Rect viewRect = Rect(-1.0f, -1.0f, 2.0f, 2.0f);
+
+	uint32_t culledNodes = 0; // nodes, that skipped draw
+	uint32_t culledSubtrees = 0; // nodes, that skipped whole subtree (children are not counted as culled nodes)
+	uint32_t retainedCommands = 0; // commands, replayed from retained subtrees
 };
 
 }
@@ -193,6 +193,8 @@ void VertexArray::clear() {
 
 	_data->data.clear();
 	_data->indexes.clear();
+	++ _data->version;
+	markSceneDirty();
 }
 
 VertexArray::Quad VertexArray::addQuad() {
@@ -203,6 +205,9 @@ VertexArray::Quad VertexArray::addQuad() {
 	auto firstVertex = _data->data.size();
 	auto firstIndex = _data->indexes.size();
 
+	++ _data->version;
+	markSceneDirty();
+
 	_data->data.resize(_data->data.size() + 4);
 	_data->indexes.resize(_data->indexes.size() + 6);
 
@@ -230,6 +235,10 @@ VertexArray::Quad VertexArray::getQuad(size_t firstVertex, size_t firstIndex) {
 		copy();
 	}
 
+	// quad is returned for modification
+	++ _data->version;
+	markSceneDirty();
+
 	return Quad({
 			SpanView<gl::Vertex_V4F_V4F_T2F2U>(_data->data.data() + firstVertex, 4),
 			SpanView<uint32_t>(_data->indexes.data() + firstIndex, 6),
@@ -244,6 +253,8 @@ void VertexArray::updateColor(const Color4F &color) {
 	for (auto &it : _data->data) {
 		it.color = color;
 	}
+	++ _data->version;
+	markSceneDirty();
 }
 
 void VertexArray::copy() {
@@ -251,6 +262,7 @@ void VertexArray::copy() {
 		auto data = Rc<gl::VertexData>::alloc();
 		data->data = _data->data;
 		data->indexes = _data->indexes;
+		data->version = _data->version + 1;
 		_data = data;
 		_copyOnWrite = false;
 	}
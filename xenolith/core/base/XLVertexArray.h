@@ -27,6 +27,9 @@
 
 namespace stappler::xenolith {
 
+// Every modification (clear, addQuad, getQuad, updateColor) advances scene epoch, so, new frame will be rendered;
+// data, published with pop(), is not modified, it's copied on next write
+// Area of owning node is not damaged by array, node should call markDamaged, when its geometry was changed
 class VertexArray : public Ref {
 public:
 	struct Quad {
@@ -23,12 +23,37 @@
 #include "XLDirector.h"
 #include "XLGlView.h"
 #include "XLGlDevice.h"
+#include "XLGlSwapchain.h"
 #include "XLScene.h"
 #include "XLVertexArray.h"
 #include "XLScheduler.h"
 
 namespace stappler::xenolith {
 
+XL_DECLARE_EVENT_CLASS(Director, onInput);
+
+static std::atomic<uint64_t> s_sceneEpoch = 1;
+
+uint64_t getSceneEpoch() {
+	return s_sceneEpoch.load(std::memory_order_acquire);
+}
+
+void markSceneDirty() {
+	s_sceneEpoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+// snapshot visits, active on workers for all directors
+static Mutex s_visitMutex;
+static std::condition_variable s_visitCondition;
+static uint32_t s_visitCount = 0;
+
+void waitSceneVisits() {
+	std::unique_lock<Mutex> lock(s_visitMutex);
+	s_visitCondition.wait(lock, [] {
+		return s_visitCount == 0;
+	});
+}
+
 Director::Director() { }
 
 Director::~Director() { }
@@ -40,6 +65,7 @@ bool Director::init(Application *app, Rc<Scene> &&scene) {
 	_pool->perform([&] {
 		_scheduler = Rc<Scheduler>::create();
 	});
+	_inputQueue = Rc<InputQueue>::create();
 	_startTime = _application->getClock();
 	_time.global = 0;
 	_time.app = 0;
@@ -52,6 +78,8 @@ const Rc<ResourceCache> &Director::getResourceCache() const {
 }
 
 void Director::update() {
+	waitSnapshotVisit();
+
 	auto t = _application->getClock();
 
 	if (_time.global) {
@@ -80,9 +108,255 @@ void Director::update() {
 		_scene->setContentSize(size / d);
 		_scene->onPresented(this);
 		_nextScene = nullptr;
+		markSceneDirty();
 	}
 
+	processInput();
+
 	_scheduler->update(_time);
+
+	// snapshots are built only for frames, that requested them; changes only wake swapchain
+	if (_scene && _view) {
+		if (hasSnapshotRequest()) {
+			captureSnapshot();
+			setIdle(false);
+		} else if (getSceneEpoch() != _sceneEpoch) {
+			setIdle(false);
+		} else {
+			// nothing was changed since last snapshot, previous image remains on screen;
+			// input without visible effect is not counted in latency
+			_inputTime = 0;
+			setIdle(true);
+		}
+	}
+}
+
+void Director::requestSnapshot(SnapshotCallback &&cb) {
+	std::unique_lock<Mutex> lock(_snapshotMutex);
+	_snapshotRequests.emplace_back(SnapshotRequest{move(cb), _application->getClock()});
+	++ _snapshotStat.requested;
+}
+
+bool Director::hasSnapshotRequest() const {
+	std::unique_lock<Mutex> lock(_snapshotMutex);
+	return !_snapshotRequests.empty();
+}
+
+void Director::captureSnapshot() {
+	SnapshotRequest request;
+	do {
+		std::unique_lock<Mutex> lock(_snapshotMutex);
+		request = move(_snapshotRequests.front());
+		_snapshotRequests.pop_front();
+	} while (0);
+
+	// epoch is taken before capture, so changes, made after it, will be drawn with next snapshot
+	_sceneEpoch = getSceneEpoch();
+
+	auto t = _application->getClock();
+	auto snapshot = Rc<FrameSnapshot>::alloc();
+	auto pool = Rc<PoolRef>::alloc();
+	auto queue = _view->getLoop()->getQueue();
+
+	pool->perform([&] {
+		RenderFrameInfo info;
+		info.director = this;
+		info.scene = _scene;
+		info.pool = pool->getPool();
+		info.transformStack.push_back(_generalProjection);
+		info.commands = Rc<gl::CommandList>::create(pool);
+
+		_scene->capture(info);
+
+		snapshot->commands = move(info.commands);
+	});
+
+	snapshot->scene = _scene;
+	snapshot->inputTime = _inputTime;
+	_inputTime = 0;
+	snapshot->captureTime = _application->getClock() - t;
+
+	do {
+		std::unique_lock<Mutex> lock(s_visitMutex);
+		_visitActive = true;
+		++ s_visitCount;
+	} while (0);
+
+	queue->perform(Rc<thread::Task>::create([this, dir = Rc<Director>(this), pool, queue, snapshot,
+			request = move(request)] (const thread::Task &) -> bool {
+		auto visitStart = _application->getClock();
+		pool->perform([&] {
+			RenderFrameInfo info;
+			info.director = this;
+			info.scene = snapshot->scene;
+			info.pool = pool->getPool();
+			info.transformStack.reserve(8);
+			info.zPath.reserve(8);
+			info.transformStack.push_back(_generalProjection);
+			info.commands = snapshot->commands;
+			info.queue = queue;
+
+			snapshot->scene->emit(info);
+		});
+		snapshot->materials = snapshot->scene->popPendingMaterials();
+		snapshot->visitTime = _application->getClock() - visitStart;
+
+		onSnapshotVisited(Rc<FrameSnapshot>(snapshot), SnapshotRequest(request), visitStart);
+		return true;
+	}));
+}
+
+void Director::onSnapshotVisited(Rc<FrameSnapshot> &&snapshot, SnapshotRequest &&request, uint64_t visitStart) {
+	auto t = _application->getClock();
+
+	bool hasRequests = false;
+	do {
+		std::unique_lock<Mutex> lock(_snapshotMutex);
+		_snapshotStat.captureTime = snapshot->captureTime;
+		_snapshotStat.visitTime = snapshot->visitTime;
+		_snapshotStat.age = t - request.clock;
+		++ _snapshotStat.built;
+		hasRequests = !_snapshotRequests.empty();
+	} while (0);
+
+	if (hasRequests) {
+		// next snapshot can be captured on next update
+		_view->pushEvent(AppEvent::Update);
+	}
+
+	uint64_t overlap = 0;
+	do {
+		std::unique_lock<Mutex> lock(s_visitMutex);
+		// main thread was free from visit start, until it started to wait for visit completion
+		overlap = snapshot->visitTime;
+		if (_visitWaitStart) {
+			overlap = (_visitWaitStart > visitStart) ? std::min(_visitWaitStart - visitStart, overlap) : 0;
+		}
+
+		_visitActive = false;
+		-- s_visitCount;
+		s_visitCondition.notify_all();
+	} while (0);
+
+	do {
+		std::unique_lock<Mutex> lock(_snapshotMutex);
+		_snapshotStat.overlapTime = overlap;
+	} while (0);
+
+	// frame and loop are not part of scene graph, they can be used after visit is completed
+	request.callback(move(snapshot));
+}
+
+void Director::waitSnapshotVisit() {
+	std::unique_lock<Mutex> lock(s_visitMutex);
+	if (!_visitActive) {
+		return;
+	}
+
+	_visitWaitStart = _application->getClock();
+	s_visitCondition.wait(lock, [&] {
+		return !_visitActive;
+	});
+	_visitWaitStart = 0;
+}
+
+Director::SnapshotStat Director::getSnapshotStat() const {
+	std::unique_lock<Mutex> lock(_snapshotMutex);
+	return _snapshotStat;
+}
+
+void Director::pushInputEvent(const InputEventData &event) {
+	_inputQueue->push(event);
+}
+
+void Director::processInput() {
+	auto t = _application->getClock();
+
+	_inputEvents.clear();
+	_inputStat.coalesced = 0;
+	_pointerWheel.amount = Vec2::ZERO;
+	_rawPointerDelta = Vec2::ZERO;
+
+	_inputQueue->pop([&] (const InputEventData &event) {
+		// earliest unpresented input, stamp is passed to frame with next snapshot
+		if (!_inputTime || event.time < _inputTime) {
+			_inputTime = event.time;
+		}
+
+		switch (event.event) {
+		case InputEventName::Begin:
+			_pointerTouch.id = event.id;
+			_pointerTouch.startPoint = _pointerTouch.prevPoint = _pointerTouch.point = event.getLocation();
+			_pointerLocation = event.getLocation();
+			_motionHistory.clear();
+			_motionHistory.add(event.getLocation(), event.time);
+			break;
+		case InputEventName::Move:
+		case InputEventName::MouseMove:
+			_pointerTouch.prevPoint = _pointerTouch.point;
+			_pointerTouch.point = event.getLocation();
+			_pointerLocation = event.getLocation();
+			_motionHistory.add(event.getLocation(), event.time);
+			if (!_inputEvents.empty() && _inputEvents.back().event == event.event && _inputEvents.back().id == event.id) {
+				// merge with previous motion, history is preserved in motion samples
+				auto coalesced = _inputEvents.back().coalesced + 1;
+				_inputEvents.back() = event;
+				_inputEvents.back().coalesced = coalesced;
+				++ _inputStat.coalesced;
+				return;
+			}
+			break;
+		case InputEventName::End:
+		case InputEventName::Cancel:
+			_pointerTouch.prevPoint = _pointerTouch.point;
+			_pointerTouch.point = event.getLocation();
+			_pointerLocation = event.getLocation();
+			_motionHistory.add(event.getLocation(), event.time);
+			_pointerTouch.id = -1;
+			break;
+		case InputEventName::Scroll:
+			_pointerWheel.position.point = event.getLocation();
+			_pointerWheel.amount += Vec2(event.valueX, event.valueY);
+			_scrollOffset += Vec2(event.valueX, event.valueY);
+			_scrollHistory.add(_scrollOffset, event.time);
+			if (!_inputEvents.empty() && _inputEvents.back().event == event.event) {
+				// scroll steps are summed, timestamps are preserved in scroll history
+				auto &prev = _inputEvents.back();
+				prev.valueX += event.valueX;
+				prev.valueY += event.valueY;
+				prev.x = event.x;
+				prev.y = event.y;
+				prev.time = event.time;
+				++ prev.coalesced;
+				++ _inputStat.coalesced;
+				return;
+			}
+			break;
+		case InputEventName::RawMotion:
+			_rawPointerDelta += Vec2(event.valueX, event.valueY);
+			if (!_inputEvents.empty() && _inputEvents.back().event == event.event) {
+				auto &prev = _inputEvents.back();
+				prev.valueX += event.valueX;
+				prev.valueY += event.valueY;
+				prev.time = event.time;
+				++ prev.coalesced;
+				++ _inputStat.coalesced;
+				return;
+			}
+			break;
+		default:
+			break;
+		}
+		_inputEvents.emplace_back(event);
+	});
+
+	_inputStat.events = _inputEvents.size();
+	_inputStat.dropped = _inputQueue->getDropped();
+	_inputStat.processTime = _application->getClock() - t;
+
+	if (!_inputEvents.empty()) {
+		onInput(this);
+	}
 }
 
 void Director::begin(gl::View *view) {
@@ -95,6 +369,8 @@ void Director::begin(gl::View *view) {
 
 	_sizeChangedEvent = onEventWithObject(gl::View::onScreenSize, view, [&] (const Event &) {
 		if (_scene) {
+			waitSnapshotVisit();
+
 			auto &size = _view->getScreenSize();
 			auto d = _view->getDensity();
 
@@ -118,6 +394,13 @@ void Director::begin(gl::View *view) {
 }
 
 void Director::end() {
+	waitSnapshotVisit();
+
+	do {
+		std::unique_lock<Mutex> lock(_snapshotMutex);
+		_snapshotRequests.clear();
+	} while (0);
+
 	if (_scene) {
 		_scene->onExit();
 		_scene->onFinished(this);
@@ -163,6 +446,12 @@ static inline int32_t sp_gcd (int16_t a, int16_t b) {
 	return b;
 }
 
+void Director::setIdle(bool value) {
+	if (auto &swapchain = _view->getSwapchain()) {
+		swapchain->setIdle(value);
+	}
+}
+
 void Director::updateGeneralTransform() {
 	auto d = _view->getDensity();
 	auto size = _view->getScreenSize() / d;
@@ -175,6 +464,7 @@ void Director::updateGeneralTransform() {
 	proj.m[15] = 1.0f;
 
 	_generalProjection = proj;
+	markSceneDirty();
 }
 
 }
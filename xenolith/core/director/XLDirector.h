@@ -29,14 +29,42 @@
 #include "XLResourceCache.h"
 #include "XLGlView.h"
 #include "XLGlFrame.h"
+#include "XLGlMaterial.h"
+#include "XLInputQueue.h"
+#include "XLGestureData.h"
 
 namespace stappler::xenolith {
 
 class Scene;
 class Scheduler;
 
+// immutable scene state for single frame, built on frame's request: world transforms and damage are
+// captured on main thread at the end of update, then scene is visited on loop's worker, and commands
+// (transforms by value, retained vertex data and material ids) are emitted there, while main thread
+// continues with event processing; main thread waits for visit only when it starts to modify scene again
+struct FrameSnapshot : public Ref {
+	Rc<Scene> scene;
+	Rc<gl::CommandList> commands;
+
+	// materials, acquired while snapshot was built, should be compiled before commands are used
+	Map<const gl::MaterialAttachment *, Vector<Rc<gl::Material>>> materials;
+
+	uint64_t captureTime = 0; // microseconds on main thread
+	uint64_t visitTime = 0; // microseconds on worker
+	uint64_t inputTime = 0; // arrival time of earliest input event, that affects this snapshot, or 0
+};
+
 class Director : public Ref, EventHandler {
 public:
+	static EventHeader onInput;
+
+	struct InputStat {
+		uint32_t events = 0; // events, delivered in last frame
+		uint32_t coalesced = 0; // motion samples, merged in last frame
+		uint32_t dropped = 0; // events, dropped on queue overflow, total
+		uint64_t processTime = 0; // microseconds, spent on input in last frame
+	};
+
 	Director();
 
 	virtual ~Director();
@@ -52,6 +80,51 @@ public:
 
 	void update();
 
+	struct SnapshotStat {
+		uint64_t captureTime = 0; // microseconds on main thread, for last snapshot
+		uint64_t visitTime = 0; // microseconds of visit on worker, for last snapshot
+		uint64_t overlapTime = 0; // microseconds of last visit, when main thread was not blocked by it
+		uint64_t age = 0; // microseconds between request and submission, for last snapshot
+		uint32_t requested = 0;
+		uint32_t built = 0;
+	};
+
+	using SnapshotCallback = Function<void(Rc<FrameSnapshot> &&)>;
+
+	// request snapshot for frame, can be called from any thread; snapshot is captured on next update,
+	// callback is called on worker, that visits scene; view should be updated to process request
+	void requestSnapshot(SnapshotCallback &&);
+
+	SnapshotStat getSnapshotStat() const;
+
+	// can be called from view's event thread, events are processed on next update
+	void pushInputEvent(const InputEventData &);
+
+	// input events for current frame, consecutive motion events are coalesced into one
+	const Vector<InputEventData> &getInputEvents() const { return _inputEvents; }
+
+	// current pointer drag (id is -1, if no button is pressed) and wheel amount for current frame
+	const gesture::Touch &getPointerTouch() const { return _pointerTouch; }
+	const gesture::Wheel &getPointerWheel() const { return _pointerWheel; }
+	const Vec2 &getPointerLocation() const { return _pointerLocation; }
+
+	// sum of raw (unaccelerated) pointer motion for current frame
+	const Vec2 &getRawPointerDelta() const { return _rawPointerDelta; }
+
+	// all motion samples, received before coalescing
+	const InputMotionHistory &getMotionHistory() const { return _motionHistory; }
+
+	// cumulative scroll offsets with timestamps, for kinetic scrolling
+	const InputMotionHistory &getScrollHistory() const { return _scrollHistory; }
+
+	// pointer velocity (in view points per second), estimated from motion history
+	Vec2 getPointerVelocity() const { return _motionHistory.getVelocity(); }
+
+	// scroll velocity (in wheel notches per second), estimated from scroll history
+	Vec2 getScrollVelocity() const { return _scrollHistory.getVelocity(); }
+
+	const InputStat &getInputStat() const { return _inputStat; }
+
 	// should return valid RenderQueue from initial scene
 	void begin(gl::View *view);
 	void end();
@@ -66,6 +139,25 @@ protected:
 
 	void updateGeneralTransform();
 
+	struct SnapshotRequest {
+		SnapshotCallback callback;
+		uint64_t clock = 0;
+	};
+
+	bool hasSnapshotRequest() const;
+
+	// capture scene state for oldest request on main thread and visit scene on loop's worker
+	void captureSnapshot();
+	void onSnapshotVisited(Rc<FrameSnapshot> &&, SnapshotRequest &&, uint64_t visitStart);
+
+	// scene should not be modified, while it's visited on worker
+	void waitSnapshotVisit();
+
+	// swapchain stops rendering new frames, until scene is changed
+	void setIdle(bool);
+
+	void processInput();
+
 	uint64_t _startTime = 0;
 	UpdateTime _time;
 	bool _running = false;
@@ -82,6 +174,27 @@ protected:
 
 	Rc<PoolRef> _pool;
 	Rc<Scheduler> _scheduler;
+
+	mutable Mutex _snapshotMutex;
+	std::deque<SnapshotRequest> _snapshotRequests;
+	SnapshotStat _snapshotStat;
+	uint64_t _sceneEpoch = 0; // scene epoch of last captured snapshot
+
+	// guarded by global visit mutex, see waitSceneVisits
+	bool _visitActive = false;
+	uint64_t _visitWaitStart = 0; // when main thread started to wait for visit, or 0
+
+	Rc<InputQueue> _inputQueue;
+	Vector<InputEventData> _inputEvents;
+	InputMotionHistory _motionHistory;
+	InputMotionHistory _scrollHistory;
+	gesture::Touch _pointerTouch;
+	gesture::Wheel _pointerWheel;
+	Vec2 _pointerLocation;
+	Vec2 _rawPointerDelta;
+	Vec2 _scrollOffset;
+	InputStat _inputStat;
+	uint64_t _inputTime = 0;
 };
 
 }
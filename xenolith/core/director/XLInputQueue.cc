@@ -0,0 +1,104 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLInputQueue.h"
+
+namespace stappler::xenolith {
+
+void InputMotionHistory::add(const Vec2 &point, uint64_t time) {
+	_samples[_next] = Sample{point, time};
+	_next = (_next + 1) % _samples.size();
+	_count = std::min(_count + 1, _samples.size());
+}
+
+Vector<InputMotionHistory::Sample> InputMotionHistory::get() const {
+	Vector<Sample> ret;
+	ret.reserve(_count);
+	for (size_t i = _count; i > 0; -- i) {
+		ret.emplace_back(getFromEnd(i - 1));
+	}
+	return ret;
+}
+
+Vec2 InputMotionHistory::getVelocity() const {
+	if (_count < 2) {
+		return Vec2::ZERO;
+	}
+
+	auto &last = getFromEnd(0);
+	auto first = &last;
+	for (size_t i = 1; i < _count; ++ i) {
+		auto &it = getFromEnd(i);
+		if (last.time - it.time > config::InputVelocityInterval) {
+			break;
+		}
+		first = &it;
+	}
+
+	if (first == &last || last.time == first->time) {
+		return Vec2::ZERO;
+	}
+
+	return (last.point - first->point) * (1'000'000.0f / float(last.time - first->time));
+}
+
+const InputMotionHistory::Sample &InputMotionHistory::getFromEnd(size_t idx) const {
+	return _samples[(_next + _samples.size() - 1 - idx) % _samples.size()];
+}
+
+bool InputQueue::init(uint32_t capacity) {
+	uint32_t size = 1;
+	while (size < capacity) {
+		size <<= 1;
+	}
+
+	_events.resize(size);
+	_mask = size - 1;
+	return true;
+}
+
+bool InputQueue::push(const InputEventData &event) {
+	auto tail = _tail.load(std::memory_order_relaxed);
+	if (tail - _head.load(std::memory_order_acquire) > _mask) {
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	_events[tail & _mask] = event;
+	_tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+uint32_t InputQueue::pop(const Callback<void(const InputEventData &)> &cb) {
+	auto head = _head.load(std::memory_order_relaxed);
+	auto tail = _tail.load(std::memory_order_acquire);
+
+	uint32_t count = tail - head;
+	while (head != tail) {
+		cb(_events[head & _mask]);
+		++ head;
+		_head.store(head, std::memory_order_release);
+	}
+	return count;
+}
+
+}
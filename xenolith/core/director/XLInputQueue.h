@@ -0,0 +1,135 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#ifndef XENOLITH_CORE_DIRECTOR_XLINPUTQUEUE_H_
+#define XENOLITH_CORE_DIRECTOR_XLINPUTQUEUE_H_
+
+#include "XLDefine.h"
+
+namespace stappler::xenolith {
+
+enum class InputEventName : uint32_t {
+	None,
+	Begin, // pointer button pressed
+	Move, // pointer moved with pressed button
+	End, // pointer button released
+	Cancel,
+	MouseMove, // pointer moved without pressed buttons
+	Scroll,
+	KeyPressed,
+	KeyReleased,
+	FocusGained,
+	FocusLost,
+	PointerEnter,
+	PointerLeave,
+	RawMotion, // unaccelerated relative pointer motion, in valueX/valueY
+};
+
+// matches X11 modifier mask
+enum class InputModifier : uint32_t {
+	None = 0,
+	Shift = 1 << 0,
+	CapsLock = 1 << 1,
+	Ctrl = 1 << 2,
+	Alt = 1 << 3,
+	NumLock = 1 << 4,
+	Mod3 = 1 << 5,
+	Mod4 = 1 << 6,
+	Mod5 = 1 << 7,
+	Button1 = 1 << 8,
+	Button2 = 1 << 9,
+	Button3 = 1 << 10,
+	Button4 = 1 << 11,
+	Button5 = 1 << 12,
+};
+
+SP_DEFINE_ENUM_AS_MASK(InputModifier)
+
+struct InputEventData {
+	uint32_t id = maxOf<uint32_t>(); // pointer button or gesture::KeyCode
+	InputEventName event = InputEventName::None;
+	InputModifier modifiers = InputModifier::None;
+	float x = 0.0f; // in view coordinates, origin in bottom left corner
+	float y = 0.0f;
+	float valueX = 0.0f; // scroll amount (in wheel notches, can be fractional) or raw motion delta
+	float valueY = 0.0f;
+	uint64_t time = 0; // platform clock, when event was received, microseconds
+	uint32_t coalesced = 0; // motion samples, merged into this event
+
+	Vec2 getLocation() const { return Vec2(x, y); }
+};
+
+// Fixed-size history of timestamped positions, used for velocity estimation
+class InputMotionHistory {
+public:
+	struct Sample {
+		Vec2 point;
+		uint64_t time = 0;
+	};
+
+	void add(const Vec2 &, uint64_t time);
+	void clear() { _count = 0; }
+
+	size_t size() const { return _count; }
+
+	// samples, newest last
+	Vector<Sample> get() const;
+
+	// velocity (in units per second) over last config::InputVelocityInterval
+	Vec2 getVelocity() const;
+
+protected:
+	const Sample &getFromEnd(size_t) const;
+
+	std::array<Sample, config::InputMotionHistorySize> _samples;
+	size_t _count = 0;
+	size_t _next = 0;
+};
+
+// Bounded single producer, single consumer lock-free queue
+// Producer is view's event loop, consumer is Director in update
+class InputQueue : public Ref {
+public:
+	virtual ~InputQueue() { }
+
+	// capacity is rounded up to power of two
+	bool init(uint32_t capacity = config::InputQueueCapacity);
+
+	// returns false, if queue is full and event was dropped
+	bool push(const InputEventData &);
+
+	// pops all available events, returns number of events popped
+	uint32_t pop(const Callback<void(const InputEventData &)> &);
+
+	uint32_t getDropped() const { return _dropped.load(); }
+
+protected:
+	Vector<InputEventData> _events;
+	uint32_t _mask = 0;
+	std::atomic<uint32_t> _head = 0; // next event to read, written by consumer
+	std::atomic<uint32_t> _tail = 0; // next slot to write, written by producer
+	std::atomic<uint32_t> _dropped = 0;
+};
+
+}
+
+#endif /* XENOLITH_CORE_DIRECTOR_XLINPUTQUEUE_H_ */
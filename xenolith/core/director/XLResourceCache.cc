@@ -72,11 +72,22 @@ void ResourceCache::invalidate(gl::Device &dev) {
 }
 
 void ResourceCache::addResource(const Rc<gl::Resource> &req) {
-	_resources.emplace(req->getName(), req).first->second;
+	auto it = _resources.emplace(req->getName(), req).first;
+	++ _resourceRefs[it->first];
+	markSceneDirty();
 }
 
 void ResourceCache::removeResource(StringView requestName) {
+	auto it = _resourceRefs.find(requestName);
+	if (it != _resourceRefs.end() && -- it->second > 0) {
+		return;
+	}
+
+	if (it != _resourceRefs.end()) {
+		_resourceRefs.erase(it);
+	}
 	_resources.erase(requestName);
+	markSceneDirty();
 }
 
 Rc<Texture> ResourceCache::acquireTexture(StringView str) const {
@@ -50,6 +50,7 @@ public:
 	bool init(gl::Device &);
 	void invalidate(gl::Device &);
 
+	// resources are reference-counted by name, scenes with shared queue add same resource
 	void addResource(const Rc<gl::Resource> &);
 	void removeResource(StringView);
 
@@ -59,6 +60,7 @@ protected:
 	gl::ImageData _emptyImage;
 	gl::ImageData _solidImage;
 	Map<StringView, Rc<gl::Resource>> _resources;
+	Map<StringView, uint32_t> _resourceRefs;
 };
 
 }
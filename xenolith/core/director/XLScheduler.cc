@@ -76,6 +76,7 @@ void Scheduler::update(const UpdateTime &time) {
 	for (auto &it : _tmp) {
 		_list.emplace(it.target, it.priority, move(it.callback), it.paused);
 	}
+	_tmp.clear();
 }
 
 void Scheduler::resume(void *ptr) {
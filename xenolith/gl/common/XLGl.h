@@ -335,6 +335,36 @@ struct alignas(16) Vertex_V4F_V4F_T2F2U {
 	uint32_t object;
 };
 
+// Compact vertex formats, designed to use with SSBO and std430
+// color is RGBA8 unorm, texture coords are packed as half-float pair (u in low bits)
+struct Vertex_V2F_C4B_T2H_2U {
+	Vec2 pos;
+	uint32_t color;
+	uint32_t tex;
+	uint32_t material;
+	uint32_t object;
+};
+
+// vec3 is 16-byte aligned in std430, so, shader reads position as three separate floats
+struct Vertex_V3F_C4B_T2H_2U {
+	Vec3 pos;
+	uint32_t color;
+	uint32_t tex;
+	uint32_t material;
+	uint32_t object;
+};
+
+// Per-instance data for instanced quads, designed to use with SSBO and std430
+// Quad is expanded from shared unit quad: pos = transform.xy * x + transform.zw * y + origin
+struct alignas(16) QuadInstance {
+	Vec4 transform; // first two columns of 2D transform, scaled by quad size
+	Vec2 origin;
+	uint32_t color; // RGBA8 unorm
+	uint32_t material;
+	uint32_t texCoords[2]; // unorm16x2: (left, top), (right, bottom)
+	uint32_t padding[2];
+};
+
 struct Triangle_V3F_C4F_T2F {
 	Vertex_V4F_V4F_T2F2U a;
 	Vertex_V4F_V4F_T2F2U b;
@@ -357,11 +387,44 @@ struct VertexSpan {
 	uint32_t indexCount;
 	uint32_t instanceCount;
 	uint32_t firstIndex;
+	uint32_t firstInstance = 0;
+	int32_t vertexOffset = 0;
+	bool shortIndexes = false; // firstIndex is in 16-bit index region
 };
 
 struct VertexData : public AttachmentInputData {
 	Vector<Vertex_V4F_V4F_T2F2U> data;
 	Vector<uint32_t> indexes;
+
+	// incremented by owner on every mutation, used to validate retained GPU copies
+	uint64_t version = 0;
+};
+
+// fixed-width bucket histogram for frame latencies (in microseconds), can be updated from any thread
+class LatencyHistogram {
+public:
+	struct Stat {
+		uint32_t count = 0;
+		uint64_t p50 = 0;
+		uint64_t p95 = 0;
+		uint64_t p99 = 0;
+		uint64_t max = 0;
+	};
+
+	LatencyHistogram();
+
+	void add(uint64_t);
+	void clear();
+
+	Stat getStat(bool reset = false);
+
+protected:
+	uint64_t getPercentile(uint32_t count, uint32_t percent) const;
+
+	Mutex _mutex;
+	Vector<uint32_t> _buckets;
+	uint32_t _count = 0;
+	uint64_t _max = 0;
 };
 
 String getBufferFlagsDescription(BufferFlags fmt);
@@ -374,9 +437,11 @@ StringView getImageFormatName(ImageFormat fmt);
 StringView getImageTilingName(ImageTiling type);
 StringView getComponentMappingName(ComponentMapping);
 StringView getDescriptorTypeName(DescriptorType);
+StringView getPresentModeName(PresentMode);
 String getImageUsageDescription(ImageUsage fmt);
 String getProgramStageDescription(ProgramStage fmt);
 size_t getFormatBlockSize(ImageFormat format);
+size_t getVertexFormatSize(VertexFormat format);
 PixelFormat getImagePixelFormat(ImageFormat format);
 
 }
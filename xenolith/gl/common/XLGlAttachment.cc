@@ -547,31 +547,45 @@ bool SwapchainAttachment::init(StringView str, const ImageInfo &info, Attachment
 	return false;
 }
 
+bool SwapchainAttachment::isOwner(const gl::FrameHandle &frame) const {
+	auto it = _owners.find(frame.getSwapchain());
+	if (it != _owners.end()) {
+		return it->second.owner.get() == &frame;
+	}
+	return false;
+}
+
 bool SwapchainAttachment::acquireForFrame(gl::FrameHandle &frame) {
-	if (_owner) {
-		if (_next) {
-			_next->invalidate();
+	auto &it = _owners[frame.getSwapchain()];
+	if (it.owner) {
+		if (it.next) {
+			it.next->invalidate();
 		}
-		_next = &frame;
+		it.next = &frame;
 		return false;
 	} else {
-		_owner = &frame;
+		it.owner = &frame;
 		return true;
 	}
 }
 
 bool SwapchainAttachment::releaseForFrame(gl::FrameHandle &frame) {
-	if (_owner.get() == &frame) {
-		if (_next) {
-			_owner = move(_next);
-			_next = nullptr;
-			_owner->getLoop()->pushEvent(gl::Loop::EventName::FrameUpdate, _owner);
+	auto it = _owners.find(frame.getSwapchain());
+	if (it == _owners.end()) {
+		return false;
+	}
+
+	if (it->second.owner.get() == &frame) {
+		if (it->second.next) {
+			it->second.owner = move(it->second.next);
+			it->second.next = nullptr;
+			it->second.owner->getLoop()->pushEvent(gl::Loop::EventName::FrameUpdate, it->second.owner);
 		} else {
-			_owner = nullptr;
+			_owners.erase(it);
 		}
 		return true;
-	} else if (_next.get() == &frame) {
-		_next = nullptr;
+	} else if (it->second.next.get() == &frame) {
+		it->second.next = nullptr;
 		return true;
 	}
 	return false;
@@ -43,6 +43,7 @@ class ImageAttachmentDescriptor;
 class ImageAttachmentRef;
 
 class FrameHandle;
+class Swapchain;
 
 class AttachmentHandle;
 
@@ -317,15 +318,20 @@ public:
 	virtual bool init(StringView, const ImageInfo &, AttachmentLayout init = AttachmentLayout::Ignored,
 			AttachmentLayout fin = AttachmentLayout::Ignored, bool clear = true);
 
-	const Rc<gl::FrameHandle> &getOwner() const { return _owner; }
+	// owning frame is tracked per swapchain, one attachment can be presented on several swapchains
+	bool isOwner(const gl::FrameHandle &) const;
 	bool acquireForFrame(gl::FrameHandle &);
 	bool releaseForFrame(gl::FrameHandle &);
 
 protected:
+	struct FrameOwner {
+		Rc<gl::FrameHandle> owner;
+		Rc<gl::FrameHandle> next;
+	};
+
 	virtual Rc<AttachmentDescriptor> makeDescriptor(RenderPassData *) override;
 
-	Rc<gl::FrameHandle> _owner;
-	Rc<gl::FrameHandle> _next;
+	Map<const Swapchain *, FrameOwner> _owners;
 };
 
 class SwapchainAttachmentDescriptor : public ImageAttachmentDescriptor {
@@ -30,6 +30,7 @@ Command *Command::create(memory::pool_t *p, CommandType t) {
 	switch (t) {
 	case CommandType::CommandGroup: break;
 	case CommandType::VertexArray: break;
+	case CommandType::QuadInstance: break;
 	}
 
 	auto bytes = memory::pool::palloc(p, commandSize);
@@ -43,6 +44,9 @@ Command *Command::create(memory::pool_t *p, CommandType t) {
 	case CommandType::VertexArray:
 		c->data = new ( memory::pool::palloc(p, sizeof(CmdVertexArray)) ) CmdVertexArray;
 		break;
+	case CommandType::QuadInstance:
+		c->data = new ( memory::pool::palloc(p, sizeof(CmdQuadInstance)) ) CmdQuadInstance;
+		break;
 	}
 	return c;
 }
@@ -65,6 +69,72 @@ void CommandList::pushVertexArray(const Rc<VertexData> &vert, const Mat4 &t, Spa
 	});
 }
 
+void CommandList::pushQuadInstance(const Mat4 &t, const Size &size, const Vec4 &texCoords, const Color4F &color,
+		SpanView<int16_t> zPath, gl::MaterialId material) {
+	_pool->perform([&] {
+		auto cmd = Command::create(_pool->getPool(), CommandType::QuadInstance);
+		auto cmdData = (CmdQuadInstance *)cmd->data;
+		cmdData->transform = t;
+		cmdData->size = size;
+		cmdData->texCoords = texCoords;
+		cmdData->color = color;
+		cmdData->zPath = zPath.pdup(_pool->getPool());
+		cmdData->material = material;
+
+		addCommand(cmd);
+	});
+}
+
+void CommandList::append(Rc<CommandList> &&list) {
+	if (list->_fullDamage) {
+		setFullDamage();
+	} else {
+		addDamage(list->_damage);
+	}
+
+	if (!list->_first) {
+		return;
+	}
+
+	if (!_last) {
+		_first = list->_first;
+	} else {
+		_last->next = list->_first;
+	}
+	_last = list->_last;
+
+	list->_first = nullptr;
+	list->_last = nullptr;
+	_segments.emplace_back(move(list));
+}
+
+void CommandList::addDamage(const Rect &rect) {
+	if (_fullDamage || rect.size.width <= 0.0f || rect.size.height <= 0.0f) {
+		return;
+	}
+
+	if (_damage.size.width <= 0.0f || _damage.size.height <= 0.0f) {
+		_damage = rect;
+		return;
+	}
+
+	auto minX = std::min(_damage.origin.x, rect.origin.x);
+	auto minY = std::min(_damage.origin.y, rect.origin.y);
+	auto maxX = std::max(_damage.origin.x + _damage.size.width, rect.origin.x + rect.size.width);
+	auto maxY = std::max(_damage.origin.y + _damage.size.height, rect.origin.y + rect.size.height);
+	_damage = Rect(minX, minY, maxX - minX, maxY - minY);
+}
+
+void CommandList::clearDamage() {
+	_damage = Rect();
+	_fullDamage = false;
+}
+
+void CommandList::setFullDamage() {
+	_damage = Rect();
+	_fullDamage = true;
+}
+
 void CommandList::addCommand(Command *cmd) {
 	if (!_last) {
 		_first = cmd;
@@ -30,6 +30,7 @@ namespace stappler::xenolith::gl {
 enum class CommandType {
 	CommandGroup,
 	VertexArray,
+	QuadInstance,
 };
 
 struct CmdVertexArray {
@@ -39,6 +40,16 @@ struct CmdVertexArray {
 	SpanView<int16_t> zPath;
 };
 
+// textured quad, that can be drawn with shared unit quad and per-instance data
+struct CmdQuadInstance {
+	Mat4 transform = Mat4::IDENTITY;
+	gl::MaterialId material = 0;
+	Size size;
+	Vec4 texCoords; // left, top, right, bottom
+	Color4F color;
+	SpanView<int16_t> zPath;
+};
+
 struct Command {
 	static Command *create(memory::pool_t *, CommandType t);
 
@@ -52,16 +63,37 @@ public:
 	bool init(const Rc<PoolRef> &);
 
 	void pushVertexArray(const Rc<VertexData> &, const Mat4 &, SpanView<int16_t> zPath, gl::MaterialId material);
+	void pushQuadInstance(const Mat4 &, const Size &, const Vec4 &texCoords, const Color4F &,
+			SpanView<int16_t> zPath, gl::MaterialId material);
+
+	// move commands and damage from other list to the end of this list, other list's pool is retained
+	void append(Rc<CommandList> &&);
+
+	// damage is area in root space (normalized device coordinates for scene), changed since previous list,
+	// new list is fully damaged, producer, that tracks changes, should clear damage before recording
+	void addDamage(const Rect &);
+	void clearDamage();
+	void setFullDamage();
+
+	const Rect &getDamage() const { return _damage; }
+	bool isFullDamage() const { return _fullDamage; }
 
 	const Command *getFirst() const { return _first; }
 	const Command *getLast() const { return _last; }
 
+	const Rc<PoolRef> &getPool() const { return _pool; }
+
 protected:
 	void addCommand(Command *);
 
 	Rc<PoolRef> _pool;
 	Command *_first = nullptr;
 	Command *_last = nullptr;
+
+	Rect _damage;
+	bool _fullDamage = true;
+
+	Vector<Rc<CommandList>> _segments;
 };
 
 }
@@ -73,6 +73,10 @@ public:
 	virtual gl::ImageData getEmptyImage() const = 0;
 	virtual gl::ImageData getSolidImage() const = 0;
 
+	// input-to-completion latency for offscreen frames, in microseconds
+	void addInputLatency(uint64_t v) { _inputLatency.add(v); }
+	LatencyHistogram::Stat getInputLatencyStat(bool reset = false) { return _inputLatency.getStat(reset); }
+
 protected:
 	friend class Loop;
 
@@ -99,6 +103,8 @@ protected:
 	uint32_t _samplersCount = 0;
 	bool _samplersCompiled = false;
 	uint32_t _textureLayoutImagesCount = 0;
+
+	LatencyHistogram _inputLatency;
 };
 
 }
@@ -660,6 +660,13 @@ enum class MaterialType {
 	Basic3D
 };
 
+// layout of vertex data within vertex storage buffer, shaders should be selected to match it
+enum class VertexFormat {
+	V4F_V4F_T2F2U, // Vertex_V4F_V4F_T2F2U, 48 bytes
+	V2F_C4B_T2H_2U, // Vertex_V2F_C4B_T2H_2U, 24 bytes, 2D only
+	V3F_C4B_T2H_2U, // Vertex_V3F_C4B_T2H_2U, 28 bytes
+};
+
 }
 
 #endif /* XENOLITH_GL_COMMON_XLGLENUM_H_ */
@@ -51,6 +51,7 @@ bool FrameHandle::init(Loop &loop, Swapchain &swapchain, RenderQueue &queue, uin
 	_device = loop.getDevice();
 	_swapchain = &swapchain;
 	_queue = &queue;
+	_timeStart = platform::device::_clock();
 	_gen = gen;
 	_readyForSubmit = readyForSubmit;
 	return setup();
@@ -64,6 +65,7 @@ bool FrameHandle::init(Loop &loop, RenderQueue &queue, uint64_t order, uint32_t
 	_device = loop.getDevice();
 	_swapchain = nullptr;
 	_queue = &queue;
+	_timeStart = platform::device::_clock();
 	_gen = gen;
 	_readyForSubmit = true;
 	return setup();
@@ -365,6 +367,12 @@ void FrameHandle::setCompleteCallback(Function<void(FrameHandle &)> &&cb) {
 	_complete = move(cb);
 }
 
+void FrameHandle::setInputTime(uint64_t t) {
+	if (t && (!_inputTime || t < _inputTime)) {
+		_inputTime = t;
+	}
+}
+
 bool FrameHandle::setup() {
 	_pool = Rc<PoolRef>::alloc(nullptr);
 	_requiredRenderPasses.reserve(_queue->getPasses().size());
@@ -475,6 +483,10 @@ void FrameHandle::onRequiredTaskCompleted(StringView tag) {
 void FrameHandle::onComplete() {
 	if (!_completed) {
 		_completed = true;
+		if (_inputTime && !_swapchain && _valid) {
+			// offscreen frame: input is visible when frame is completed
+			_device->addInputLatency(platform::device::_clock() - _inputTime);
+		}
 		if (_complete) {
 			_complete(*this);
 		}
@@ -89,6 +89,16 @@ public:
 
 	virtual void setCompleteCallback(Function<void(FrameHandle &)> &&);
 
+	// arrival time of earliest input event, consumed by this frame; should be set before input is submitted
+	void setInputTime(uint64_t);
+	uint64_t getInputTime() const { return _inputTime; }
+
+	uint64_t getTimeStart() const { return _timeStart; }
+
+	// vblank, that frame was paced to hit, or 0 if frame was not paced
+	void setTargetTime(uint64_t t) { _targetTime = t; }
+	uint64_t getTargetTime() const { return _targetTime; }
+
 protected:
 	virtual bool setup();
 	virtual void releaseResources();
@@ -105,6 +115,9 @@ protected:
 
 	uint64_t _order = 0;
 	uint32_t _gen = 0;
+	uint64_t _inputTime = 0;
+	uint64_t _timeStart = 0;
+	uint64_t _targetTime = 0;
 	uint32_t _inputSubmitted = 0;
 	std::atomic<uint32_t> _tasksRequired = 0;
 	uint32_t _tasksCompleted = 0;
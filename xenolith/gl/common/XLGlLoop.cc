@@ -185,21 +185,21 @@ bool Loop::worker() {
 						if (s->isResetRequired()) {
 							pushEvent(EventName::SwapChainForceRecreate, s);
 						} else if (s->isValid()) {
-							auto frameInterval = s->getFrameInterval();
-							if (frameInterval == 0) {
+							if (s->getFrameInterval() == 0) {
 								s->beginFrame(*this);
 							} else {
 								if (now == 0) {
 									now = platform::device::_clock();
 								}
-								auto timeFromFrame = (now - s->getFrameTime());
-								if (timeFromFrame >= frameInterval) {
+								// start frame as late as possible to meet next vblank
+								auto delay = s->getFrameDelay(now);
+								if (delay == 0) {
 									s->beginFrame(*this);
 								} else {
 									schedule([this, s = it->data] (Context &context) {
 										context.events->emplace_back(EventName::FrameTimeoutPassed, s.get(), data::Value());
 										return true;
-									}, frameInterval - timeFromFrame);
+									}, delay);
 								}
 							}
 						}
@@ -222,6 +222,26 @@ bool Loop::worker() {
 						log::text("gl::Loop", "Event::UpdateFrameInterval without swapchain");
 					}
 					break;
+				case EventName::UpdatePresentMode:
+					if (auto s = (Swapchain *)it->data.get()) {
+						s->setPreferredPresentMode(PresentMode(it->value.getInteger()));
+						if (!s->isBestPresentMode()) {
+							invalidateSwapchain(s, AppEvent::SwapchainRecreationBest);
+						}
+					} else {
+						log::text("gl::Loop", "Event::UpdatePresentMode without swapchain");
+					}
+					break;
+				case EventName::UpdateBenchmarkMode:
+					if (auto s = (Swapchain *)it->data.get()) {
+						s->setBenchmarkMode(it->value.getBool());
+						if (!s->isBestPresentMode()) {
+							invalidateSwapchain(s, AppEvent::SwapchainRecreationBest);
+						}
+					} else {
+						log::text("gl::Loop", "Event::UpdateBenchmarkMode without swapchain");
+					}
+					break;
 				case EventName::CompileResource:
 					_device->compileResource(*_queue, it->data.cast<Resource>());
 					break;
@@ -364,6 +384,14 @@ void Loop::setInterval(const Rc<Swapchain> &ref, uint64_t iv) {
 	pushEvent(EventName::UpdateFrameInterval, ref.get(), data::Value(iv));
 }
 
+void Loop::setPresentMode(const Rc<Swapchain> &ref, PresentMode mode) {
+	pushEvent(EventName::UpdatePresentMode, ref.get(), data::Value(toInt(mode)));
+}
+
+void Loop::setBenchmarkMode(const Rc<Swapchain> &ref, bool value) {
+	pushEvent(EventName::UpdateBenchmarkMode, ref.get(), data::Value(value));
+}
+
 bool Loop::isOnThread() const {
 	return std::this_thread::get_id() == _thread.get_id();
 }
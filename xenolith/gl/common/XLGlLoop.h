@@ -43,6 +43,8 @@ public:
 		FrameSubmitted,
 		FrameTimeoutPassed,
 		UpdateFrameInterval, // view wants us to update frame interval
+		UpdatePresentMode, // view wants us to switch present mode
+		UpdateBenchmarkMode, // view wants us to enable or disable benchmark mode
 		CompileResource,
 		CompileMaterials,
 		Exit,
@@ -99,6 +101,10 @@ public:
 
 	void setInterval(const Rc<Swapchain> &, uint64_t iv);
 
+	// swapchain is recreated without waiting for device, if mode is changed
+	void setPresentMode(const Rc<Swapchain> &, PresentMode);
+	void setBenchmarkMode(const Rc<Swapchain> &, bool);
+
 	void recreateSwapChain(const Rc<Swapchain> &ref) {
 		pushEvent(EventName::SwapChainDeprecated, ref.get(), data::Value());
 	}
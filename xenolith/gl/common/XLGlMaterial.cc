@@ -347,6 +347,9 @@ void MaterialAttachment::setMaterials(const Rc<gl::MaterialSet> &data) const {
 	if (tmp) {
 		tmp->clear();
 	}
+
+	// compiled materials can be used with next frame
+	markSceneDirty();
 }
 
 Rc<gl::MaterialSet> MaterialAttachment::allocateSet(const Device &dev) const {
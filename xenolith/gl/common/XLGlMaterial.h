@@ -145,6 +145,7 @@ public:
 	void setMaterials(const Rc<gl::MaterialSet> &) const;
 
 	MaterialType getType() const { return _type; }
+	uint32_t getMaterialObjectSize() const { return _materialObjectSize; }
 
 	const Vector<Rc<Material>> &getInitialMaterials() const { return _initialMaterials; }
 
@@ -45,10 +45,14 @@ Rc<RenderPassHandle> RenderPass::makeFrameHandle(RenderPassData *data, const Fra
 
 bool RenderPass::acquireForFrame(gl::FrameHandle &frame) {
 	if (_owner) {
-		if (_next) {
-			_next->invalidate();
+		for (auto &it : _next) {
+			if (it->getSwapchain() == frame.getSwapchain()) {
+				it->invalidate();
+				it = &frame;
+				return false;
+			}
 		}
-		_next = &frame;
+		_next.emplace_back(&frame);
 		return false;
 	} else {
 		_owner = &frame;
@@ -58,17 +62,20 @@ bool RenderPass::acquireForFrame(gl::FrameHandle &frame) {
 
 bool RenderPass::releaseForFrame(gl::FrameHandle &frame) {
 	if (_owner.get() == &frame) {
-		if (_next) {
-			_owner = move(_next);
-			_next = nullptr;
+		if (!_next.empty()) {
+			_owner = move(_next.front());
+			_next.erase(_next.begin());
 			_owner->getLoop()->pushEvent(Loop::EventName::FrameUpdate, _owner);
 		} else {
 			_owner = nullptr;
 		}
 		return true;
-	} else if (_next.get() == &frame) {
-		_next = nullptr;
-		return true;
+	} else {
+		auto it = std::find(_next.begin(), _next.end(), &frame);
+		if (it != _next.end()) {
+			_next.erase(it);
+			return true;
+		}
 	}
 	return false;
 }
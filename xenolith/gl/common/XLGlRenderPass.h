@@ -71,7 +71,9 @@ protected:
 	RenderOrdering _ordering = RenderOrderingLowest;
 
 	Rc<gl::FrameHandle> _owner;
-	Rc<gl::FrameHandle> _next;
+	// one pending frame per swapchain, passed to owner in order of acquisition,
+	// so, swapchains, that share queue, do not invalidate frames of each other
+	Vector<Rc<gl::FrameHandle>> _next;
 	const RenderPassData *_data = nullptr;
 };
 
@@ -38,6 +38,7 @@ struct RenderQueue::QueueData : NamedMem {
 	Function<void(gl::FrameHandle &)> endCallback;
 	Function<void(const Swapchain *)> enableCallback;
 	Function<void()> disableCallback;
+	std::atomic<uint32_t> swapchains = 0; // number of swapchains, driven by this queue
 	Rc<Resource> resource;
 	bool compiled = false;
 
@@ -47,7 +48,6 @@ struct RenderQueue::QueueData : NamedMem {
 		}
 
 		for (auto &it : passes) {
-			it->framebuffers.clear();
 			for (auto &desc : it->descriptors) {
 				desc->clear();
 			}
@@ -553,18 +553,40 @@ void RenderQueue::endFrame(gl::FrameHandle &frame) {
 	}
 }
 
-void RenderQueue::enable(const Swapchain *swapchain) {
-	if (_data->enableCallback) {
-		_data->enableCallback(swapchain);
+bool RenderQueue::enable(const Swapchain *swapchain) {
+	// swapchain images and framebuffers are owned by swapchains, so compiled queue can drive any number of them;
+	// callbacks are called for first enabled and last disabled swapchain
+	if (_data->swapchains.fetch_add(1) == 0) {
+		if (_data->enableCallback) {
+			_data->enableCallback(swapchain);
+		}
 	}
+	return true;
 }
 
 void RenderQueue::disable() {
-	if (_data->disableCallback) {
-		_data->disableCallback();
+	auto prev = _data->swapchains.load();
+	do {
+		if (prev == 0) {
+			return;
+		}
+	} while (!_data->swapchains.compare_exchange_weak(prev, prev - 1));
+
+	if (prev == 1) {
+		if (_data->disableCallback) {
+			_data->disableCallback();
+		}
 	}
 }
 
+bool RenderQueue::isEnabled() const {
+	return _data->swapchains.load() > 0;
+}
+
+uint32_t RenderQueue::getSwapchainsCount() const {
+	return _data->swapchains.load();
+}
+
 bool RenderQueue::usesSamplers() const {
 	for (auto &it : _data->passes) {
 		if (it->usesSamplers) {
@@ -98,7 +98,6 @@ struct RenderPassData : NamedMem {
 
 	Rc<RenderPass> renderPass;
 	Rc<RenderPassImpl> impl;
-	memory::vector<Rc<Framebuffer>> framebuffers;
 };
 
 class RenderQueue : public NamedRef {
@@ -145,9 +144,12 @@ public:
 	void beginFrame(gl::FrameHandle &);
 	void endFrame(gl::FrameHandle &);
 
-	void enable(const Swapchain *);
+	bool enable(const Swapchain *);
 	void disable();
 
+	bool isEnabled() const;
+	uint32_t getSwapchainsCount() const;
+
 	bool usesSamplers() const;
 
 protected:
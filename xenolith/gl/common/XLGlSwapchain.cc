@@ -36,8 +36,9 @@ Swapchain::~Swapchain() {
 bool Swapchain::init(const View *view, const Rc<RenderQueue> &queue) {
 	_view = view;
 	_renderQueue = queue;
-	if (_renderQueue) {
-		_renderQueue->enable(this);
+	if (_renderQueue && !_renderQueue->enable(this)) {
+		_renderQueue = nullptr;
+		return false;
 	}
 	return true;
 }
@@ -55,6 +56,11 @@ Rc<gl::FrameHandle> Swapchain::beginFrame(gl::Loop &loop, bool force) {
 		_frame = 0;
 	}
 
+	if (!force && !_benchmark && _idle.load()) {
+		scheduleIdleCheck(loop);
+		return nullptr;
+	}
+
 	if (!canStartFrame()) {
 		scheduleNextFrame();
 		if (force) {
@@ -64,8 +70,17 @@ Rc<gl::FrameHandle> Swapchain::beginFrame(gl::Loop &loop, bool force) {
 	}
 
 	_nextFrameScheduled = false;
+	_idleCheckInterval = 0;
 	auto frame = makeFrame(loop, _frames.empty());
 	if (frame && frame->isValidFlag()) {
+		if (_frameInterval) {
+			uint64_t target = 0;
+			getFrameDelay(platform::device::_clock(), &target);
+			frame->setTargetTime(target);
+
+			std::unique_lock<Mutex> lock(_pacingMutex);
+			_lastTarget = target;
+		}
 		_view->pushEvent(AppEvent::Update);
 		frame->update(true);
 		if (frame->isValidFlag()) {
@@ -99,6 +114,18 @@ void Swapchain::setFrameSubmitted(Rc<gl::FrameHandle> frame) {
 
 	++ _submitted;
 
+	if (_benchmark) {
+		auto t = platform::device::_clock();
+		++ _benchmarkStat.frames;
+		_benchmarkStat.time = t - _benchmarkStart;
+		if (t - _benchmarkReport >= config::BenchmarkReportInterval) {
+			_benchmarkStat.fps = float(_benchmarkStat.frames - _benchmarkReportFrames) * 1'000'000.0f / float(t - _benchmarkReport);
+			log::vtext("gl::Swapchain", "Benchmark: ", _benchmarkStat.fps, " fps (", getPresentModeName(getPresentMode()), ")");
+			_benchmarkReport = t;
+			_benchmarkReportFrames = _benchmarkStat.frames;
+		}
+	}
+
 	if (_nextFrameScheduled) {
 		frame->getLoop()->pushEvent(Loop::EventName::FrameTimeoutPassed, this);
 	}
@@ -139,6 +166,38 @@ void Swapchain::incrementGeneration(AppEvent::Value event) {
 	_submitted = 0;
 }
 
+void Swapchain::setIdle(bool value) {
+	if (_idle.exchange(value) && !value) {
+		// scene was changed, start frame without waiting for idle check
+		_view->getLoop()->pushEvent(Loop::EventName::Update, this);
+	}
+}
+
+void Swapchain::scheduleIdleCheck(gl::Loop &loop) {
+	if (_idleCheckScheduled) {
+		return;
+	}
+
+	// changes from main thread and input wake swapchain with setIdle, checks are only for changes,
+	// made without view update (from other threads), so, they are backed off
+	if (_idleCheckInterval) {
+		_idleCheckInterval = std::min(_idleCheckInterval * 2, config::IdleCheckMaxInterval);
+	} else {
+		_idleCheckInterval = _frameInterval ? _frameInterval : config::IdleCheckInterval;
+	}
+
+	_idleCheckScheduled = true;
+	_view->pushEvent(AppEvent::Update);
+	loop.schedule([this, s = Rc<Swapchain>(this)] (Loop::Context &context) {
+		_idleCheckScheduled = false;
+		// if swapchain was woken, frames are already started with Update event
+		if (_idle.load()) {
+			context.events->emplace_back(Loop::EventName::FrameTimeoutPassed, this, data::Value());
+		}
+		return true;
+	}, _idleCheckInterval);
+}
+
 bool Swapchain::isResetRequired() {
 	if (_suboptimal > 0) {
 		-- _suboptimal;
@@ -175,4 +234,119 @@ bool Swapchain::scheduleNextFrame() {
 	return prev;
 }
 
+void Swapchain::setBenchmarkMode(bool value) {
+	if (_benchmark == value) {
+		return;
+	}
+
+	_benchmark = value;
+	if (_benchmark) {
+		_benchmarkStart = _benchmarkReport = platform::device::_clock();
+		_benchmarkReportFrames = 0;
+		_benchmarkStat = BenchmarkStat();
+	} else {
+		log::vtext("gl::Swapchain", "Benchmark: ", _benchmarkStat.frames, " frames in ", _benchmarkStat.time, " mks");
+	}
+}
+
+uint64_t Swapchain::getFrameDelay(uint64_t now, uint64_t *target) const {
+	std::unique_lock<Mutex> lock(_pacingMutex);
+	if (target) {
+		*target = 0;
+	}
+
+	if (_lastVblank == 0 || _vblankInterval == 0) {
+		// no feedback from presentation engine, use requested frame interval
+		auto timeFromFrame = now - _frame;
+		return (timeFromFrame >= _frameInterval) ? 0 : _frameInterval - timeFromFrame;
+	}
+
+	auto interval = _vblankInterval;
+	auto ready = now + _frameCost + config::FramePacingMargin;
+
+	// first vblank after frame can be ready
+	auto next = _lastVblank + interval;
+	if (ready > next) {
+		next += ((ready - next + interval - 1) / interval) * interval;
+	}
+
+	// only one frame per vblank, and no more frequent, then requested frame interval
+	auto minTarget = _lastTarget + std::max(interval, _frameInterval) - interval / 2;
+	if (_lastTarget && next < minTarget) {
+		next += ((minTarget - next + interval - 1) / interval) * interval;
+	}
+
+	if (target) {
+		*target = next;
+	}
+
+	auto start = next - _frameCost - config::FramePacingMargin;
+	return (start > now) ? start - now : 0;
+}
+
+void Swapchain::addPresentFeedback(const FrameHandle &frame, uint64_t presentTime, bool precise) {
+	addPresentFeedback(frame.getTimeStart(), frame.getTargetTime(), presentTime, precise);
+}
+
+void Swapchain::addPresentFeedback(uint64_t timeStart, uint64_t targetTime, uint64_t presentTime, bool precise) {
+	std::unique_lock<Mutex> lock(_pacingMutex);
+	if (!precise && _precisePacing) {
+		return;
+	}
+
+	_precisePacing = _precisePacing || precise;
+
+	if (_lastVblank && presentTime > _lastVblank) {
+		// single sample can span several refresh cycles
+		auto dt = presentTime - _lastVblank;
+		auto interval = _vblankInterval ? _vblankInterval : _frameInterval;
+		auto cycles = interval ? std::max(uint64_t(1), (dt + interval / 2) / interval) : uint64_t(1);
+		auto sample = dt / cycles;
+		_vblankInterval = _vblankInterval ? (_vblankInterval * 7 + sample) / 8 : sample;
+	}
+
+	if (presentTime > _lastVblank) {
+		_lastVblank = presentTime;
+	}
+
+	if (targetTime) {
+		auto error = (presentTime > targetTime) ? presentTime - targetTime : targetTime - presentTime;
+		++ _pacingStat.frames;
+		_errorSum += error;
+		_pacingStat.errorMax = std::max(_pacingStat.errorMax, error);
+		if (presentTime > targetTime + _vblankInterval / 2) {
+			++ _pacingStat.missed;
+		}
+	}
+}
+
+void Swapchain::addFrameCost(uint64_t cost) {
+	std::unique_lock<Mutex> lock(_pacingMutex);
+	// react to spikes immediately, decay slowly
+	if (cost > _frameCost) {
+		_frameCost = cost;
+	} else {
+		_frameCost = (_frameCost * 15 + cost) / 16;
+	}
+}
+
+void Swapchain::setVblankInterval(uint64_t value) {
+	std::unique_lock<Mutex> lock(_pacingMutex);
+	_vblankInterval = value;
+}
+
+Swapchain::PacingStat Swapchain::getPacingStat(bool reset) {
+	std::unique_lock<Mutex> lock(_pacingMutex);
+	auto ret = _pacingStat;
+	ret.errorAvg = ret.frames ? _errorSum / ret.frames : 0;
+	ret.frameCost = _frameCost;
+	ret.vblankInterval = _vblankInterval;
+	ret.precise = _precisePacing;
+	if (reset) {
+		_pacingStat = PacingStat();
+		_errorSum = 0;
+	}
+	return ret;
+}
+
 }
@@ -29,6 +29,22 @@ namespace stappler::xenolith::gl {
 
 class Swapchain : public Ref {
 public:
+	struct PacingStat {
+		uint32_t frames = 0; // paced frames with present feedback
+		uint32_t missed = 0; // frames, displayed on later vblank, then targeted
+		uint64_t errorAvg = 0; // microseconds, average distance between targeted and actual present
+		uint64_t errorMax = 0;
+		uint64_t frameCost = 0; // predicted CPU+GPU frame cost, microseconds
+		uint64_t vblankInterval = 0; // measured display refresh interval, microseconds
+		bool precise = false; // feedback from actual presentation, not estimated from image acquisition
+	};
+
+	struct BenchmarkStat {
+		uint64_t frames = 0; // frames, submitted since benchmark mode was enabled
+		uint64_t time = 0; // microseconds since benchmark mode was enabled
+		float fps = 0.0f; // for last report interval
+	};
+
 	virtual ~Swapchain();
 
 	virtual bool init(const View *, const Rc<RenderQueue> &);
@@ -48,21 +64,59 @@ public:
 
 	virtual bool isBestPresentMode() const { return true; }
 
+	virtual PresentMode getPresentMode() const { return PresentMode::Unsupported; }
+
+	// present mode, that should be used on next swapchain recreation, if supported by surface;
+	// Unsupported means engine's default choice; should be called from GL thread (see Loop::setPresentMode)
+	void setPreferredPresentMode(PresentMode mode) { _preferredPresentMode = mode; }
+	PresentMode getPreferredPresentMode() const { return _preferredPresentMode; }
+
+	// uncapped frames with fastest available present mode, frame rate is reported to log;
+	// should be called from GL thread (see Loop::setBenchmarkMode)
+	void setBenchmarkMode(bool);
+	bool isBenchmarkMode() const { return _benchmark; }
+	BenchmarkStat getBenchmarkStat() const { return _benchmarkStat; }
+
 	virtual bool isResetRequired();
 
+	// while idle, new frames are not started and previous image remains on screen, view is still updated
+	// to detect changes, with interval, that grows while scene is not changed; can be called from any thread
+	void setIdle(bool);
+	bool isIdle() const { return _idle.load(); }
+
 	bool isValid() const { return _valid; }
 
 	void setFrameTime(uint64_t v) { _frame = v; }
 	uint64_t getFrameTime() const { return _frame; }
 
 	void setFrameInterval(uint64_t v) { _frameInterval = v; }
-	uint64_t getFrameInterval() const { return _frameInterval; }
+	uint64_t getFrameInterval() const { return _benchmark ? 0 : _frameInterval; }
+
+	// input-to-present latency, in microseconds; can be called from any thread
+	void addInputLatency(uint64_t v) { _inputLatency.add(v); }
+	LatencyHistogram::Stat getInputLatencyStat(bool reset = false) { return _inputLatency.getStat(reset); }
+
+	// delay before next frame should be started to meet next vblank as late as possible;
+	// target receives predicted vblank for that frame or 0, if there is no feedback for pacing
+	uint64_t getFrameDelay(uint64_t now, uint64_t *target = nullptr) const;
+
+	// feedback from presentation engine, can be called from any thread;
+	// precise feedback (present wait, display timing) disables estimation from image acquisition
+	void addPresentFeedback(const FrameHandle &, uint64_t presentTime, bool precise);
+	void addPresentFeedback(uint64_t timeStart, uint64_t targetTime, uint64_t presentTime, bool precise);
+	void addFrameCost(uint64_t);
+	void setVblankInterval(uint64_t);
+
+	PacingStat getPacingStat(bool reset = false);
 
 protected:
 	virtual Rc<FrameHandle> makeFrame(gl::Loop &, bool readyForSubmit) = 0;
 	virtual bool canStartFrame() const;
 	virtual bool scheduleNextFrame();
 
+	// update view to detect changes, and check idle state again after idle check interval
+	virtual void scheduleIdleCheck(gl::Loop &);
+
 	uint64_t _order = 0;
 	uint64_t _submitted = 0;
 	uint64_t _gen = 0;
@@ -75,10 +129,32 @@ protected:
 	bool _nextFrameScheduled = false;
 	std::deque<Rc<FrameHandle>> _frames;
 
+	std::atomic<bool> _idle = false;
+	bool _idleCheckScheduled = false;
+	uint64_t _idleCheckInterval = 0; // 0 if frame was started after last idle check
+
 	Device *_device = nullptr;
 	const View *_view = nullptr;
 	Rc<gl::RenderQueue> _renderQueue;
 	Rc<gl::RenderQueue> _nextRenderQueue; // will be updated on reset
+
+	LatencyHistogram _inputLatency;
+
+	PresentMode _preferredPresentMode = PresentMode::Unsupported;
+	bool _benchmark = false;
+	uint64_t _benchmarkStart = 0;
+	uint64_t _benchmarkReport = 0;
+	uint64_t _benchmarkReportFrames = 0;
+	BenchmarkStat _benchmarkStat;
+
+	mutable Mutex _pacingMutex;
+	uint64_t _lastVblank = 0;
+	uint64_t _lastTarget = 0;
+	uint64_t _vblankInterval = 0;
+	uint64_t _frameCost = 0;
+	uint64_t _errorSum = 0;
+	bool _precisePacing = false;
+	PacingStat _pacingStat;
 };
 
 }
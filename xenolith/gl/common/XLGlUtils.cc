@@ -1141,4 +1141,74 @@ PixelFormat getImagePixelFormat(ImageFormat format) {
 	return PixelFormat::Unknown;
 }
 
+size_t getVertexFormatSize(VertexFormat format) {
+	switch (format) {
+	case VertexFormat::V4F_V4F_T2F2U: return sizeof(Vertex_V4F_V4F_T2F2U); break;
+	case VertexFormat::V2F_C4B_T2H_2U: return sizeof(Vertex_V2F_C4B_T2H_2U); break;
+	case VertexFormat::V3F_C4B_T2H_2U: return sizeof(Vertex_V3F_C4B_T2H_2U); break;
+	}
+	return 0;
+}
+
+StringView getPresentModeName(PresentMode mode) {
+	switch (mode) {
+	case PresentMode::Unsupported: return StringView("Unsupported"); break;
+	case PresentMode::Immediate: return StringView("Immediate"); break;
+	case PresentMode::FifoRelaxed: return StringView("FifoRelaxed"); break;
+	case PresentMode::Fifo: return StringView("Fifo"); break;
+	case PresentMode::Mailbox: return StringView("Mailbox"); break;
+	}
+	return StringView("Unknown");
+}
+
+LatencyHistogram::LatencyHistogram() {
+	_buckets.resize(config::LatencyHistogramBuckets, 0);
+}
+
+void LatencyHistogram::add(uint64_t value) {
+	std::unique_lock<Mutex> lock(_mutex);
+	auto idx = std::min(size_t(value / config::LatencyHistogramBucketInterval), _buckets.size() - 1);
+	++ _buckets[idx];
+	++ _count;
+	_max = std::max(_max, value);
+}
+
+void LatencyHistogram::clear() {
+	std::unique_lock<Mutex> lock(_mutex);
+	std::fill(_buckets.begin(), _buckets.end(), 0);
+	_count = 0;
+	_max = 0;
+}
+
+LatencyHistogram::Stat LatencyHistogram::getStat(bool reset) {
+	std::unique_lock<Mutex> lock(_mutex);
+	Stat ret;
+	ret.count = _count;
+	ret.max = _max;
+	if (_count > 0) {
+		ret.p50 = getPercentile(_count, 50);
+		ret.p95 = getPercentile(_count, 95);
+		ret.p99 = getPercentile(_count, 99);
+	}
+	if (reset) {
+		std::fill(_buckets.begin(), _buckets.end(), 0);
+		_count = 0;
+		_max = 0;
+	}
+	return ret;
+}
+
+uint64_t LatencyHistogram::getPercentile(uint32_t count, uint32_t percent) const {
+	// upper bound of bucket, that contains requested rank, clamped with exact maximum
+	auto rank = (uint64_t(count) * percent + 99) / 100;
+	uint64_t acc = 0;
+	for (size_t i = 0; i < _buckets.size(); ++ i) {
+		acc += _buckets[i];
+		if (acc >= rank) {
+			return std::min(uint64_t(i + 1) * config::LatencyHistogramBucketInterval, _max);
+		}
+	}
+	return _max;
+}
+
 }
@@ -22,6 +22,7 @@
 
 #include "XLGlView.h"
 #include "XLScene.h"
+#include "XLDirector.h"
 
 namespace stappler::xenolith::gl {
 
@@ -79,6 +80,18 @@ void View::reset(SwapchanCreationMode mode) {
 	_glLoop->pushEvent(Loop::EventName::SwapChainRecreated, _swapchain);
 }
 
+void View::setPresentMode(PresentMode mode) {
+	if (_swapchain) {
+		_glLoop->setPresentMode(_swapchain, mode);
+	}
+}
+
+void View::setBenchmarkMode(bool value) {
+	if (_swapchain) {
+		_glLoop->setBenchmarkMode(_swapchain, value);
+	}
+}
+
 void View::update() {
 	if (_director) {
 		_director->update();
@@ -109,6 +122,17 @@ void View::handleTouchesEnd(int num, intptr_t ids[], float xs[], float ys[]) { }
 
 void View::handleTouchesCancel(int num, intptr_t ids[], float xs[], float ys[]) { }
 
+void View::handleInputEvent(const InputEventData &event) {
+	if (_director) {
+		_director->pushInputEvent(event);
+
+		// idle swapchain does not update view with frame interval, so, input is processed on request
+		if (_swapchain && _swapchain->isIdle()) {
+			pushEvent(AppEvent::Update);
+		}
+	}
+}
+
 void View::enableOffscreenContext() { }
 
 void View::disableOffscreenContext() { }
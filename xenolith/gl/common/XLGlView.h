@@ -60,6 +60,16 @@ public:
 	virtual bool poll() = 0; // poll for input
 	virtual void close() = 0;
 
+	const Rc<gl::Loop> &getLoop() const { return _glLoop; }
+	const Rc<Swapchain> &getSwapchain() const { return _swapchain; }
+	const Rc<Director> &getDirector() const { return _director; }
+
+	// switch present mode for view's swapchain; swapchain is recreated without device wait
+	virtual void setPresentMode(PresentMode);
+
+	// uncapped frames with fastest present mode, frame rate is reported to log
+	virtual void setBenchmarkMode(bool);
+
 	virtual void setCursorVisible(bool isVisible) { }
 
 	virtual int getDpi() const;
@@ -73,6 +83,9 @@ public:
 	virtual void handleTouchesEnd(int num, intptr_t ids[], float xs[], float ys[]);
 	virtual void handleTouchesCancel(int num, intptr_t ids[], float xs[], float ys[]);
 
+	// forward platform input event to Director, can be called from view's event thread
+	virtual void handleInputEvent(const InputEventData &);
+
 	virtual void enableOffscreenContext();
 	virtual void disableOffscreenContext();
 
@@ -48,5 +48,7 @@ THE SOFTWARE.
 #include "renderer/XLVkRenderPass.cc"
 #include "renderer/XLVkTransferAttachment.cc"
 #include "renderer/XLVkMaterialCompilationAttachment.cc"
+#include "renderer/XLVkVertexCache.cc"
+#include "renderer/XLVkVertexKernels.cc"
 #include "renderer/XLVkMaterialRenderPass.cc"
 #include "renderer/XLVkRenderQueueAttachment.cc"
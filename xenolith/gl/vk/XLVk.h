@@ -110,6 +110,22 @@ static const char * const s_optionalDeviceExtensions[] = {
 	VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
 	VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME,
 	VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME,
+
+	// actual present times for latency measurement
+#if defined(VK_GOOGLE_display_timing)
+	VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME,
+#endif
+
+	// present feedback for frame pacing
+#if defined(VK_KHR_present_wait)
+	VK_KHR_PRESENT_ID_EXTENSION_NAME,
+	VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
+#endif
+
+	// damage regions for partial redraw
+#if defined(VK_KHR_incremental_present)
+	VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME,
+#endif
 	nullptr
 };
 
@@ -126,6 +142,10 @@ enum class ExtensionFlags {
 	MemoryBudget = 1 << 8,
 	GetMemoryRequirements2 = 1 << 9,
 	DedicatedAllocation = 1 << 10,
+	DisplayTiming = 1 << 11,
+	PresentId = 1 << 12,
+	PresentWait = 1 << 13,
+	IncrementalPresent = 1 << 14,
 };
 
 SP_DEFINE_ENUM_AS_MASK(ExtensionFlags);
@@ -569,6 +589,9 @@ struct DeviceCallTable {
 	PFN_vkGetPipelineExecutablePropertiesKHR vkGetPipelineExecutablePropertiesKHR = nullptr;
 	PFN_vkGetPipelineExecutableStatisticsKHR vkGetPipelineExecutableStatisticsKHR = nullptr;
 #endif /* defined(VK_KHR_pipeline_executable_properties) */
+#if defined(VK_KHR_present_wait)
+	PFN_vkWaitForPresentKHR vkWaitForPresentKHR = nullptr;
+#endif /* defined(VK_KHR_present_wait) */
 #if defined(VK_KHR_push_descriptor)
 	PFN_vkCmdPushDescriptorSetKHR vkCmdPushDescriptorSetKHR = nullptr;
 #endif /* defined(VK_KHR_push_descriptor) */
@@ -598,6 +598,7 @@ void Device::runMaterialCompilationFrame(gl::Loop &loop, Rc<gl::MaterialInputDat
 	auto h = Rc<FrameHandle>::create(loop, *_materialQueue, _materialRenderPass->incrementOrder(), 0);
 	h->update(true);
 	h->setCompleteCallback([this, attachment] (gl::FrameHandle &handle) {
+		// publish compiled part of materials, so it can be used before whole request is compiled
 		for (auto &it : handle.getOutputAttachments()) {
 			if (auto r = dynamic_cast<MaterialCompilationAttachmentHandle *>(it.get())) {
 				attachment->setMaterials(r->getOutputSet());
@@ -622,12 +623,13 @@ void Device::compileMaterials(gl::Loop &loop, Rc<gl::MaterialInputData> &&req) {
 	if (_finished) {
 		return;
 	}
-	if (_materialRenderPass->inProgress(req->attachment)) {
-		_materialRenderPass->appendRequest(req->attachment, move(req->materials));
-	} else {
-		auto attachment = req->attachment;
+	// requests are always coalesced in queue, so, all pending materials for attachment
+	// will be compiled within single frame (or split between frames by budget)
+	auto attachment = req->attachment;
+	_materialRenderPass->appendRequest(attachment, move(req->materials));
+	if (!_materialRenderPass->inProgress(attachment)) {
 		_materialRenderPass->setInProgress(attachment);
-		runMaterialCompilationFrame(loop, move(req));
+		runMaterialCompilationFrame(loop, _materialRenderPass->popRequest(attachment));
 	}
 }
 
@@ -658,6 +660,16 @@ bool Device::setup(const Instance *instance, VkPhysicalDevice p, const Propertie
 		features.device12.pNext = nullptr;
 		features.device11.pNext = &features.device12;
 		features.device10.pNext = &features.device11;
+#if defined(VK_KHR_present_wait)
+		if ((features.flags & ExtensionFlags::PresentId) != ExtensionFlags::None) {
+			features.devicePresentId.pNext = features.device12.pNext;
+			features.device12.pNext = &features.devicePresentId;
+		}
+		if ((features.flags & ExtensionFlags::PresentWait) != ExtensionFlags::None) {
+			features.devicePresentWait.pNext = features.device12.pNext;
+			features.device12.pNext = &features.devicePresentWait;
+		}
+#endif
 		deviceCreateInfo.pNext = &features.device11;
 	} else {
 		void *next = nullptr;
@@ -681,6 +693,16 @@ bool Device::setup(const Instance *instance, VkPhysicalDevice p, const Propertie
 			features.deviceBufferDeviceAddress.pNext = next;
 			next = &features.deviceBufferDeviceAddress;
 		}
+#if defined(VK_KHR_present_wait)
+		if ((features.flags & ExtensionFlags::PresentId) != ExtensionFlags::None) {
+			features.devicePresentId.pNext = next;
+			next = &features.devicePresentId;
+		}
+		if ((features.flags & ExtensionFlags::PresentWait) != ExtensionFlags::None) {
+			features.devicePresentWait.pNext = next;
+			next = &features.devicePresentWait;
+		}
+#endif
 		deviceCreateInfo.pNext = next;
 	}
 	deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
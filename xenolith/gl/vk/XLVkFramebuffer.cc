@@ -24,18 +24,27 @@
 
 namespace stappler::xenolith::vk {
 
-bool Framebuffer::init(Device &dev, VkRenderPass renderPass, const Vector<VkImageView> &imageViews, Extent2 extent) {
+bool Framebuffer::init(Device &dev, VkRenderPass renderPass, Vector<Rc<ImageView>> &&views, Extent2 extent) {
+	Vector<VkImageView> vkViews;
+	vkViews.reserve(views.size());
+	for (auto &it : views) {
+		vkViews.emplace_back(it->getImageView());
+	}
+
 	VkFramebufferCreateInfo framebufferInfo { };
 	framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
 	framebufferInfo.renderPass = renderPass;
-	framebufferInfo.attachmentCount = imageViews.size();
-	framebufferInfo.pAttachments = imageViews.data();
+	framebufferInfo.attachmentCount = vkViews.size();
+	framebufferInfo.pAttachments = vkViews.data();
 	framebufferInfo.width = extent.width;
 	framebufferInfo.height = extent.height;
 	framebufferInfo.layers = 1;
 
 	if (dev.getTable()->vkCreateFramebuffer(dev.getDevice(), &framebufferInfo, nullptr, &_framebuffer) == VK_SUCCESS) {
 		_extent = extent;
+		for (auto &it : views) {
+			imageViews.emplace_back(it.get());
+		}
 		return gl::Object::init(dev, [] (gl::Device *dev, gl::ObjectType, void *ptr) {
 			auto d = ((Device *)dev);
 			d->getTable()->vkDestroyFramebuffer(d->getDevice(), (VkFramebuffer)ptr, nullptr);
@@ -31,7 +31,8 @@ class Framebuffer : public gl::Framebuffer {
 public:
 	virtual ~Framebuffer() { }
 
-	bool init(Device &dev, VkRenderPass renderPass, const Vector<VkImageView> &imageView, Extent2 extent);
+	// framebuffer retains image views, so views and images stays alive while framebuffer is used by frames
+	bool init(Device &dev, VkRenderPass renderPass, Vector<Rc<ImageView>> &&imageViews, Extent2 extent);
 
 	VkFramebuffer getFramebuffer() const { return _framebuffer; }
 	const Extent2 &getExtent() const { return _extent; }
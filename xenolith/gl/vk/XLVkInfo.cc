@@ -37,6 +37,10 @@ DeviceInfo::Features DeviceInfo::Features::getOptional() {
 	ret.device10.features.shaderStorageImageArrayDynamicIndexing = VK_TRUE;
 	ret.device10.features.shaderUniformBufferArrayDynamicIndexing = VK_TRUE;
 	ret.device10.features.multiDrawIndirect = VK_TRUE;
+#if defined(VK_KHR_present_wait)
+	ret.devicePresentId.presentId = VK_TRUE;
+	ret.devicePresentWait.presentWait = VK_TRUE;
+#endif
 	ret.device10.features.shaderFloat64 = VK_TRUE;
 	ret.device10.features.shaderInt64 = VK_TRUE;
 	ret.device10.features.shaderInt16 = VK_TRUE;
@@ -189,6 +193,16 @@ void DeviceInfo::Features::enableFromFeatures(const Features &features) {
 	doCheck(
 			SP_VK_BOOL_ARRAY(deviceShaderFloat16Int8, shaderFloat16, VkPhysicalDeviceShaderFloat16Int8FeaturesKHR),
 			SP_VK_BOOL_ARRAY(features.deviceShaderFloat16Int8, shaderFloat16, VkPhysicalDeviceShaderFloat16Int8FeaturesKHR));
+
+#if defined(VK_KHR_present_wait)
+	doCheck(
+			SP_VK_BOOL_ARRAY(devicePresentId, presentId, VkPhysicalDevicePresentIdFeaturesKHR),
+			SP_VK_BOOL_ARRAY(features.devicePresentId, presentId, VkPhysicalDevicePresentIdFeaturesKHR));
+
+	doCheck(
+			SP_VK_BOOL_ARRAY(devicePresentWait, presentWait, VkPhysicalDevicePresentWaitFeaturesKHR),
+			SP_VK_BOOL_ARRAY(features.devicePresentWait, presentWait, VkPhysicalDevicePresentWaitFeaturesKHR));
+#endif
 #undef SP_VK_BOOL_ARRAY
 }
 
@@ -237,6 +251,16 @@ void DeviceInfo::Features::disableFromFeatures(const Features &features) {
 	doCheck(
 			SP_VK_BOOL_ARRAY(deviceShaderFloat16Int8, shaderFloat16, VkPhysicalDeviceShaderFloat16Int8FeaturesKHR),
 			SP_VK_BOOL_ARRAY(features.deviceShaderFloat16Int8, shaderFloat16, VkPhysicalDeviceShaderFloat16Int8FeaturesKHR));
+
+#if defined(VK_KHR_present_wait)
+	doCheck(
+			SP_VK_BOOL_ARRAY(devicePresentId, presentId, VkPhysicalDevicePresentIdFeaturesKHR),
+			SP_VK_BOOL_ARRAY(features.devicePresentId, presentId, VkPhysicalDevicePresentIdFeaturesKHR));
+
+	doCheck(
+			SP_VK_BOOL_ARRAY(devicePresentWait, presentWait, VkPhysicalDevicePresentWaitFeaturesKHR),
+			SP_VK_BOOL_ARRAY(features.devicePresentWait, presentWait, VkPhysicalDevicePresentWaitFeaturesKHR));
+#endif
 #undef SP_VK_BOOL_ARRAY
 }
 
@@ -617,6 +617,16 @@ void Instance::getDeviceFeatures(const VkPhysicalDevice &device, DeviceInfo::Fea
 		features.device12.pNext = nullptr;
 		features.device11.pNext = &features.device12;
 		features.device10.pNext = &features.device11;
+#if defined(VK_KHR_present_wait)
+		if ((flags & ExtensionFlags::PresentId) != ExtensionFlags::None) {
+			features.devicePresentId.pNext = features.device12.pNext;
+			features.device12.pNext = &features.devicePresentId;
+		}
+		if ((flags & ExtensionFlags::PresentWait) != ExtensionFlags::None) {
+			features.devicePresentWait.pNext = features.device12.pNext;
+			features.device12.pNext = &features.devicePresentWait;
+		}
+#endif
 
 		if (vkGetPhysicalDeviceFeatures2) {
 			vkGetPhysicalDeviceFeatures2(device, &features.device10);
@@ -651,6 +661,16 @@ void Instance::getDeviceFeatures(const VkPhysicalDevice &device, DeviceInfo::Fea
 			features.deviceBufferDeviceAddress.pNext = next;
 			next = &features.deviceBufferDeviceAddress;
 		}
+#if defined(VK_KHR_present_wait)
+		if ((flags & ExtensionFlags::PresentId) != ExtensionFlags::None) {
+			features.devicePresentId.pNext = next;
+			next = &features.devicePresentId;
+		}
+		if ((flags & ExtensionFlags::PresentWait) != ExtensionFlags::None) {
+			features.devicePresentWait.pNext = next;
+			next = &features.devicePresentWait;
+		}
+#endif
 		features.device10.pNext = next;
 
 		if (vkGetPhysicalDeviceFeatures2) {
@@ -34,6 +34,10 @@ bool RenderPassImpl::PassData::cleanup(Device &dev) {
 		dev.getTable()->vkDestroyRenderPass(dev.getDevice(), renderPass, nullptr);
 	}
 
+	if (renderPassLoad) {
+		dev.getTable()->vkDestroyRenderPass(dev.getDevice(), renderPassLoad, nullptr);
+	}
+
 	if (layout) {
 		dev.getTable()->vkDestroyPipelineLayout(dev.getDevice(), layout, nullptr);
 	}
@@ -237,6 +241,34 @@ bool RenderPassImpl::initGraphicsPass(Device &dev, gl::RenderPassData &data) {
 		return pass.cleanup(dev);
 	}
 
+	// render passes, that differ only in load op and initial layout, are compatible,
+	// so load variant uses same framebuffers and pipelines
+	if (!data.subpasses.empty()) {
+		auto &outputs = data.subpasses.front().outputImages;
+		for (size_t i = 0; i < outputs.size(); ++ i) {
+			if (!outputs[i] || outputs[i]->getAttachment()->getType() != gl::AttachmentType::SwapchainImage) {
+				continue;
+			}
+
+			auto idx = outputs[i]->getDescriptor()->getIndex();
+			if (_attachmentDescriptions[idx].finalLayout != VK_IMAGE_LAYOUT_PRESENT_SRC_KHR) {
+				break;
+			}
+
+			auto descriptions = _attachmentDescriptions;
+			descriptions[idx].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+			descriptions[idx].initialLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+			renderPassInfo.pAttachments = descriptions.data();
+			if (dev.getTable()->vkCreateRenderPass(dev.getDevice(), &renderPassInfo, nullptr, &pass.renderPassLoad) != VK_SUCCESS) {
+				pass.renderPassLoad = VK_NULL_HANDLE;
+			}
+			renderPassInfo.pAttachments = _attachmentDescriptions.data();
+			pass.loadColorAttachment = uint32_t(i);
+			break;
+		}
+	}
+
 	if (initDescriptors(dev, data, pass)) {
 		auto l = new PassData(move(pass));
 		_data = l;
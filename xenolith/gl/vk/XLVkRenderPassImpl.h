@@ -34,6 +34,8 @@ public:
 	struct PassData {
 		VkPipelineLayout layout = VK_NULL_HANDLE;
 		VkRenderPass renderPass = VK_NULL_HANDLE;
+		VkRenderPass renderPassLoad = VK_NULL_HANDLE;
+		uint32_t loadColorAttachment = 0;
 		VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
 		Vector<VkDescriptorSetLayout> layouts;
 		Vector<VkDescriptorSet> sets;
@@ -44,6 +46,13 @@ public:
 	virtual bool init(Device &dev, gl::RenderPassData &);
 
 	VkRenderPass getRenderPass() const { return _data->renderPass; }
+
+	// compatible render pass, that loads content of swapchain image, presented before, for partial redraw;
+	// VK_NULL_HANDLE if pass does not render into swapchain image
+	VkRenderPass getLoadRenderPass() const { return _data->renderPassLoad; }
+
+	// index of swapchain image within color attachments of first subpass
+	uint32_t getLoadColorAttachment() const { return _data->loadColorAttachment; }
 	VkPipelineLayout getPipelineLayout() const { return _data->layout; }
 	const Vector<VkDescriptorSet> &getDescriptorSets() const { return _data->sets; }
 
@@ -28,6 +28,33 @@
 
 namespace stappler::xenolith::vk {
 
+SurfaceHandle::~SurfaceHandle() {
+	if (_surface) {
+		_instance->vkDestroySurfaceKHR(_instance->getInstance(), _surface, nullptr);
+		_surface = VK_NULL_HANDLE;
+	}
+}
+
+bool SurfaceHandle::init(const Instance *instance, VkSurfaceKHR surface) {
+	_instance = instance;
+	_surface = surface;
+	return true;
+}
+
+SwapchainHandle::~SwapchainHandle() {
+	if (_swapchain) {
+		_device->getTable()->vkDestroySwapchainKHR(_device->getDevice(), _swapchain, nullptr);
+		_swapchain = VK_NULL_HANDLE;
+	}
+}
+
+bool SwapchainHandle::init(Device &device, VkSwapchainKHR swapchain, const Rc<SurfaceHandle> &surface) {
+	_device = &device;
+	_surface = surface;
+	_swapchain = swapchain;
+	return true;
+}
+
 SwapchainSync::~SwapchainSync() { }
 
 bool SwapchainSync::init(Device &dev, uint32_t idx) {
@@ -78,6 +105,8 @@ VkResult SwapchainSync::acquireImage(Device &dev, Swapchain &swapchain, uint32_t
 }
 
 Swapchain::~Swapchain() {
+	stopPresentWaiter();
+
 	for (auto &it : _sems) {
 		for (auto &iit : it) {
 			iit->invalidate();
@@ -91,7 +120,7 @@ bool Swapchain::init(const gl::View *view, Device &device, VkSurfaceKHR surface,
 		return false;
 	}
 
-	_surface = surface;
+	_surface = Rc<SurfaceHandle>::create(device.getInstance(), surface);
 	_info = device.getInstance()->getSurfaceOptions(surface, device.getPhysicalDevice());
 	_sems.resize(2);
 
@@ -139,6 +168,15 @@ bool Swapchain::init(const gl::View *view, Device &device, VkSurfaceKHR surface,
 		return false;
 	}
 
+	auto &features = device.getInfo().features;
+	_hasDisplayTiming = (features.flags & ExtensionFlags::DisplayTiming) != ExtensionFlags::None;
+#if defined(VK_KHR_present_wait)
+	_hasPresentWait = (features.flags & ExtensionFlags::PresentId) != ExtensionFlags::None
+			&& (features.flags & ExtensionFlags::PresentWait) != ExtensionFlags::None
+			&& features.devicePresentId.presentId && features.devicePresentWait.presentWait;
+#endif
+	_hasIncrementalPresent = (features.flags & ExtensionFlags::IncrementalPresent) != ExtensionFlags::None;
+
 	auto modes = getPresentModes(_info);
 
 	_presentMode = _bestPresentMode = modes.first;
@@ -187,25 +225,33 @@ bool Swapchain::recreateSwapchain(gl::Device &idevice, gl::SwapchanCreationMode
 		return false;
 	}
 
+	auto t = platform::device::_clock();
+
+	// no device wait here: frames in flight retain framebuffers, image views and retired swapchain
+	// with their fences, new frames will use new swapchain immediately
 	if (_swapchain) {
 		cleanupSwapchain(device);
 		if (_nextRenderQueue) {
 			_renderQueue = move(_nextRenderQueue);
 			_nextRenderQueue = nullptr;
 		}
-	} else {
-		device.getTable()->vkDeviceWaitIdle(device.getDevice());
 	}
 
 	auto modes = getPresentModes(info);
+	_bestPresentMode = modes.first;
+	_fastPresentMode = modes.second;
 
 	_info = move(info);
 
+	bool ret = false;
 	if (mode == gl::SwapchanCreationMode::Best) {
-		return createSwapchain(device, modes.first);
+		ret = createSwapchain(device, modes.first);
 	} else {
-		return createSwapchain(device, modes.second);
+		ret = createSwapchain(device, modes.second);
 	}
+
+	XL_VK_LOG("RecreateSwapChain: done in ", platform::device::_clock() - t, " mks");
+	return ret;
 }
 
 static VkPresentModeKHR getVkPresentMode(gl::PresentMode presentMode) {
@@ -222,6 +268,9 @@ static VkPresentModeKHR getVkPresentMode(gl::PresentMode presentMode) {
 bool Swapchain::createSwapchain(Device &device, gl::PresentMode presentMode) {
 	auto table = device.getTable();
 
+	// present ids are not shared between swapchains, feedback for old one will not be received
+	flushPendingPresents();
+
 	auto swapchainImageInfo = getSwapchainImageInfo();
 
 	gl::RenderPassData *swapchainPass = nullptr;
@@ -275,36 +324,56 @@ bool Swapchain::createSwapchain(Device &device, gl::PresentMode presentMode) {
 	swapChainCreateInfo.preTransform = _info.capabilities.currentTransform;
 	swapChainCreateInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
 	swapChainCreateInfo.presentMode = getVkPresentMode(presentMode);
-	swapChainCreateInfo.clipped = VK_TRUE;
+	// partial redraw loads content of previously presented image, so, obscured pixels should be rendered too
+	auto loadPass = swapchainPass->impl.cast<RenderPassImpl>()->getLoadRenderPass();
+	swapChainCreateInfo.clipped = (loadPass != VK_NULL_HANDLE) ? VK_FALSE : VK_TRUE;
 
 	if (_oldSwapchain) {
-		swapChainCreateInfo.oldSwapchain = _oldSwapchain;
+		swapChainCreateInfo.oldSwapchain = _oldSwapchain->getSwapchain();
 	} else {
 		swapChainCreateInfo.oldSwapchain = VK_NULL_HANDLE;
 	}
 
-	swapChainCreateInfo.imageExtent = device.getInstance()->getSurfaceExtent(_surface, device.getPhysicalDevice());
+	swapChainCreateInfo.imageExtent = device.getInstance()->getSurfaceExtent(_surface->getSurface(), device.getPhysicalDevice());
 
-	if (table->vkCreateSwapchainKHR(device.getDevice(), &swapChainCreateInfo, nullptr, &_swapchain) != VK_SUCCESS) {
+	VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+	if (table->vkCreateSwapchainKHR(device.getDevice(), &swapChainCreateInfo, nullptr, &swapchain) != VK_SUCCESS) {
 		return false;
 	}
 
+	_swapchain = Rc<SwapchainHandle>::create(device, swapchain, _surface);
+
+#if defined(VK_GOOGLE_display_timing)
+	if (_hasDisplayTiming) {
+		VkRefreshCycleDurationGOOGLE refresh;
+		if (table->vkGetRefreshCycleDurationGOOGLE(device.getDevice(), swapchain, &refresh) == VK_SUCCESS && refresh.refreshDuration > 0) {
+			setVblankInterval(refresh.refreshDuration / 1000);
+		}
+	}
+#endif
+
 	swapchainImageInfo.extent = Extent3(swapChainCreateInfo.imageExtent.width, swapChainCreateInfo.imageExtent.height, 1);
 
 	_renderQueue->updateSwapchainInfo(swapchainImageInfo);
 
-	if (_oldSwapchain) {
-		table->vkDestroySwapchainKHR(device.getDevice(), _oldSwapchain, nullptr);
-		_oldSwapchain = VK_NULL_HANDLE;
-	}
+	// retired swapchain is destroyed, when frames, that still use its images, are completed
+	_oldSwapchain = nullptr;
 
 	Vector<VkImage> swapchainImages;
 
-	table->vkGetSwapchainImagesKHR(device.getDevice(), _swapchain, &imageCount, nullptr);
+	table->vkGetSwapchainImagesKHR(device.getDevice(), swapchain, &imageCount, nullptr);
 	swapchainImages.resize(imageCount);
-	table->vkGetSwapchainImagesKHR(device.getDevice(), _swapchain, &imageCount, swapchainImages.data());
+	table->vkGetSwapchainImagesKHR(device.getDevice(), swapchain, &imageCount, swapchainImages.data());
+
+	buildAttachments(device, _renderQueue.get(), swapchainPass, swapchainImageInfo, move(swapchainImages));
 
-	buildAttachments(device, _renderQueue.get(), swapchainPass, move(swapchainImages));
+	do {
+		std::unique_lock<Mutex> lock(_damageMutex);
+		// content of new images is undefined, they are redrawn fully
+		_damageSwapchain = _swapchain.get();
+		_imageOrders.assign(imageCount, maxOf<uint64_t>());
+		_damageHistory.clear();
+	} while (0);
 
 	_presentMode = presentMode;
 	_valid = true;
@@ -312,28 +381,18 @@ bool Swapchain::createSwapchain(Device &device, gl::PresentMode presentMode) {
 }
 
 void Swapchain::cleanupSwapchain(Device &device) {
-	device.getTable()->vkDeviceWaitIdle(device.getDevice());
-
-	if (_renderQueue) {
-		for (auto &pass : _renderQueue->getPasses()) {
-			for (auto &desc : pass->descriptors) {
-				if (desc->getAttachment()->getType() == gl::AttachmentType::SwapchainImage) {
-					pass->framebuffers.clear();
-					desc->clear();
-				}
-			}
-		}
-
-		for (auto &attachment : _renderQueue->getAttachments()) {
-			if (attachment->getType() == gl::AttachmentType::SwapchainImage) {
-				attachment->clear();
-			}
-		}
-	}
+	// only drop references here, framebuffers and views are retained by frames in flight;
+	// compiled queue can be shared with other swapchains, so, its attachments are not touched
+	do {
+		std::unique_lock<Mutex> lock(_framebufferMutex);
+		_framebuffers.clear();
+		_imageViews.clear();
+		_images.clear();
+	} while (0);
 
 	if (_swapchain) {
-		_oldSwapchain = _swapchain;
-		_swapchain = VK_NULL_HANDLE;
+		_oldSwapchain = move(_swapchain);
+		_swapchain = nullptr;
 	}
 }
 
@@ -342,21 +401,16 @@ void Swapchain::invalidate(gl::Device &idevice) {
 
 	incrementGeneration(0); // wait idle
 
+	// waiter retains device and swapchain handle
+	stopPresentWaiter();
+
 	if (_swapchain) {
 		cleanupSwapchain(device);
 	}
 
-	if (_oldSwapchain) {
-		device.getTable()->vkDestroySwapchainKHR(device.getDevice(), _oldSwapchain, nullptr);
-		_oldSwapchain = VK_NULL_HANDLE;
-	}
-
-	if (_surface) {
-		auto i = device.getInstance();
-		i->vkDestroySurfaceKHR(i->getInstance(), _surface, nullptr);
-		device.getTable()->vkDeviceWaitIdle(device.getDevice());
-		_surface = VK_NULL_HANDLE;
-	}
+	// swapchain and surface are destroyed with last frame, that uses them
+	_oldSwapchain = nullptr;
+	_surface = nullptr;
 }
 
 gl::ImageInfo Swapchain::getSwapchainImageInfo() const {
@@ -372,7 +426,8 @@ gl::ImageInfo Swapchain::getSwapchainImageInfo() const {
 }
 
 bool Swapchain::isBestPresentMode() const {
-	return _presentMode == _bestPresentMode;
+	// preferred mode can be changed after swapchain was created
+	return _presentMode == getPresentModes(_info).first;
 }
 
 Rc<SwapchainSync> Swapchain::acquireSwapchainSync(Device &dev, uint64_t idx) {
@@ -393,11 +448,265 @@ void Swapchain::releaseSwapchainSync(Rc<SwapchainSync> &&ref) {
 	}
 }
 
+uint32_t Swapchain::registerPresent(const gl::FrameHandle &frame) {
+	auto t = platform::device::_clock();
+	auto inputTime = frame.getInputTime();
+	if (!_hasDisplayTiming) {
+		if (inputTime) {
+			addInputLatency(t - inputTime);
+		}
+		return 0;
+	}
+
+	std::unique_lock<Mutex> lock(_presentTimingMutex);
+	if (++ _presentId == 0) {
+		++ _presentId;
+	}
+	_pendingPresents.emplace_back(PendingPresent{_presentId, inputTime, t, frame.getTimeStart(), frame.getTargetTime()});
+	while (_pendingPresents.size() > config::InputLatencyPendingPresents) {
+		if (_pendingPresents.front().inputTime) {
+			addInputLatency(_pendingPresents.front().presentTime - _pendingPresents.front().inputTime);
+		}
+		_pendingPresents.pop_front();
+	}
+	return _presentId;
+}
+
+void Swapchain::updatePresentTiming(Device &dev, VkSwapchainKHR swapchain) {
+#if defined(VK_GOOGLE_display_timing)
+	if (!_hasDisplayTiming || swapchain == VK_NULL_HANDLE) {
+		return;
+	}
+
+	std::unique_lock<Mutex> lock(_presentTimingMutex);
+	if (_pendingPresents.empty()) {
+		return;
+	}
+
+	uint32_t count = 0;
+	if (dev.getTable()->vkGetPastPresentationTimingGOOGLE(dev.getDevice(), swapchain, &count, nullptr) != VK_SUCCESS || count == 0) {
+		return;
+	}
+
+	Vector<VkPastPresentationTimingGOOGLE> timings(count);
+	auto result = dev.getTable()->vkGetPastPresentationTimingGOOGLE(dev.getDevice(), swapchain, &count, timings.data());
+	if (result != VK_SUCCESS && result != VK_INCOMPLETE) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < count; ++ i) {
+		auto &timing = timings[i];
+		auto it = std::find_if(_pendingPresents.begin(), _pendingPresents.end(), [&] (const PendingPresent &p) {
+			return p.id == timing.presentID;
+		});
+		if (it != _pendingPresents.end()) {
+			// actualPresentTime is in CLOCK_MONOTONIC domain, nanoseconds
+			auto presentTime = timing.actualPresentTime / 1000;
+			if (presentTime < it->presentTime) {
+				presentTime = it->presentTime;
+			}
+			if (it->inputTime) {
+				addInputLatency(presentTime - it->inputTime);
+			}
+			if (!_hasPresentWait) {
+				addPresentFeedback(it->timeStart, it->targetTime, presentTime, true);
+			}
+			_pendingPresents.erase(it);
+		}
+	}
+#endif
+}
+
+void Swapchain::flushPendingPresents() {
+	std::unique_lock<Mutex> lock(_presentTimingMutex);
+	for (auto &it : _pendingPresents) {
+		if (it.inputTime) {
+			addInputLatency(it.presentTime - it.inputTime);
+		}
+	}
+	_pendingPresents.clear();
+}
+
+uint64_t Swapchain::acquirePresentWaitId() {
+	if (!_hasPresentWait) {
+		return 0;
+	}
+	return ++ _presentWaitId;
+}
+
+void Swapchain::waitForPresent(gl::FrameHandle &frame, const Rc<SwapchainHandle> &handle, uint64_t presentId) {
+#if defined(VK_KHR_present_wait)
+	if (!presentId || !handle) {
+		return;
+	}
+
+	std::unique_lock<Mutex> lock(_presentWaitMutex);
+	if (_presentWaitExit) {
+		return;
+	}
+
+	// swapchain handle is retained, so wait can not outlive retired swapchain
+	_presentWaitRequest = PresentWaitRequest{Rc<gl::Device>(frame.getDevice()), handle, presentId, frame.getTimeStart(), frame.getTargetTime()};
+	if (!_presentWaitThread.joinable()) {
+		_presentWaitThread = std::thread([this] {
+			runPresentWaiter();
+		});
+	}
+	_presentWaitCond.notify_one();
+#endif
+}
+
+void Swapchain::runPresentWaiter() {
+#if defined(VK_KHR_present_wait)
+	thread::ThreadInfo::setThreadInfo("Vk::PresentWait");
+
+	std::unique_lock<Mutex> lock(_presentWaitMutex);
+	while (true) {
+		_presentWaitCond.wait(lock, [&] {
+			return _presentWaitExit || _presentWaitRequest.id != 0;
+		});
+
+		if (_presentWaitExit) {
+			break;
+		}
+
+		auto req = move(_presentWaitRequest);
+		_presentWaitRequest = PresentWaitRequest();
+		lock.unlock();
+
+		// present ids are increasing, so, completion of latest present implies completion of previous ones
+		auto device = (Device *)req.device.get();
+		auto result = device->getTable()->vkWaitForPresentKHR(device->getDevice(), req.handle->getSwapchain(), req.id,
+				config::PresentWaitTimeout * 1000);
+		if (result == VK_SUCCESS) {
+			addPresentFeedback(req.timeStart, req.targetTime, platform::device::_clock(), true);
+		}
+
+		// release retained objects outside of lock
+		req = PresentWaitRequest();
+		lock.lock();
+	}
+
+	_presentWaitRequest = PresentWaitRequest();
+#endif
+}
+
+void Swapchain::stopPresentWaiter() {
+	do {
+		std::unique_lock<Mutex> lock(_presentWaitMutex);
+		_presentWaitExit = true;
+		_presentWaitCond.notify_all();
+	} while (0);
+
+	if (_presentWaitThread.joinable()) {
+		_presentWaitThread.join();
+	}
+}
+
+void Swapchain::addPresentEstimate(const gl::FrameHandle &frame, uint64_t presentTime) {
+	std::unique_lock<Mutex> lock(_pacingMutex);
+	if (_precisePacing || !_lastVblank || !_vblankInterval || !frame.getTargetTime()) {
+		return;
+	}
+
+	auto displayTime = _lastVblank + _vblankInterval;
+	if (presentTime > displayTime) {
+		displayTime += ((presentTime - displayTime + _vblankInterval - 1) / _vblankInterval) * _vblankInterval;
+	}
+
+	auto targetTime = frame.getTargetTime();
+	auto error = (displayTime > targetTime) ? displayTime - targetTime : targetTime - displayTime;
+	++ _pacingStat.frames;
+	_errorSum += error;
+	_pacingStat.errorMax = std::max(_pacingStat.errorMax, error);
+	if (displayTime > targetTime + _vblankInterval / 2) {
+		++ _pacingStat.missed;
+	}
+}
+
+static URect Swapchain_unionRect(const URect &a, const URect &b) {
+	if (a.width == 0 || a.height == 0) {
+		return b;
+	} else if (b.width == 0 || b.height == 0) {
+		return a;
+	}
+
+	auto x = std::min(a.x, b.x);
+	auto y = std::min(a.y, b.y);
+	return URect{x, y, std::max(a.x + a.width, b.x + b.width) - x, std::max(a.y + a.height, b.y + b.height) - y};
+}
+
+bool Swapchain::getRedrawRegion(const Rc<SwapchainHandle> &handle, uint32_t image, uint64_t order,
+		const URect &damage, bool fullDamage, URect &region) {
+	std::unique_lock<Mutex> lock(_damageMutex);
+	if (handle.get() != _damageSwapchain || image >= _imageOrders.size()) {
+		return false;
+	}
+
+	// damage is recorded for fully redrawn frames too, next frames should include it
+	auto it = std::lower_bound(_damageHistory.begin(), _damageHistory.end(), order, [] (const DamageRecord &r, uint64_t o) {
+		return r.order < o;
+	});
+	if (it == _damageHistory.end() || it->order != order) {
+		_damageHistory.insert(it, DamageRecord{order, damage, fullDamage});
+	}
+
+	while (!_damageHistory.empty() && _damageHistory.front().order + config::PartialRedrawHistory < order) {
+		_damageHistory.pop_front();
+	}
+
+	auto imageOrder = _imageOrders[image];
+	if (fullDamage || imageOrder == maxOf<uint64_t>() || imageOrder >= order) {
+		return false;
+	}
+
+	// every frame after one, that drawn image content, should have known damage, or frame was lost
+	region = damage;
+	auto next = imageOrder + 1;
+	for (auto &it : _damageHistory) {
+		if (it.order <= imageOrder) {
+			continue;
+		} else if (it.order >= order) {
+			break;
+		} else if (it.order != next || it.full) {
+			return false;
+		}
+		region = Swapchain_unionRect(region, it.region);
+		++ next;
+	}
+	return next == order;
+}
+
+void Swapchain::setImagePresented(const Rc<SwapchainHandle> &handle, uint32_t image, uint64_t order) {
+	std::unique_lock<Mutex> lock(_damageMutex);
+	if (handle.get() == _damageSwapchain && image < _imageOrders.size()) {
+		if (_imageOrders[image] == maxOf<uint64_t>() || _imageOrders[image] < order) {
+			_imageOrders[image] = order;
+		}
+	}
+}
+
+void Swapchain::invalidateContent() {
+	std::unique_lock<Mutex> lock(_damageMutex);
+	_imageOrders.assign(_imageOrders.size(), maxOf<uint64_t>());
+}
+
 Rc<gl::FrameHandle> Swapchain::makeFrame(gl::Loop &loop, bool readyForSubmit) {
 	return Rc<FrameHandle>::create(loop, *this, *_renderQueue, _order ++, _gen, readyForSubmit);
 }
 
-void Swapchain::buildAttachments(Device &device, gl::RenderQueue *queue, gl::RenderPassData *pass, const Vector<VkImage> &swapchainImages) {
+Rc<Framebuffer> Swapchain::getFramebuffer(const gl::RenderPassData *pass, uint32_t index) const {
+	std::unique_lock<Mutex> lock(_framebufferMutex);
+	auto it = _framebuffers.find(pass);
+	if (it != _framebuffers.end() && index < it->second.size()) {
+		return it->second[index];
+	}
+	return nullptr;
+}
+
+void Swapchain::buildAttachments(Device &device, gl::RenderQueue *queue, gl::RenderPassData *pass,
+		const gl::ImageInfo &swapchainImageInfo, const Vector<VkImage> &swapchainImages) {
+	std::unique_lock<Mutex> lock(_framebufferMutex);
 	for (auto &it : queue->getAttachments()) {
 		if (it->getType() == gl::AttachmentType::Buffer) {
 			continue;
@@ -405,11 +714,15 @@ void Swapchain::buildAttachments(Device &device, gl::RenderQueue *queue, gl::Ren
 
 		if (it->getType() == gl::AttachmentType::SwapchainImage) {
 			if (auto image = it.cast<SwapchainAttachment>().get()) {
+				// images are created with extent of this swapchain, not one, stored in shared attachment
+				auto info = image->getInfo();
+				info.extent = swapchainImageInfo.extent;
+
 				Vector<Rc<Image>> images;
 				for (auto &img : swapchainImages) {
-					images.emplace_back(Rc<Image>::create(device, img, image->getInfo()));
+					images.emplace_back(Rc<Image>::create(device, img, info));
 				}
-				image->setImages(move(images));
+				_images.emplace(image, move(images));
 			} else {
 				log::vtext("Vk-Error", "Unsupported swapchain attachment type");
 			}
@@ -419,7 +732,7 @@ void Swapchain::buildAttachments(Device &device, gl::RenderQueue *queue, gl::Ren
 	}
 
 	for (auto &it : queue->getPasses()) {
-		updateFramebuffer(device, it);
+		updateFramebuffer(device, it, Extent2(swapchainImageInfo.extent.width, swapchainImageInfo.extent.height));
 	}
 }
 
@@ -427,25 +740,7 @@ void Swapchain::updateAttachment(Device &device, const Rc<gl::Attachment> &) {
 
 }
 
-void Swapchain::updateFramebuffer(Device &device, gl::RenderPassData *pass) {
-	Extent2 extent;
-	auto lastSubpass = pass->subpasses.back();
-	if (!lastSubpass.resolveImages.empty()) {
-		for (auto &it : lastSubpass.resolveImages) {
-			if (it) {
-				extent.width = std::max(extent.width, it->getInfo().extent.width);
-				extent.height = std::max(extent.height, it->getInfo().extent.height);
-			}
-		}
-	} else if (!lastSubpass.outputImages.empty()) {
-		for (auto &it : lastSubpass.outputImages) {
-			if (it) {
-				extent.width = std::max(extent.width, it->getInfo().extent.width);
-				extent.height = std::max(extent.height, it->getInfo().extent.height);
-			}
-		}
-	}
-
+void Swapchain::updateFramebuffer(Device &device, gl::RenderPassData *pass, Extent2 extent) {
 	size_t framebuffersCount = 0;
 	for (auto &desc : pass->descriptors) {
 		if (desc->getAttachment()->getType() == gl::AttachmentType::Buffer) {
@@ -453,33 +748,16 @@ void Swapchain::updateFramebuffer(Device &device, gl::RenderPassData *pass) {
 		}
 
 		if (desc->getAttachment()->getType() == gl::AttachmentType::SwapchainImage) {
-			auto image = dynamic_cast<SwapchainAttachment *>(desc->getAttachment());
 			auto imageDesc = dynamic_cast<SwapchainAttachmentDescriptor *>(desc);
-			if (image && imageDesc) {
-				framebuffersCount = std::max(framebuffersCount, image->getImages().size());
-
-				if (!imageDesc->getImageViews().empty() && imageDesc->getImageViews().size() == image->getImages().size()) {
-					Vector<Rc<ImageView>> imageViews;
-					size_t idx = 0;
-					for (auto &it : imageDesc->getImageViews()) {
-						if (it->getImage() == image->getImages().at(idx)) {
-							imageViews.emplace_back(it.get());
-						} else {
-							auto iv = Rc<ImageView>::create(device, *imageDesc, image->getImages().at(idx).cast<Image>());
-							imageViews.emplace_back(it.get());
-						}
-						++ idx;
-					}
-					imageDesc->setImageViews(move(imageViews));
-				} else {
-					imageDesc->clear();
-					Vector<Rc<ImageView>> imageViews;
-					for (auto &it : image->getImages()) {
-						auto iv = Rc<ImageView>::create(device, *imageDesc, it.cast<Image>());
-						imageViews.emplace_back(iv.get());
-					}
-					imageDesc->setImageViews(move(imageViews));
+			auto imagesIt = _images.find(desc->getAttachment());
+			if (imageDesc && imagesIt != _images.end()) {
+				framebuffersCount = std::max(framebuffersCount, imagesIt->second.size());
+
+				Vector<Rc<ImageView>> imageViews;
+				for (auto &it : imagesIt->second) {
+					imageViews.emplace_back(Rc<ImageView>::create(device, *imageDesc, it));
 				}
+				_imageViews.emplace(desc, move(imageViews));
 			} else {
 				log::vtext("Vk-Error", "Unsupported swapchain attachment type");
 			}
@@ -501,26 +779,27 @@ void Swapchain::updateFramebuffer(Device &device, gl::RenderPassData *pass) {
 		}
 	}
 
-	pass->framebuffers.clear();
+	Vector<Rc<Framebuffer>> framebuffers;
 	for (size_t i = 0; i < framebuffersCount; ++ i) {
-		Vector<VkImageView> imageViews;
+		Vector<Rc<ImageView>> imageViews;
 		for (auto &desc : pass->descriptors) {
 			switch (desc->getAttachment()->getType()) {
 			case gl::AttachmentType::Buffer:
 			case gl::AttachmentType::Generic:
 				break;
 			case gl::AttachmentType::Image:
-				imageViews.emplace_back(((ImageAttachmentDescriptor *)desc)->getImageView().cast<ImageView>()->getImageView());
+				imageViews.emplace_back(((ImageAttachmentDescriptor *)desc)->getImageView().cast<ImageView>());
 				break;
-			case gl::AttachmentType::SwapchainImage:
-				imageViews.emplace_back(((SwapchainAttachmentDescriptor *)desc)->getImageViews()
-						[i % ((SwapchainAttachmentDescriptor *)desc)->getImageViews().size()].cast<ImageView>()->getImageView());
+			case gl::AttachmentType::SwapchainImage: {
+				auto &views = _imageViews[desc];
+				imageViews.emplace_back(views[i % views.size()]);
 				break;
 			}
+			}
 		}
-		auto fb = Rc<Framebuffer>::create(device, pass->impl.cast<RenderPassImpl>()->getRenderPass(), imageViews, extent);
-		pass->framebuffers.emplace_back(fb.get());
+		framebuffers.emplace_back(Rc<Framebuffer>::create(device, pass->impl.cast<RenderPassImpl>()->getRenderPass(), move(imageViews), extent));
 	}
+	_framebuffers.emplace(pass, move(framebuffers));
 }
 
 Pair<gl::PresentMode, gl::PresentMode> Swapchain::getPresentModes(const SurfaceInfo &info) const {
@@ -528,12 +807,24 @@ Pair<gl::PresentMode, gl::PresentMode> Swapchain::getPresentModes(const SurfaceI
 	 // best available mode will be first
 	fast = best = info.presentModes.front();
 
+	auto isAvailable = [&] (gl::PresentMode mode) {
+		return std::find(info.presentModes.begin(), info.presentModes.end(), mode) != info.presentModes.end();
+	};
+
 	// check for immediate mode
-	for (auto &it : info.presentModes) {
-		if (it == gl::PresentMode::Immediate) {
-			fast = it;
-			break;
+	if (isAvailable(gl::PresentMode::Immediate)) {
+		fast = gl::PresentMode::Immediate;
+	}
+
+	if (_benchmark) {
+		// uncapped mode for throughput testing, mailbox still does not wait for vblank
+		if (isAvailable(gl::PresentMode::Immediate)) {
+			best = gl::PresentMode::Immediate;
+		} else if (isAvailable(gl::PresentMode::Mailbox)) {
+			best = gl::PresentMode::Mailbox;
 		}
+	} else if (_preferredPresentMode != gl::PresentMode::Unsupported && isAvailable(_preferredPresentMode)) {
+		best = _preferredPresentMode;
 	}
 
 	return pair(best, fast);
@@ -36,6 +36,36 @@ class Fence;
 class RenderPassImpl;
 class FrameHandle;
 
+// owns VkSurfaceKHR, destroyed when last swapchain, created for it, is destroyed
+class SurfaceHandle : public Ref {
+public:
+	virtual ~SurfaceHandle();
+
+	bool init(const Instance *, VkSurfaceKHR);
+
+	VkSurfaceKHR getSurface() const { return _surface; }
+
+protected:
+	const Instance *_instance = nullptr;
+	VkSurfaceKHR _surface = VK_NULL_HANDLE;
+};
+
+// owns VkSwapchainKHR; frames, that render into swapchain images, retain it with their fences,
+// so retired swapchain is destroyed only when last frame, that used it, is completed
+class SwapchainHandle : public Ref {
+public:
+	virtual ~SwapchainHandle();
+
+	bool init(Device &, VkSwapchainKHR, const Rc<SurfaceHandle> &);
+
+	VkSwapchainKHR getSwapchain() const { return _swapchain; }
+
+protected:
+	Rc<Device> _device;
+	Rc<SurfaceHandle> _surface;
+	VkSwapchainKHR _swapchain = VK_NULL_HANDLE;
+};
+
 class SwapchainSync : public Ref {
 public:
 	virtual ~SwapchainSync();
@@ -80,23 +110,88 @@ public:
 	bool createSwapchain(Device &, gl::PresentMode);
 	void cleanupSwapchain(Device &);
 
-	gl::PresentMode getPresentMode() const { return _presentMode; }
-	VkSurfaceKHR getSurface() const { return _surface; }
-	VkSwapchainKHR getSwapchain() const { return _swapchain; }
+	virtual gl::PresentMode getPresentMode() const override { return _presentMode; }
+	VkSurfaceKHR getSurface() const { return _surface ? _surface->getSurface() : VK_NULL_HANDLE; }
+	VkSwapchainKHR getSwapchain() const { return _swapchain ? _swapchain->getSwapchain() : VK_NULL_HANDLE; }
+	const Rc<SwapchainHandle> &getSwapchainHandle() const { return _swapchain; }
 	gl::ImageInfo getSwapchainImageInfo() const;
 
 	virtual bool isBestPresentMode() const override;
 
 	const Rc<gl::RenderQueue> &getRenderQueue() const { return _renderQueue; }
 
+	// framebuffer of this swapchain for render pass and swapchain image index
+	Rc<Framebuffer> getFramebuffer(const gl::RenderPassData *, uint32_t index) const;
+
 	Rc<SwapchainSync> acquireSwapchainSync(Device &, uint64_t);
 	void releaseSwapchainSync(Rc<SwapchainSync> &&);
 
+	bool hasDisplayTiming() const { return _hasDisplayTiming; }
+	bool hasPresentWait() const { return _hasPresentWait; }
+	bool hasIncrementalPresent() const { return _hasIncrementalPresent; }
+
+	// called on present; records input latency without display timing, returns presentID
+	// for VkPresentTimesInfoGOOGLE, or 0 if display timing is not available
+	uint32_t registerPresent(const gl::FrameHandle &);
+
+	// collect actual present times for previous presents and record their input latency and pacing error
+	void updatePresentTiming(Device &, VkSwapchainKHR);
+
+	// id for VkPresentIdKHR, or 0 if present wait is not available
+	uint64_t acquirePresentWaitId();
+
+	// wait for presentation on dedicated thread, and use it as pacing feedback;
+	// only latest present is waited, pending request for older present is replaced
+	void waitForPresent(gl::FrameHandle &, const Rc<SwapchainHandle> &, uint64_t presentId);
+
+	// pacing error for frame, when no present feedback available; display time is estimated
+	// as first vblank after present call, vblanks are estimated from image acquisition
+	void addPresentEstimate(const gl::FrameHandle &, uint64_t presentTime);
+
+	// records frame's damage (in pixels) and returns region of image, that should be redrawn: damage of frame
+	// and of all frames, presented since image content was drawn; returns false, if image should be redrawn fully
+	bool getRedrawRegion(const Rc<SwapchainHandle> &, uint32_t image, uint64_t order,
+			const URect &damage, bool fullDamage, URect &region);
+
+	// image content is drawn by frame, called on successful present
+	void setImagePresented(const Rc<SwapchainHandle> &, uint32_t image, uint64_t order);
+
+	// content of presented images is lost (window was exposed), next frames are redrawn fully
+	void invalidateContent();
+
 protected:
+	struct PendingPresent {
+		uint32_t id;
+		uint64_t inputTime;
+		uint64_t presentTime; // fallback, if timing feedback was lost
+		uint64_t timeStart;
+		uint64_t targetTime;
+	};
+
+	struct PresentWaitRequest {
+		Rc<gl::Device> device;
+		Rc<SwapchainHandle> handle;
+		uint64_t id = 0;
+		uint64_t timeStart = 0;
+		uint64_t targetTime = 0;
+	};
+
+	struct DamageRecord {
+		uint64_t order;
+		URect region;
+		bool full;
+	};
+
+	// record latency for presents without feedback, using time of vkQueuePresentKHR
+	void flushPendingPresents();
+
+	void runPresentWaiter();
+	void stopPresentWaiter();
+
 	virtual Rc<gl::FrameHandle> makeFrame(gl::Loop &, bool readyForSubmit);
-	void buildAttachments(Device &device, gl::RenderQueue *, gl::RenderPassData *, const Vector<VkImage> &);
+	void buildAttachments(Device &device, gl::RenderQueue *, gl::RenderPassData *, const gl::ImageInfo &, const Vector<VkImage> &);
 	void updateAttachment(Device &device, const Rc<gl::Attachment> &);
-	void updateFramebuffer(Device &device, gl::RenderPassData *);
+	void updateFramebuffer(Device &device, gl::RenderPassData *, Extent2);
 
 	// returns <best, fast>
 	Pair<gl::PresentMode, gl::PresentMode> getPresentModes(const SurfaceInfo &) const;
@@ -106,12 +201,39 @@ protected:
 	gl::PresentMode _bestPresentMode = gl::PresentMode::Fifo;
 	gl::PresentMode _fastPresentMode = gl::PresentMode::Fifo;
 	SurfaceInfo _info;
-	VkSurfaceKHR _surface = VK_NULL_HANDLE;
-	VkSwapchainKHR _swapchain = VK_NULL_HANDLE;
-	VkSwapchainKHR _oldSwapchain = VK_NULL_HANDLE;
+	Rc<SurfaceHandle> _surface;
+	Rc<SwapchainHandle> _swapchain;
+	Rc<SwapchainHandle> _oldSwapchain;
+
+	// swapchain images, views and framebuffers are owned by swapchain, not by render queue,
+	// so, one compiled queue can drive several swapchains
+	mutable Mutex _framebufferMutex;
+	Map<const gl::Attachment *, Vector<Rc<Image>>> _images;
+	Map<const gl::AttachmentDescriptor *, Vector<Rc<ImageView>>> _imageViews;
+	Map<const gl::RenderPassData *, Vector<Rc<Framebuffer>>> _framebuffers;
 
 	Function<void()> _onNextSwapchainRenderQueue;
 	Vector<Vector<Rc<SwapchainSync>>> _sems;
+
+	Mutex _presentTimingMutex;
+	bool _hasDisplayTiming = false;
+	bool _hasPresentWait = false;
+	uint32_t _presentId = 0;
+	std::atomic<uint64_t> _presentWaitId = 0;
+
+	// vkWaitForPresentKHR blocks up to config::PresentWaitTimeout, so, it's not called on shared queue
+	std::thread _presentWaitThread;
+	Mutex _presentWaitMutex;
+	std::condition_variable _presentWaitCond;
+	PresentWaitRequest _presentWaitRequest;
+	bool _presentWaitExit = false;
+	std::deque<PendingPresent> _pendingPresents;
+
+	Mutex _damageMutex;
+	bool _hasIncrementalPresent = false;
+	const SwapchainHandle *_damageSwapchain = nullptr;
+	Vector<uint64_t> _imageOrders; // frame, that drawn image content, or maxOf<uint64_t>() if undefined
+	std::deque<DamageRecord> _damageHistory; // sorted by frame order
 };
 
 }
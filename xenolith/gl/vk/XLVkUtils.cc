@@ -372,6 +372,20 @@ static ExtensionFlags getFlagForExtension(const char *name) {
 		return ExtensionFlags::GetMemoryRequirements2;
 	} else if (strcmp(name, VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME) == 0) {
 		return ExtensionFlags::DedicatedAllocation;
+#if defined(VK_GOOGLE_display_timing)
+	} else if (strcmp(name, VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME) == 0) {
+		return ExtensionFlags::DisplayTiming;
+#endif
+#if defined(VK_KHR_present_wait)
+	} else if (strcmp(name, VK_KHR_PRESENT_ID_EXTENSION_NAME) == 0) {
+		return ExtensionFlags::PresentId;
+	} else if (strcmp(name, VK_KHR_PRESENT_WAIT_EXTENSION_NAME) == 0) {
+		return ExtensionFlags::PresentWait;
+#endif
+#if defined(VK_KHR_incremental_present)
+	} else if (strcmp(name, VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME) == 0) {
+		return ExtensionFlags::IncrementalPresent;
+#endif
 	}
 	return ExtensionFlags::None;
 }
@@ -1075,6 +1089,9 @@ void loadDeviceTable(const Instance *_instance, VkDevice device, DeviceCallTable
 	table->vkGetPipelineExecutablePropertiesKHR = (PFN_vkGetPipelineExecutablePropertiesKHR)_instance->vkGetDeviceProcAddr(device, "vkGetPipelineExecutablePropertiesKHR");
 	table->vkGetPipelineExecutableStatisticsKHR = (PFN_vkGetPipelineExecutableStatisticsKHR)_instance->vkGetDeviceProcAddr(device, "vkGetPipelineExecutableStatisticsKHR");
 #endif /* defined(VK_KHR_pipeline_executable_properties) */
+#if defined(VK_KHR_present_wait)
+	table->vkWaitForPresentKHR = (PFN_vkWaitForPresentKHR)_instance->vkGetDeviceProcAddr(device, "vkWaitForPresentKHR");
+#endif /* defined(VK_KHR_present_wait) */
 #if defined(VK_KHR_push_descriptor)
 	table->vkCmdPushDescriptorSetKHR = (PFN_vkCmdPushDescriptorSetKHR)_instance->vkGetDeviceProcAddr(device, "vkCmdPushDescriptorSetKHR");
 #endif /* defined(VK_KHR_push_descriptor) */
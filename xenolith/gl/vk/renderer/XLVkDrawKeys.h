@@ -0,0 +1,90 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#ifndef XENOLITH_GL_VK_RENDERER_XLVKDRAWKEYS_H_
+#define XENOLITH_GL_VK_RENDERER_XLVKDRAWKEYS_H_
+
+#include "XLVk.h"
+
+namespace stappler::xenolith::vk {
+
+/* Draw sort key layout (most significant first):
+ *  4 bits - subpass
+ *  1 bit  - pass: opaque (depth write) draws first, then translucent
+ * 15 bits - pipeline index within frame
+ * 16 bits - texture set (material layout index)
+ * 28 bits - depth: submission (zPath) order of first command in span
+ */
+inline uint64_t makeDrawKey(uint32_t subpass, bool translucent, uint32_t pipeline,
+		uint32_t textureSet, uint32_t depth) {
+	return (uint64_t(subpass & 0xF) << 60)
+		| (uint64_t(translucent ? 1 : 0) << 59)
+		| (uint64_t(pipeline & 0x7FFF) << 44)
+		| (uint64_t(textureSet & 0xFFFF) << 28)
+		| uint64_t(depth & 0x0FFF'FFFF);
+}
+
+// LSD radix sort with 8-bit digits; passes, where all keys have same digit, are skipped
+template <typename Value>
+inline void sortDrawKeys(Vector<Pair<uint64_t, Value>> &keys) {
+	if (keys.size() < 2) {
+		return;
+	}
+
+	Vector<Pair<uint64_t, Value>> tmp;
+	tmp.resize(keys.size());
+
+	auto *src = &keys;
+	auto *dst = &tmp;
+
+	for (uint32_t shift = 0; shift < 64; shift += 8) {
+		size_t counts[256] = { 0 };
+		for (auto &it : *src) {
+			++ counts[(it.first >> shift) & 0xFF];
+		}
+
+		if (counts[(src->front().first >> shift) & 0xFF] == src->size()) {
+			continue;
+		}
+
+		size_t offset = 0;
+		for (auto &it : counts) {
+			auto c = it;
+			it = offset;
+			offset += c;
+		}
+
+		for (auto &it : *src) {
+			(*dst)[counts[(it.first >> shift) & 0xFF] ++] = it;
+		}
+
+		std::swap(src, dst);
+	}
+
+	if (src != &keys) {
+		keys = move(tmp);
+	}
+}
+
+}
+
+#endif /* XENOLITH_GL_VK_RENDERER_XLVKDRAWKEYS_H_ */
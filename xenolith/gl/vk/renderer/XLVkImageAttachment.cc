@@ -53,15 +53,6 @@ void ImageAttachmentDescriptor::setImageView(const Rc<ImageView> &img) {
 
 SwapchainAttachment::~SwapchainAttachment() { }
 
-void SwapchainAttachment::clear() {
-	gl::SwapchainAttachment::clear();
-	_images.clear();
-}
-
-void SwapchainAttachment::setImages(Vector<Rc<Image>> &&images) {
-	_images = move(images);
-}
-
 Rc<gl::AttachmentHandle> SwapchainAttachment::makeFrameHandle(const gl::FrameHandle &handle) {
 	return Rc<SwapchainAttachmentHandle>::create(this, handle);
 }
@@ -72,15 +63,6 @@ Rc<gl::AttachmentDescriptor> SwapchainAttachment::makeDescriptor(gl::RenderPassD
 
 SwapchainAttachmentDescriptor::~SwapchainAttachmentDescriptor() { }
 
-void SwapchainAttachmentDescriptor::clear() {
-	gl::SwapchainAttachmentDescriptor::clear();
-	_imageViews.clear();
-}
-
-void SwapchainAttachmentDescriptor::setImageViews(Vector<Rc<ImageView>> &&imageViews) {
-	_imageViews = move(imageViews);
-}
-
 ImageAttachmentHandle::~ImageAttachmentHandle() {
 
 }
@@ -91,15 +73,13 @@ SwapchainAttachmentHandle::~SwapchainAttachmentHandle() {
 
 bool SwapchainAttachmentHandle::isAvailable(const gl::FrameHandle &frame) const {
 	auto a = (SwapchainAttachment *)_attachment.get();
-	if (a->getOwner() == &frame) {
-		return true;
-	}
-	return false;
+	return a->isOwner(frame);
 }
 
 bool SwapchainAttachmentHandle::setup(gl::FrameHandle &handle) {
 	_device = (Device *)handle.getDevice();
 	_swapchain = (Swapchain *)handle.getSwapchain();
+	_swapchainHandle = _swapchain->getSwapchainHandle();
 	_sync = static_cast<FrameHandle &>(handle).acquireSwapchainSync();
 	if (acquire(handle)) {
 		return true;
@@ -150,6 +130,10 @@ bool SwapchainAttachmentHandle::acquire(gl::FrameHandle &handle) {
 				break;
 			case VK_SUCCESS:
 			case VK_SUBOPTIMAL_KHR:
+				// image was held by presentation engine, so it was released near vblank;
+				// used as pacing feedback, if presentation engine does not report actual present time
+				_swapchain->addPresentFeedback(0, 0, platform::device::_clock(), false);
+
 				// acquired successfully
 				handle.setAttachmentReady(this);
 				return true; // end spinning
@@ -33,6 +33,7 @@ class Device;
 class Semaphore;
 class SwapchainAttachmentHandle;
 class SwapchainSync;
+class SwapchainHandle;
 class RenderPassHandle;
 
 class ImageAttachment : public gl::ImageAttachment {
@@ -63,34 +64,20 @@ protected:
 	Rc<ImageView> _imageView;
 };
 
+// swapchain images and their views are owned by vk::Swapchain, attachment can be presented on several swapchains
 class SwapchainAttachment : public gl::SwapchainAttachment {
 public:
 	virtual ~SwapchainAttachment();
 
-	virtual void clear() override;
-
-	const Vector<Rc<Image>> &getImages() const { return _images; }
-	virtual void setImages(Vector<Rc<Image>> &&);
-
 	virtual Rc<gl::AttachmentHandle> makeFrameHandle(const gl::FrameHandle &);
 
 protected:
 	virtual Rc<gl::AttachmentDescriptor> makeDescriptor(gl::RenderPassData *) override;
-
-	Vector<Rc<Image>> _images;
 };
 
 class SwapchainAttachmentDescriptor : public gl::SwapchainAttachmentDescriptor {
 public:
 	virtual ~SwapchainAttachmentDescriptor();
-
-	virtual void clear() override;
-
-	const Vector<Rc<ImageView>> &getImageViews() const { return _imageViews; }
-	virtual void setImageViews(Vector<Rc<ImageView>> &&);
-
-protected:
-	Vector<Rc<ImageView>> _imageViews;
 };
 
 class ImageAttachmentHandle : public gl::AttachmentHandle {
@@ -113,6 +100,9 @@ public:
 	const Rc<SwapchainSync> &getSync() const { return _sync; }
 	Swapchain *getSwapchain() const { return _swapchain; }
 
+	// swapchain, from which image was acquired; can be already retired, if swapchain was recreated
+	const Rc<SwapchainHandle> &getSwapchainHandle() const { return _swapchainHandle; }
+
 	Rc<SwapchainSync> acquireSync();
 
 protected:
@@ -124,6 +114,7 @@ protected:
 	Rc<SwapchainSync> _sync;
 	Device * _device = nullptr;
 	Swapchain *_swapchain = nullptr;
+	Rc<SwapchainHandle> _swapchainHandle;
 };
 
 }
@@ -105,16 +105,31 @@ void MaterialCompilationRenderPass::appendRequest(const gl::MaterialAttachment *
 	}
 }
 
-Rc<gl::MaterialInputData> MaterialCompilationRenderPass::popRequest(const gl::MaterialAttachment *a) {
+Rc<gl::MaterialInputData> MaterialCompilationRenderPass::popRequest(const gl::MaterialAttachment *a,
+		size_t maxMaterials, size_t maxBytes) {
 	auto it = _requests.find(a);
 	if (it != _requests.end()) {
 		Rc<gl::MaterialInputData> ret = Rc<gl::MaterialInputData>::alloc();
 		ret->attachment = a;
-		ret->materials.reserve(it->second.size());
-		for (auto &m : it->second) {
-			ret->materials.emplace_back(m.second);
+		ret->materials.reserve(std::min(it->second.size(), maxMaterials));
+
+		size_t bytes = 0;
+		auto objectSize = a->getMaterialObjectSize();
+		auto mIt = it->second.begin();
+		while (mIt != it->second.end() && ret->materials.size() < maxMaterials) {
+			auto size = objectSize + mIt->second->getData().size();
+			if (!ret->materials.empty() && bytes + size > maxBytes) {
+				// at least one material should be compiled to make progress
+				break;
+			}
+			bytes += size;
+			ret->materials.emplace_back(move(mIt->second));
+			mIt = it->second.erase(mIt);
+		}
+
+		if (it->second.empty()) {
+			_requests.erase(it);
 		}
-		_requests.erase(it);
 		return ret;
 	}
 
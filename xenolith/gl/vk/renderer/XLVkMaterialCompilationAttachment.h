@@ -67,7 +67,12 @@ public:
 
 	bool hasRequest(const gl::MaterialAttachment *) const;
 	void appendRequest(const gl::MaterialAttachment *, Vector<Rc<gl::Material>> &&);
-	Rc<gl::MaterialInputData> popRequest(const gl::MaterialAttachment *);
+
+	// pops coalesced request, limited with per-frame budget (count of materials and size of material data)
+	// materials, that does not fit into budget, left in queue for the next compilation frame
+	Rc<gl::MaterialInputData> popRequest(const gl::MaterialAttachment *,
+			size_t maxMaterials = config::MaxMaterialsPerCompilation,
+			size_t maxBytes = config::MaxMaterialBytesPerCompilation);
 	void clearRequests();
 
 	uint64_t incrementOrder();
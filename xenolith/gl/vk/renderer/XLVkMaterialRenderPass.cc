@@ -29,6 +29,8 @@
 #include "XLVkBuffer.h"
 #include "XLVkFrame.h"
 #include "XLVkTextureSet.h"
+#include "XLVkVertexKernels.h"
+#include "XLVkDrawKeys.h"
 
 namespace stappler::xenolith::vk {
 
@@ -81,14 +83,24 @@ bool MaterialVertexAttachmentHandle::writeDescriptor(const RenderPassHandle &han
 
 VertexMaterialAttachment::~VertexMaterialAttachment() { }
 
-bool VertexMaterialAttachment::init(StringView name, const gl::BufferInfo &info, const MaterialVertexAttachment *m) {
+bool VertexMaterialAttachment::init(StringView name, const gl::BufferInfo &info, const MaterialVertexAttachment *m,
+		gl::VertexFormat fmt) {
 	if (BufferAttachment::init(name, info)) {
 		_materials = m;
+		_vertexFormat = fmt;
 		return true;
 	}
 	return false;
 }
 
+Rc<VertexCache> VertexMaterialAttachment::getVertexCache(Device &dev) const {
+	std::unique_lock<Mutex> lock(_cacheMutex);
+	if (!_cache) {
+		_cache = Rc<VertexCache>::create(dev, _vertexFormat);
+	}
+	return _cache;
+}
+
 Rc<gl::AttachmentHandle> VertexMaterialAttachment::makeFrameHandle(const gl::FrameHandle &handle) {
 	return Rc<VertexMaterialAttachmentHandle>::create(this, handle);
 }
@@ -110,10 +122,12 @@ bool VertexMaterialAttachmentHandle::submitInput(gl::FrameHandle &handle, Rc<gl:
 		handle.performInQueue([this, d = move(d)] (gl::FrameHandle &handle) {
 			return loadVertexes(handle, d);
 		}, [this] (gl::FrameHandle &handle, bool success) {
-			if (success) {
+			if (!success) {
+				handle.invalidate();
+			} else if (_writeChunks.empty()) {
 				handle.setInputSubmitted(this);
 			} else {
-				handle.invalidate();
+				scheduleWriteChunks(handle);
 			}
 		}, this);
 		return true;
@@ -134,41 +148,133 @@ bool VertexMaterialAttachmentHandle::writeDescriptor(const RenderPassHandle &, c
 	return true;
 }
 
+// packing functions match GLSL unpackUnorm4x8, unpackUnorm2x16 and unpackHalf2x16
+static uint32_t VertexMaterialAttachment_packUnorm4x8(float r, float g, float b, float a) {
+	return uint32_t(std::clamp(r, 0.0f, 1.0f) * 255.0f + 0.5f)
+		| (uint32_t(std::clamp(g, 0.0f, 1.0f) * 255.0f + 0.5f) << 8)
+		| (uint32_t(std::clamp(b, 0.0f, 1.0f) * 255.0f + 0.5f) << 16)
+		| (uint32_t(std::clamp(a, 0.0f, 1.0f) * 255.0f + 0.5f) << 24);
+}
+
+static uint32_t VertexMaterialAttachment_packUnorm2x16(float x, float y) {
+	return uint32_t(std::clamp(x, 0.0f, 1.0f) * 65535.0f + 0.5f)
+		| (uint32_t(std::clamp(y, 0.0f, 1.0f) * 65535.0f + 0.5f) << 16);
+}
+
+static uint16_t VertexMaterialAttachment_packHalf(float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(float));
+
+	uint32_t sign = (bits >> 16) & 0x8000;
+	int32_t exp = int32_t((bits >> 23) & 0xFF) - 127 + 15;
+	uint32_t mantissa = bits & 0x7F'FFFF;
+
+	if (((bits >> 23) & 0xFF) == 0xFF) {
+		// inf or nan
+		return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+	}
+
+	if (exp >= 0x1F) {
+		// overflow
+		return sign | 0x7C00;
+	}
+
+	if (exp <= 0) {
+		// subnormal or zero
+		if (exp < -10) {
+			return sign;
+		}
+		mantissa |= 0x80'0000;
+		uint32_t shift = 14 - exp;
+		uint32_t half = mantissa >> shift;
+		if ((mantissa >> (shift - 1)) & 1) {
+			++ half;
+		}
+		return sign | half;
+	}
+
+	// rounding carry can propagate into exponent, that is correct behaviour
+	uint32_t half = sign | (uint32_t(exp) << 10) | (mantissa >> 13);
+	if (mantissa & 0x1000) {
+		++ half;
+	}
+	return half;
+}
+
+static uint32_t VertexMaterialAttachment_packHalf2x16(float x, float y) {
+	return uint32_t(VertexMaterialAttachment_packHalf(x)) | (uint32_t(VertexMaterialAttachment_packHalf(y)) << 16);
+}
+
 bool VertexMaterialAttachmentHandle::loadVertexes(gl::FrameHandle &fhandle, const Rc<gl::CommandList> &commands) {
 	auto handle = dynamic_cast<FrameHandle *>(&fhandle);
 	if (!handle) {
 		return false;
 	}
 
+	_damage = commands->getDamage();
+	_fullDamage = commands->isFullDamage();
+
 	struct MaterialWritePlan {
 		const gl::Material *material = nullptr;
 		uint32_t vertexes = 0;
 		uint32_t indexes = 0;
-		std::forward_list<const gl::CmdVertexArray *> commands;
+		uint32_t objects = 0;
+		uint32_t instances = 0;
+		uint32_t order = 0; // submission order of first command
+		Vector<const gl::CmdVertexArray *> commands;
+		Vector<const gl::CmdQuadInstance *> quads;
+		Vector<Pair<uint32_t, uint32_t>> runs; // (vertex arrays, instanced quads) in submission order
 	};
 
 	// fill write plan
 	MaterialWritePlan globalWritePlan;
 	std::unordered_map<gl::MaterialId, MaterialWritePlan> writePlan;
+	Map<const gl::PipelineData *, uint32_t> pipelines;
 
-	auto pushVertexData = [&] (const gl::CmdVertexArray *cmd) {
-		auto it = writePlan.find(cmd->material);
+	uint32_t commandOrder = 0;
+	auto getWritePlan = [&] (gl::MaterialId id) -> MaterialWritePlan * {
+		auto it = writePlan.find(id);
 		if (it == writePlan.end()) {
-			auto material = _materials->getMaterials()->getMaterialById(cmd->material);
-			if (material) {
-				it = writePlan.emplace(cmd->material, MaterialWritePlan()).first;
-				it->second.material = material;
+			auto material = _materials->getMaterials()->getMaterialById(id);
+			if (!material) {
+				return nullptr;
 			}
+			it = writePlan.emplace(id, MaterialWritePlan()).first;
+			it->second.material = material;
+			it->second.order = commandOrder;
+			pipelines.emplace(material->getPipeline(), 0);
 		}
+		return &it->second;
+	};
 
-		if (it != writePlan.end() && it->second.material) {
+	auto pushVertexData = [&] (const gl::CmdVertexArray *cmd) {
+		if (auto plan = getWritePlan(cmd->material)) {
 			globalWritePlan.vertexes += cmd->vertexes->data.size();
 			globalWritePlan.indexes += cmd->vertexes->indexes.size();
+			++ globalWritePlan.objects;
+
+			plan->vertexes += cmd->vertexes->data.size();
+			plan->indexes += cmd->vertexes->indexes.size();
+			plan->commands.emplace_back(cmd);
+			if (plan->runs.empty() || plan->runs.back().second > 0) {
+				plan->runs.emplace_back(0, 0);
+			}
+			++ plan->runs.back().first;
+		}
+		++ commandOrder;
+	};
 
-			it->second.vertexes += cmd->vertexes->data.size();
-			it->second.indexes += cmd->vertexes->indexes.size();
-			it->second.commands.emplace_front(cmd);
+	auto pushQuadInstance = [&] (const gl::CmdQuadInstance *cmd) {
+		if (auto plan = getWritePlan(cmd->material)) {
+			++ globalWritePlan.instances;
+			++ plan->instances;
+			plan->quads.emplace_back(cmd);
+			if (plan->runs.empty()) {
+				plan->runs.emplace_back(0, 0);
+			}
+			++ plan->runs.back().second;
 		}
+		++ commandOrder;
 	};
 
 	auto cmd = commands->getFirst();
@@ -177,93 +283,397 @@ bool VertexMaterialAttachmentHandle::loadVertexes(gl::FrameHandle &fhandle, cons
 		case gl::CommandType::VertexArray:
 			pushVertexData((const gl::CmdVertexArray *)cmd->data);
 			break;
+		case gl::CommandType::QuadInstance:
+			pushQuadInstance((const gl::CmdQuadInstance *)cmd->data);
+			break;
 		case gl::CommandType::CommandGroup:
 			break;
 		}
 		cmd = cmd->next;
 	}
 
-	// optimize draw order
-	Vector<const Pair<const gl::MaterialId, MaterialWritePlan> *> drawOrder;
+	// optimize draw order: one sort key per material span
+	uint32_t pipelineIndex = 0;
+	for (auto &it : pipelines) {
+		it.second = pipelineIndex ++;
+	}
 
+	Vector<Pair<uint64_t, const Pair<const gl::MaterialId, MaterialWritePlan> *>> drawKeys;
+	drawKeys.reserve(writePlan.size());
 	for (auto &it : writePlan) {
-		if (drawOrder.empty()) {
-			drawOrder.emplace_back(&it);
-		} else {
-			auto lb = std::lower_bound(drawOrder.begin(), drawOrder.end(), &it,
-					[] (const Pair<const gl::MaterialId, MaterialWritePlan> *l, const Pair<const gl::MaterialId, MaterialWritePlan> *r) {
-				if (l->second.material->getPipeline() != l->second.material->getPipeline()) {
-					return Pipeline::comparePipelineOrdering(*l->second.material->getPipeline(), *r->second.material->getPipeline());
-				} else if (l->second.material->getLayoutIndex() != r->second.material->getLayoutIndex()) {
-					return l->second.material->getLayoutIndex() < r->second.material->getLayoutIndex();
-				} else {
-					return l->first < r->first;
+		auto pipeline = it.second.material->getPipeline();
+		drawKeys.emplace_back(makeDrawKey(pipeline->subpass, !pipeline->depthWriteEnabled,
+				pipelines[pipeline], it.second.material->getLayoutIndex(), it.second.order), &it);
+	}
+
+	sortDrawKeys(drawKeys);
+
+	if ((globalWritePlan.vertexes == 0 || globalWritePlan.indexes == 0) && globalWritePlan.instances == 0) {
+		return true;
+	}
+
+	// instanced quads are drawn with shared unit quad at the beginning of 16-bit index region
+	uint32_t quadIndexes = (globalWritePlan.instances > 0) ? 6 : 0;
+
+	// build tasks in draw order, actual data will be written later, possibly in parallel
+	struct SpanPlan {
+		const Pair<const gl::MaterialId, MaterialWritePlan> *plan;
+		uint32_t material;
+		size_t firstTask;
+	};
+
+	Vector<WriteTask> tasks;
+	Vector<VertexCache::Request> requests;
+	Vector<SpanPlan> spans;
+	tasks.reserve(globalWritePlan.objects);
+	requests.reserve(globalWritePlan.objects);
+	spans.reserve(drawKeys.size());
+
+	auto materialSet = _materials->getMaterials();
+
+	for (auto &key : drawKeys) {
+		// vertexes are stamped with material index within set, so spans can be drawn with single call
+		auto materialIndex = materialSet->getMaterialOrder(key.second->first);
+
+		spans.emplace_back(SpanPlan{key.second, materialIndex, tasks.size()});
+		for (auto &cmd : key.second->second.commands) {
+			tasks.emplace_back(WriteTask{cmd, materialIndex, 0, 0, 0, 0, false, true});
+			requests.emplace_back(VertexCache::Request{&cmd->vertexes, materialIndex});
+		}
+	}
+
+	// acquire retained vertex regions, only new or changed vertex data will be uploaded
+	auto cache = ((VertexMaterialAttachment *)_attachment.get())->getVertexCache(*(Device *)handle->getDevice());
+	_vertexFormat = cache->getVertexFormat();
+
+	// regions are locked until frame is completed on device, see MaterialRenderPassHandle::doSubmit
+	_cacheLock = cache->lock(handle->getOrder());
+
+	uint32_t slots = 0;
+	Vector<VertexCache::Result> regions;
+	_vertexes = cache->acquire(*_cacheLock, requests, regions, slots, _cacheStat);
+	if (!_vertexes) {
+		return false;
+	}
+
+	uint32_t uploadVertexes = 0;
+	uint32_t frameVertexEnd = 0;
+	for (size_t i = 0; i < tasks.size(); ++ i) {
+		tasks[i].vertexOffset = regions[i].offset;
+		tasks[i].transformIndex = regions[i].slot;
+		tasks[i].writeVertexes = regions[i].write;
+		if (regions[i].write) {
+			uploadVertexes += tasks[i].cmd->vertexes->data.size();
+		}
+		frameVertexEnd = std::max(frameVertexEnd, regions[i].offset + uint32_t(tasks[i].cmd->vertexes->data.size()));
+	}
+
+	XL_VK_LOG("VertexMaterialAttachmentHandle: uploaded: ", _cacheStat.uploaded, " retained: ", _cacheStat.retained);
+
+	// index width is chosen per span: when span's vertexes fit in 16-bit range from base vertex,
+	// 16-bit indexes are used, and base vertex is passed to draw call as vertexOffset
+	uint32_t longIndexes = 0;
+	uint32_t shortIndexes = quadIndexes;
+	uint32_t instanceOffset = 0;
+	Vector<Pair<uint32_t, const MaterialWritePlan *>> instances;
+
+	for (size_t i = 0; i < spans.size(); ++ i) {
+		auto &span = spans[i];
+		auto &plan = span.plan->second;
+		auto lastTask = (i + 1 < spans.size()) ? spans[i + 1].firstTask : tasks.size();
+
+		// translucent material with both vertex arrays and instanced quads should be drawn in submission order,
+		// opaque ones are ordered by depth test, so all its instances can be drawn with single call
+		bool keepOrder = plan.instances > 0 && span.firstTask != lastTask
+				&& !plan.material->getPipeline()->depthWriteEnabled;
+
+		if (span.firstTask != lastTask) {
+			uint32_t spanBegin = maxOf<uint32_t>();
+			uint32_t spanEnd = 0;
+			for (size_t j = span.firstTask; j < lastTask; ++ j) {
+				spanBegin = std::min(spanBegin, tasks[j].vertexOffset);
+				spanEnd = std::max(spanEnd, tasks[j].vertexOffset + uint32_t(tasks[j].cmd->vertexes->data.size()));
+			}
+
+			// common base for whole frame allows to merge neighbour spans
+			bool isShort = (spanEnd - spanBegin <= 0x1'0000);
+			uint32_t base = isShort ? ((frameVertexEnd <= 0x1'0000) ? 0 : spanBegin) : 0;
+			uint32_t &offset = isShort ? shortIndexes : longIndexes;
+			uint32_t firstIndex = offset;
+
+			for (size_t j = span.firstTask; j < lastTask; ++ j) {
+				tasks[j].indexOffset = offset;
+				tasks[j].indexBase = base;
+				tasks[j].shortIndexes = isShort;
+				offset += tasks[j].cmd->vertexes->indexes.size();
+			}
+
+			if (!keepOrder && offset > firstIndex) {
+				_spans.emplace_back(gl::VertexSpan({ span.plan->first, offset - firstIndex, 1, firstIndex, 0,
+					int32_t(base), isShort }));
+			}
+		}
+
+		// instance 0 is reserved for non-instanced draws, so shader can distinguish them by gl_InstanceIndex
+		if (keepOrder) {
+			// each run is a range of span's indexes followed by a range of material's instances
+			size_t task = span.firstTask;
+			uint32_t instance = 0;
+			for (auto &run : plan.runs) {
+				if (run.first > 0) {
+					auto &first = tasks[task];
+					auto &last = tasks[task + run.first - 1];
+					auto end = last.indexOffset + uint32_t(last.cmd->vertexes->indexes.size());
+					if (end > first.indexOffset) {
+						_spans.emplace_back(gl::VertexSpan({ span.plan->first, end - first.indexOffset, 1, first.indexOffset,
+							0, int32_t(first.indexBase), first.shortIndexes }));
+					}
+					task += run.first;
+				}
+				if (run.second > 0) {
+					_spans.emplace_back(gl::VertexSpan({ span.plan->first, quadIndexes, run.second, 0,
+						instanceOffset + instance + 1, 0, true }));
+					instance += run.second;
 				}
-			});
-			if (lb == drawOrder.end()) {
-				drawOrder.emplace_back(&it);
-			} else {
-				drawOrder.emplace(lb, &it);
 			}
+		} else if (plan.instances > 0) {
+			_spans.emplace_back(gl::VertexSpan({ span.plan->first, quadIndexes, plan.instances, 0, instanceOffset + 1,
+				0, true }));
+		}
+
+		if (plan.instances > 0) {
+			instances.emplace_back(span.material, &plan);
+			instanceOffset += plan.instances;
 		}
 	}
 
-	if (globalWritePlan.vertexes == 0 || globalWritePlan.indexes == 0) {
-		return true;
+	// create per-frame buffers
+	_shortIndexesOffset = longIndexes * sizeof(uint32_t);
+	_indexes = handle->getMemPool()->spawn(AllocationUsage::DeviceLocalHostVisible,
+			gl::BufferInfo(gl::BufferUsage::IndexBuffer, _shortIndexesOffset + shortIndexes * sizeof(uint16_t)));
+
+	_transforms = handle->getMemPool()->spawn(AllocationUsage::DeviceLocalHostVisible,
+			gl::BufferInfo(gl::BufferUsage::StorageBuffer, std::max(slots, uint32_t(1)) * sizeof(Mat4)));
+
+	_instances = handle->getMemPool()->spawn(AllocationUsage::DeviceLocalHostVisible,
+			gl::BufferInfo(gl::BufferUsage::StorageBuffer,
+					std::max(globalWritePlan.instances, uint32_t(1)) * sizeof(gl::QuadInstance)));
+
+	_vertexesMap = _vertexes->map();
+	_indexesMap = _indexes->map();
+	_transformsMap = _transforms->map();
+	_instancesMap = _instances->map();
+
+	// instance data is small and written in place, only vertex data upload is split into chunks
+	if (quadIndexes > 0) {
+		// tl bl tr br, same as VertexArray quad
+		const uint16_t quad[6] = { 0, 1, 2, 3, 2, 1 };
+		memcpy(_indexesMap.ptr + _shortIndexesOffset, quad, sizeof(quad));
 	}
 
-	// create buffers
-	_vertexes = handle->getMemPool()->spawn(AllocationUsage::DeviceLocalHostVisible,
-			gl::BufferInfo(gl::BufferUsage::StorageBuffer, globalWritePlan.vertexes * sizeof(gl::Vertex_V4F_V4F_T2F2U)));
+	instanceOffset = 0;
+	for (auto &it : instances) {
+		writeInstances(it.second->quads, it.first, instanceOffset);
+		instanceOffset += it.second->instances;
+	}
+	_instances->unmap(_instancesMap, true);
 
-	_indexes = handle->getMemPool()->spawn(AllocationUsage::DeviceLocalHostVisible,
-			gl::BufferInfo(gl::BufferUsage::IndexBuffer, globalWritePlan.indexes * sizeof(uint32_t)));
+	if (uploadVertexes <= config::VertexUploadChunkSize) {
+		writeVertexes(tasks);
+		_vertexes->unmap(_vertexesMap, true);
+		_indexes->unmap(_indexesMap, true);
+		_transforms->unmap(_transformsMap, true);
+		return true;
+	}
 
-	auto vertexesMap = _vertexes->map();
-	auto indexesMap = _indexes->map();
+	// split tasks into chunks of roughly equal vertex count
+	_commands = commands;
+	_writeChunks = splitWriteTasks(tasks, config::VertexUploadChunkSize);
+	return true;
+}
 
-	uint32_t vertexOffset = 0;
-	uint32_t indexOffset = 0;
+void VertexMaterialAttachmentHandle::writeVertexes(SpanView<WriteTask> tasks) const {
+	writeVertexes(WriteTarget{_vertexesMap.ptr, _indexesMap.ptr, _transformsMap.ptr, _shortIndexesOffset, _vertexFormat}, tasks);
+}
 
-	for (auto &it : drawOrder) {
-		uint32_t materialVertexes = 0;
-		uint32_t materialIndexes = 0;
+void VertexMaterialAttachmentHandle::writeVertexes(const WriteTarget &target, SpanView<WriteTask> tasks) {
+	auto &kernels = getVertexKernels();
 
-		for (auto &cmd : it->second.commands) {
-			auto target = (gl::Vertex_V4F_V4F_T2F2U *)vertexesMap.ptr + vertexOffset;
-			memcpy(target, (uint8_t *)cmd->vertexes->data.data(),
-					cmd->vertexes->data.size() * sizeof(gl::Vertex_V4F_V4F_T2F2U));
+	for (auto &it : tasks) {
+		auto &data = it.cmd->vertexes->data;
+		auto &indexes = it.cmd->vertexes->indexes;
 
-			auto transform = cmd->transform;
+		// transformation performed in vertex shader, vertex only references it with object index
+		memcpy((Mat4 *)target.transforms + it.transformIndex, &it.cmd->transform, sizeof(Mat4));
 
-			size_t idx = 0;
-			for (auto &v : cmd->vertexes->data) {
-				target[idx].pos = transform * v.pos;
-				target[idx].material = it->first;
-				++ idx;
+		// copy (or convert) and stamp in single pass directly into mapped memory
+		if (it.writeVertexes) {
+			switch (target.format) {
+			case gl::VertexFormat::V4F_V4F_T2F2U: {
+				auto vertexes = (gl::Vertex_V4F_V4F_T2F2U *)target.vertexes + it.vertexOffset;
+				kernels.stampVertexes(vertexes, data.data(), data.size(), it.material, it.transformIndex);
+				break;
+			}
+			case gl::VertexFormat::V2F_C4B_T2H_2U: {
+				auto vertexes = (gl::Vertex_V2F_C4B_T2H_2U *)target.vertexes + it.vertexOffset;
+				for (auto &v : data) {
+					vertexes->pos = Vec2(v.pos.x, v.pos.y);
+					vertexes->color = VertexMaterialAttachment_packUnorm4x8(v.color.x, v.color.y, v.color.z, v.color.w);
+					vertexes->tex = VertexMaterialAttachment_packHalf2x16(v.tex.x, v.tex.y);
+					vertexes->material = it.material;
+					vertexes->object = it.transformIndex;
+					++ vertexes;
+				}
+				break;
+			}
+			case gl::VertexFormat::V3F_C4B_T2H_2U: {
+				auto vertexes = (gl::Vertex_V3F_C4B_T2H_2U *)target.vertexes + it.vertexOffset;
+				for (auto &v : data) {
+					vertexes->pos = Vec3(v.pos.x, v.pos.y, v.pos.z);
+					vertexes->color = VertexMaterialAttachment_packUnorm4x8(v.color.x, v.color.y, v.color.z, v.color.w);
+					vertexes->tex = VertexMaterialAttachment_packHalf2x16(v.tex.x, v.tex.y);
+					vertexes->material = it.material;
+					vertexes->object = it.transformIndex;
+					++ vertexes;
+				}
+				break;
 			}
+			}
+		}
+
+		if (it.shortIndexes) {
+			auto indexTarget = (uint16_t *)(target.indexes + target.shortIndexesOffset) + it.indexOffset;
+			kernels.rebaseShortIndexes(indexTarget, indexes.data(), indexes.size(), it.vertexOffset - it.indexBase);
+		} else {
+			auto indexTarget = (uint32_t *)target.indexes + it.indexOffset;
+			kernels.rebaseIndexes(indexTarget, indexes.data(), indexes.size(), it.vertexOffset);
+		}
+	}
+}
+
+Vector<Vector<VertexMaterialAttachmentHandle::WriteTask>> VertexMaterialAttachmentHandle::splitWriteTasks(
+		SpanView<WriteTask> tasks, uint32_t chunkSize) {
+	Vector<Vector<WriteTask>> ret;
+	uint32_t chunkVertexes = 0;
+	for (auto &it : tasks) {
+		if (ret.empty() || chunkVertexes >= chunkSize) {
+			ret.emplace_back();
+			chunkVertexes = 0;
+		}
+		ret.back().emplace_back(it);
+		if (it.writeVertexes) {
+			chunkVertexes += it.cmd->vertexes->data.size();
+		}
+	}
+	return ret;
+}
 
-			auto indexTarget = (uint32_t *)indexesMap.ptr + indexOffset;
+void VertexMaterialAttachmentHandle::writeInstances(SpanView<const gl::CmdQuadInstance *> quads,
+		uint32_t material, uint32_t offset) const {
+	auto target = (gl::QuadInstance *)_instancesMap.ptr + offset;
+	for (auto &it : quads) {
+		// only 2D part of transform is used, quad size is baked into axes
+		auto &m = it->transform.m;
+		target->transform = Vec4(m[0] * it->size.width, m[1] * it->size.width,
+				m[4] * it->size.height, m[5] * it->size.height);
+		target->origin = Vec2(m[12], m[13]);
+		target->color = VertexMaterialAttachment_packUnorm4x8(it->color.r, it->color.g, it->color.b, it->color.a);
+		target->material = material;
+		target->texCoords[0] = VertexMaterialAttachment_packUnorm2x16(it->texCoords.x, it->texCoords.y);
+		target->texCoords[1] = VertexMaterialAttachment_packUnorm2x16(it->texCoords.z, it->texCoords.w);
+		target->padding[0] = target->padding[1] = 0;
+		++ target;
+	}
+}
 
-			idx = 0;
-			for (auto &it : cmd->vertexes->indexes) {
-				indexTarget[idx] = it + vertexOffset;
-				++ idx;
+void VertexMaterialAttachmentHandle::scheduleWriteChunks(gl::FrameHandle &handle) {
+	// chunks write into non-overlapping regions of mapped buffers, so no synchronization required
+	// completion callbacks are called on GL thread, so, counter is not atomic
+	_pendingWriteChunks = _writeChunks.size();
+	for (auto &it : _writeChunks) {
+		handle.performInQueue([this, chunk = &it] (gl::FrameHandle &) {
+			writeVertexes(*chunk);
+			return true;
+		}, [this] (gl::FrameHandle &handle, bool success) {
+			if (!success) {
+				_writeFailed = true;
+			}
+			-- _pendingWriteChunks;
+			if (_pendingWriteChunks == 0) {
+				_vertexes->unmap(_vertexesMap, true);
+				_indexes->unmap(_indexesMap, true);
+				_transforms->unmap(_transformsMap, true);
+				_writeChunks.clear();
+				_commands = nullptr;
+				if (_writeFailed) {
+					handle.invalidate();
+				} else {
+					handle.setInputSubmitted(this);
+				}
 			}
+		}, this, "VertexMaterialAttachmentHandle::scheduleWriteChunks");
+	}
+}
 
-			vertexOffset += cmd->vertexes->data.size();
-			indexOffset += cmd->vertexes->indexes.size();
+MaterialTransformAttachment::~MaterialTransformAttachment() { }
 
-			materialVertexes += cmd->vertexes->data.size();
-			materialIndexes += cmd->vertexes->indexes.size();
-		}
+bool MaterialTransformAttachment::init(StringView name, const gl::BufferInfo &info, const VertexMaterialAttachment *v) {
+	if (BufferAttachment::init(name, info)) {
+		_vertexes = v;
+		return true;
+	}
+	return false;
+}
+
+Rc<gl::AttachmentHandle> MaterialTransformAttachment::makeFrameHandle(const gl::FrameHandle &handle) {
+	return Rc<MaterialTransformAttachmentHandle>::create(this, handle);
+}
 
-		_spans.emplace_back(gl::VertexSpan({ it->first, materialIndexes, 1, indexOffset - materialIndexes}));
+MaterialTransformAttachmentHandle::~MaterialTransformAttachmentHandle() { }
+
+bool MaterialTransformAttachmentHandle::setup(gl::FrameHandle &handle) {
+	for (auto &it : handle.getRequiredAttachments()) {
+		if (it->getAttachment() == ((MaterialTransformAttachment *)_attachment.get())->getVertexes()) {
+			_vertexes = (const VertexMaterialAttachmentHandle *)it.get();
+			break;
+		}
 	}
+	return true;
+}
 
-	_vertexes->unmap(vertexesMap, true);
-	_vertexes->unmap(indexesMap, true);
+bool MaterialTransformAttachmentHandle::isDescriptorDirty(const gl::RenderPassHandle &, const gl::PipelineDescriptor &,
+		uint32_t, bool isExternal) const {
+	return _vertexes && _vertexes->getTransforms();
+}
 
+bool MaterialTransformAttachmentHandle::writeDescriptor(const RenderPassHandle &, const gl::PipelineDescriptor &,
+		uint32_t, bool, VkDescriptorBufferInfo &info) {
+	auto &transforms = _vertexes->getTransforms();
+	info.buffer = transforms->getBuffer();
+	info.offset = 0;
+	info.range = transforms->getSize();
+	return true;
+}
+
+MaterialInstanceAttachment::~MaterialInstanceAttachment() { }
+
+Rc<gl::AttachmentHandle> MaterialInstanceAttachment::makeFrameHandle(const gl::FrameHandle &handle) {
+	return Rc<MaterialInstanceAttachmentHandle>::create(this, handle);
+}
+
+MaterialInstanceAttachmentHandle::~MaterialInstanceAttachmentHandle() { }
+
+bool MaterialInstanceAttachmentHandle::isDescriptorDirty(const gl::RenderPassHandle &, const gl::PipelineDescriptor &,
+		uint32_t, bool isExternal) const {
+	return _vertexes && _vertexes->getInstances();
+}
+
+bool MaterialInstanceAttachmentHandle::writeDescriptor(const RenderPassHandle &, const gl::PipelineDescriptor &,
+		uint32_t, bool, VkDescriptorBufferInfo &info) {
+	auto &instances = _vertexes->getInstances();
+	info.buffer = instances->getBuffer();
+	info.offset = 0;
+	info.range = instances->getSize();
 	return true;
 }
 
@@ -298,7 +708,7 @@ Vector<VkCommandBuffer> MaterialRenderPassHandle::doPrepareCommands(gl::FrameHan
 	auto table = _device->getTable();
 	auto buf = _pool->allocBuffer(*_device);
 
-	auto targetFb = _data->framebuffers[index].cast<Framebuffer>();
+	auto &targetFb = _framebuffer;
 	auto currentExtent = targetFb->getExtent();
 
 	auto materials = _materialBuffer->getMaterials().get();
@@ -325,22 +735,35 @@ Vector<VkCommandBuffer> MaterialRenderPassHandle::doPrepareCommands(gl::FrameHan
 			outputImageBarriers.size(), outputImageBarriers.data());
 	}
 
+	auto pass = _data->impl.cast<RenderPassImpl>();
+
+	// with partial redraw, image content is loaded, and only damaged area is cleared and drawn
+	VkRect2D renderArea{ { 0, 0 }, { currentExtent.width, currentExtent.height } };
+	_partialRedraw = pass->getLoadRenderPass() != VK_NULL_HANDLE && getRedrawArea(handle, index, currentExtent, renderArea);
+	_redrawRegion = URect{uint32_t(renderArea.offset.x), uint32_t(renderArea.offset.y),
+		renderArea.extent.width, renderArea.extent.height};
+
 	VkRenderPassBeginInfo renderPassInfo { };
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	renderPassInfo.renderPass = _data->impl.cast<RenderPassImpl>()->getRenderPass();
+	renderPassInfo.renderPass = _partialRedraw ? pass->getLoadRenderPass() : pass->getRenderPass();
 	renderPassInfo.framebuffer = targetFb->getFramebuffer();
-	renderPassInfo.renderArea.offset = { 0, 0 };
-	renderPassInfo.renderArea.extent = VkExtent2D{currentExtent.width, currentExtent.height};
+	renderPassInfo.renderArea = renderArea;
 	VkClearValue clearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
 	renderPassInfo.clearValueCount = 1;
 	renderPassInfo.pClearValues = &clearColor;
 	table->vkCmdBeginRenderPass(buf, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
+	if (_partialRedraw) {
+		VkClearAttachment clearAttachment{ VK_IMAGE_ASPECT_COLOR_BIT, pass->getLoadColorAttachment(), clearColor };
+		VkClearRect clearRect{ renderArea, 0, 1 };
+		table->vkCmdClearAttachments(buf, 1, &clearAttachment, 1, &clearRect);
+	}
+
 	VkViewport viewport{ 0.0f, 0.0f, float(currentExtent.width), float(currentExtent.height), 0.0f, 1.0f };
 	table->vkCmdSetViewport(buf, 0, 1, &viewport);
 
-	VkRect2D scissorRect{ { 0, 0}, { currentExtent.width, currentExtent.height } };
-	table->vkCmdSetScissor(buf, 0, 1, &scissorRect);
+	// whole scene is recorded, fragments outside of redraw area are discarded with scissor
+	table->vkCmdSetScissor(buf, 0, 1, &renderArea);
 
 	prepareMaterialCommands(materials, handle, buf);
 
@@ -351,6 +774,52 @@ Vector<VkCommandBuffer> MaterialRenderPassHandle::doPrepareCommands(gl::FrameHan
 	return Vector<VkCommandBuffer>();
 }
 
+bool MaterialRenderPassHandle::doSubmit(gl::FrameHandle &frame) {
+	if (!RenderPassHandle::doSubmit(frame)) {
+		return false;
+	}
+
+	// retained vertex regions, used by this frame, can be reused only when fence is signaled
+	if (_vertexBuffer && _vertexBuffer->getCacheLock()) {
+		_fence->addRelease([lock = _vertexBuffer->getCacheLock()] { });
+	}
+	return true;
+}
+
+bool MaterialRenderPassHandle::getRedrawArea(gl::FrameHandle &frame, uint32_t index, const Extent2 &extent, VkRect2D &area) {
+	if (!_swapchain || !_swapchainHandle || !_vertexBuffer) {
+		return false;
+	}
+
+	URect damage;
+	auto &rect = _vertexBuffer->getDamage();
+	if (!_vertexBuffer->isFullDamage() && rect.size.width > 0.0f && rect.size.height > 0.0f) {
+		// root space is in normalized device coordinates, margin covers rounding and antialiasing
+		auto minX = std::clamp(std::floor((rect.origin.x + 1.0f) * 0.5f * extent.width) - 1.0f, 0.0f, float(extent.width));
+		auto minY = std::clamp(std::floor((rect.origin.y + 1.0f) * 0.5f * extent.height) - 1.0f, 0.0f, float(extent.height));
+		auto maxX = std::clamp(std::ceil((rect.origin.x + rect.size.width + 1.0f) * 0.5f * extent.width) + 1.0f, 0.0f, float(extent.width));
+		auto maxY = std::clamp(std::ceil((rect.origin.y + rect.size.height + 1.0f) * 0.5f * extent.height) + 1.0f, 0.0f, float(extent.height));
+		damage = URect{uint32_t(minX), uint32_t(minY), uint32_t(maxX - minX), uint32_t(maxY - minY)};
+	}
+
+	URect region;
+	if (!_swapchain->getRedrawRegion(_swapchainHandle, index, frame.getOrder(), damage, _vertexBuffer->isFullDamage(), region)) {
+		return false;
+	}
+
+	if (float(region.width) * float(region.height) > config::PartialRedrawMaxArea * float(extent.width) * float(extent.height)) {
+		return false;
+	}
+
+	// render area should not be empty; nothing was changed, so any single pixel can be redrawn
+	if (region.width == 0 || region.height == 0) {
+		region = URect{0, 0, 1, 1};
+	}
+
+	area = VkRect2D{ { int32_t(region.x), int32_t(region.y) }, { region.width, region.height } };
+	return true;
+}
+
 void MaterialRenderPassHandle::prepareMaterialCommands(gl::MaterialSet * materials, gl::FrameHandle &handle, VkCommandBuffer &buf) {
 	if (!_vertexBuffer->getIndexes() || !_vertexBuffer->getVertexes()) {
 		return;
@@ -368,29 +837,76 @@ void MaterialRenderPassHandle::prepareMaterialCommands(gl::MaterialSet * materia
 		0, nullptr // dynamic offsets
 	);
 
-	// bind global indexes
+	// bind global indexes, 16-bit index region is bound on demand
 	auto idx = _vertexBuffer->getIndexes()->getBuffer();
 	table->vkCmdBindIndexBuffer(buf, idx, 0, VK_INDEX_TYPE_UINT32);
+	bool boundShortIndexes = false;
 
 	uint32_t boundTextureSetIndex = maxOf<uint32_t>();
 	gl::Pipeline *boundPipeline = nullptr;
 
+	// spans are sorted by pipeline and texture set, and written contiguously into index buffer,
+	// so, consecutive spans with same state are merged into single draw call
+	// instanced spans share unit quad indexes, and merged when their instance ranges are contiguous
+	uint32_t drawFirstIndex = 0;
+	uint32_t drawIndexCount = 0;
+	uint32_t drawFirstInstance = 0;
+	uint32_t drawInstanceCount = 1;
+	int32_t drawVertexOffset = 0;
+	bool drawShortIndexes = false;
+
+	auto flushDraw = [&] {
+		if (drawIndexCount > 0) {
+			if (drawShortIndexes != boundShortIndexes) {
+				if (drawShortIndexes) {
+					table->vkCmdBindIndexBuffer(buf, idx, _vertexBuffer->getShortIndexesOffset(), VK_INDEX_TYPE_UINT16);
+				} else {
+					table->vkCmdBindIndexBuffer(buf, idx, 0, VK_INDEX_TYPE_UINT32);
+				}
+				boundShortIndexes = drawShortIndexes;
+			}
+
+			table->vkCmdDrawIndexed(buf,
+					drawIndexCount, // indexCount
+					drawInstanceCount, // instanceCount
+					drawFirstIndex, // firstIndex
+					drawVertexOffset, // int32_t   vertexOffset
+					drawFirstInstance  // uint32_t  firstInstance
+			);
+			++ _drawStat.draws;
+			if (drawFirstInstance > 0) {
+				_drawStat.instances += drawInstanceCount;
+			}
+			if (drawShortIndexes) {
+				++ _drawStat.shortIndexDraws;
+			}
+			drawIndexCount = 0;
+		}
+	};
+
+	_drawStat = DrawStat();
+	auto t = platform::device::_clock();
+
 	for (auto &materialVertexSpan : _vertexBuffer->getVertexData()) {
-		auto materialOrderIdx = materials->getMaterialOrder(materialVertexSpan.material);
 		auto material = materials->getMaterialById(materialVertexSpan.material);
 		if (!material) {
 			continue;
 		}
 
+		++ _drawStat.spans;
+
 		auto pipeline = material->getPipeline()->pipeline;
 		auto textureSetIndex =  material->getLayoutIndex();
 
 		if (pipeline != boundPipeline) {
+			flushDraw();
 			table->vkCmdBindPipeline(buf, VK_PIPELINE_BIND_POINT_GRAPHICS, ((Pipeline *)pipeline.get())->getPipeline());
 			boundPipeline = pipeline;
+			++ _drawStat.pipelineChanges;
 		}
 
 		if (textureSetIndex != boundTextureSetIndex) {
+			flushDraw();
 			if (auto l = materials->getLayout(textureSetIndex)) {
 				auto s = (TextureSet *)l->set.get();
 				auto set = s->getSet();
@@ -401,23 +917,52 @@ void MaterialRenderPassHandle::prepareMaterialCommands(gl::MaterialSet * materia
 					0, nullptr // dynamic offsets
 				);
 				boundTextureSetIndex = textureSetIndex;
+				++ _drawStat.textureSetChanges;
 			} else {
 				stappler::log::vtext("MaterialRenderPassHandle", "Invalid textureSetlayout: ", textureSetIndex);
 				return;
 			}
 		}
 
-		table->vkCmdPushConstants(buf, pass->getPipelineLayout(),
-				VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uint32_t), &materialOrderIdx);
+		// spans can be merged only within same index region and with same base vertex
+		bool isInstanced = materialVertexSpan.firstInstance > 0;
+		if (drawIndexCount > 0) {
+			bool canMerge = drawShortIndexes == materialVertexSpan.shortIndexes
+					&& drawVertexOffset == materialVertexSpan.vertexOffset;
+			if (isInstanced) {
+				canMerge = canMerge && drawFirstInstance > 0
+						&& drawFirstInstance + drawInstanceCount == materialVertexSpan.firstInstance;
+			} else {
+				canMerge = canMerge && drawFirstInstance == 0
+						&& drawFirstIndex + drawIndexCount == materialVertexSpan.firstIndex;
+			}
+			if (!canMerge) {
+				flushDraw();
+			}
+		}
 
-		table->vkCmdDrawIndexed(buf,
-				materialVertexSpan.indexCount, // indexCount
-				materialVertexSpan.instanceCount, // instanceCount
-				materialVertexSpan.firstIndex, // firstIndex
-				0, // int32_t   vertexOffset
-				0  // uint32_t  firstInstance
-		);
+		if (drawIndexCount == 0) {
+			drawFirstIndex = materialVertexSpan.firstIndex;
+			drawIndexCount = materialVertexSpan.indexCount;
+			drawFirstInstance = materialVertexSpan.firstInstance;
+			drawInstanceCount = materialVertexSpan.instanceCount;
+			drawVertexOffset = materialVertexSpan.vertexOffset;
+			drawShortIndexes = materialVertexSpan.shortIndexes;
+		} else if (isInstanced) {
+			drawInstanceCount += materialVertexSpan.instanceCount;
+		} else {
+			drawIndexCount += materialVertexSpan.indexCount;
+		}
 	}
+
+	flushDraw();
+
+	_drawStat.recordTime = platform::device::_clock() - t;
+
+	XL_VK_LOG("MaterialRenderPassHandle: spans: ", _drawStat.spans, " draws: ", _drawStat.draws,
+			" instances: ", _drawStat.instances, " short index draws: ", _drawStat.shortIndexDraws,
+			" pipelines: ", _drawStat.pipelineChanges, " texture sets: ", _drawStat.textureSetChanges,
+			" record time: ", _drawStat.recordTime);
 }
 
 void MaterialRenderPassHandle::doFinalizeTransfer(gl::MaterialSet * materials, VkCommandBuffer buf,
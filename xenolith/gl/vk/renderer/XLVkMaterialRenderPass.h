@@ -25,6 +25,8 @@
 
 #include "XLVkRenderPass.h"
 #include "XLVkBufferAttachment.h"
+#include "XLVkBuffer.h"
+#include "XLVkVertexCache.h"
 
 namespace stappler::xenolith::vk {
 
@@ -61,14 +63,24 @@ class VertexMaterialAttachment : public BufferAttachment {
 public:
 	virtual ~VertexMaterialAttachment();
 
-	virtual bool init(StringView, const gl::BufferInfo &, const MaterialVertexAttachment *);
+	// shaders of pipelines, that use this attachment, should match vertex format
+	virtual bool init(StringView, const gl::BufferInfo &, const MaterialVertexAttachment *,
+			gl::VertexFormat = gl::VertexFormat::V4F_V4F_T2F2U);
 
 	const MaterialVertexAttachment *getMaterials() const { return _materials; }
+	gl::VertexFormat getVertexFormat() const { return _vertexFormat; }
+
+	// retained vertex storage, shared between frames; created on first use
+	Rc<VertexCache> getVertexCache(Device &) const;
 
 protected:
 	virtual Rc<gl::AttachmentHandle> makeFrameHandle(const gl::FrameHandle &) override;
 
 	const MaterialVertexAttachment *_materials = nullptr;
+	gl::VertexFormat _vertexFormat = gl::VertexFormat::V4F_V4F_T2F2U;
+
+	mutable Mutex _cacheMutex;
+	mutable Rc<VertexCache> _cache;
 };
 
 class VertexMaterialAttachmentHandle : public BufferAttachmentHandle {
@@ -88,17 +100,130 @@ public:
 	const Vector<gl::VertexSpan> &getVertexData() const { return _spans; }
 	const Rc<DeviceBuffer> &getVertexes() const { return _vertexes; }
 	const Rc<DeviceBuffer> &getIndexes() const { return _indexes; }
+	VkDeviceSize getShortIndexesOffset() const { return _shortIndexesOffset; }
+	const Rc<DeviceBuffer> &getTransforms() const { return _transforms; }
+	const Rc<DeviceBuffer> &getInstances() const { return _instances; }
+	const VertexCache::Stat &getCacheStat() const { return _cacheStat; }
+	const Rc<VertexCache::Lock> &getCacheLock() const { return _cacheLock; }
+
+	// damage of frame's command list, in root space (normalized device coordinates)
+	const Rect &getDamage() const { return _damage; }
+	bool isFullDamage() const { return _fullDamage; }
+
+	// target region for single vertex array command
+	struct WriteTask {
+		const gl::CmdVertexArray *cmd;
+		uint32_t material; // material index within MaterialSet
+		uint32_t transformIndex; // index in transforms buffer, stamped as vertex object
+		uint32_t vertexOffset;
+		uint32_t indexOffset; // in elements of span's index type
+		uint32_t indexBase; // subtracted from 16-bit indexes, span is drawn with it as vertexOffset
+		bool shortIndexes;
+		bool writeVertexes; // false if vertexes are retained in cache
+	};
+
+	// mapped buffers of vertex upload
+	struct WriteTarget {
+		uint8_t *vertexes;
+		uint8_t *indexes;
+		uint8_t *transforms;
+		VkDeviceSize shortIndexesOffset; // in bytes
+		gl::VertexFormat format;
+	};
+
+	// can be called from any thread, tasks should not overlap
+	static void writeVertexes(const WriteTarget &, SpanView<WriteTask>);
+
+	// chunks of roughly chunkSize written vertexes, chunk boundaries are on command boundaries
+	static Vector<Vector<WriteTask>> splitWriteTasks(SpanView<WriteTask>, uint32_t chunkSize);
 
 protected:
 	virtual bool loadVertexes(gl::FrameHandle &, const Rc<gl::CommandList> &);
 
+	// writes into mapped buffers of this handle
+	virtual void writeVertexes(SpanView<WriteTask>) const;
+
+	// schedule chunk writes on loop's queue, input submitted when all chunks are written
+	virtual void scheduleWriteChunks(gl::FrameHandle &);
+
+	// pack instanced quad commands into mapped instance buffer
+	virtual void writeInstances(SpanView<const gl::CmdQuadInstance *>, uint32_t material, uint32_t offset) const;
+
 	Rc<DeviceBuffer> _indexes;
 	Rc<DeviceBuffer> _vertexes;
+	Rc<DeviceBuffer> _transforms;
+	Rc<DeviceBuffer> _instances;
 	Vector<gl::VertexSpan> _spans;
+	VkDeviceSize _shortIndexesOffset = 0; // in bytes, 16-bit indexes are placed after 32-bit ones
+	gl::VertexFormat _vertexFormat = gl::VertexFormat::V4F_V4F_T2F2U;
+
+	Rc<gl::CommandList> _commands;
+	DeviceBuffer::MappedRegion _vertexesMap;
+	DeviceBuffer::MappedRegion _indexesMap;
+	DeviceBuffer::MappedRegion _transformsMap;
+	DeviceBuffer::MappedRegion _instancesMap;
+	Vector<Vector<WriteTask>> _writeChunks;
+	size_t _pendingWriteChunks = 0;
+	bool _writeFailed = false;
+	VertexCache::Stat _cacheStat;
+	Rc<VertexCache::Lock> _cacheLock;
+	Rect _damage;
+	bool _fullDamage = true;
 
 	const MaterialVertexAttachmentHandle *_materials = nullptr;
 };
 
+// this attachment provides per-command transformation matrices, referenced by vertex object index
+class MaterialTransformAttachment : public BufferAttachment {
+public:
+	virtual ~MaterialTransformAttachment();
+
+	virtual bool init(StringView, const gl::BufferInfo &, const VertexMaterialAttachment *);
+
+	const VertexMaterialAttachment *getVertexes() const { return _vertexes; }
+
+protected:
+	virtual Rc<gl::AttachmentHandle> makeFrameHandle(const gl::FrameHandle &) override;
+
+	const VertexMaterialAttachment *_vertexes = nullptr;
+};
+
+class MaterialTransformAttachmentHandle : public BufferAttachmentHandle {
+public:
+	virtual ~MaterialTransformAttachmentHandle();
+
+	virtual bool setup(gl::FrameHandle &);
+
+	virtual bool isDescriptorDirty(const gl::RenderPassHandle &, const gl::PipelineDescriptor &,
+			uint32_t, bool isExternal) const override;
+
+	virtual bool writeDescriptor(const RenderPassHandle &, const gl::PipelineDescriptor &,
+			uint32_t, bool, VkDescriptorBufferInfo &) override;
+
+protected:
+	const VertexMaterialAttachmentHandle *_vertexes = nullptr;
+};
+
+// this attachment provides per-instance data for instanced quads, filled with vertex input
+class MaterialInstanceAttachment : public MaterialTransformAttachment {
+public:
+	virtual ~MaterialInstanceAttachment();
+
+protected:
+	virtual Rc<gl::AttachmentHandle> makeFrameHandle(const gl::FrameHandle &) override;
+};
+
+class MaterialInstanceAttachmentHandle : public MaterialTransformAttachmentHandle {
+public:
+	virtual ~MaterialInstanceAttachmentHandle();
+
+	virtual bool isDescriptorDirty(const gl::RenderPassHandle &, const gl::PipelineDescriptor &,
+			uint32_t, bool isExternal) const override;
+
+	virtual bool writeDescriptor(const RenderPassHandle &, const gl::PipelineDescriptor &,
+			uint32_t, bool, VkDescriptorBufferInfo &) override;
+};
+
 class MaterialRenderPass : public RenderPass {
 public:
 	virtual bool init(StringView, gl::RenderOrdering, size_t subpassCount = 1);
@@ -117,16 +242,33 @@ protected:
 
 class MaterialRenderPassHandle : public RenderPassHandle {
 public:
+	struct DrawStat {
+		uint32_t spans = 0;
+		uint32_t draws = 0;
+		uint32_t instances = 0;
+		uint32_t shortIndexDraws = 0;
+		uint32_t pipelineChanges = 0;
+		uint32_t textureSetChanges = 0;
+		uint64_t recordTime = 0; // microseconds
+	};
+
+	const DrawStat &getDrawStat() const { return _drawStat; }
+
 protected:
 	virtual void addRequiredAttachment(const gl::Attachment *a, const Rc<gl::AttachmentHandle> &h) override;
 	virtual Vector<VkCommandBuffer> doPrepareCommands(gl::FrameHandle &, uint32_t index) override;
+	virtual bool doSubmit(gl::FrameHandle &) override;
 	virtual void prepareMaterialCommands(gl::MaterialSet * materials, gl::FrameHandle &, VkCommandBuffer &);
 
+	// region of swapchain image to redraw with frame's damage, false for full redraw
+	virtual bool getRedrawArea(gl::FrameHandle &, uint32_t index, const Extent2 &, VkRect2D &);
+
 	virtual void doFinalizeTransfer(gl::MaterialSet * materials, VkCommandBuffer,
 			Vector<VkImageMemoryBarrier> &outputImageBarriers, Vector<VkBufferMemoryBarrier> &outputBufferBarriers);
 
 	VertexMaterialAttachmentHandle *_vertexBuffer = nullptr;
 	MaterialVertexAttachmentHandle *_materialBuffer = nullptr;
+	DrawStat _drawStat;
 };
 
 }
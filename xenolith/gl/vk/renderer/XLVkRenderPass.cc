@@ -82,6 +82,9 @@ void RenderPassHandle::invalidate() {
 	_sync.waitStages.clear();
 	_sync.signalSem.clear();
 	_sync.signalAttachment.clear();
+
+	_framebuffer = nullptr;
+	_swapchainHandle = nullptr;
 }
 
 bool RenderPassHandle::prepare(gl::FrameHandle &frame) {
@@ -98,6 +101,7 @@ bool RenderPassHandle::prepare(gl::FrameHandle &frame) {
 		if (it.first->getType() == gl::AttachmentType::SwapchainImage) {
 			auto img = it.second.cast<SwapchainAttachmentHandle>();
 			index = img->getIndex();
+			_swapchainHandle = img->getSwapchainHandle();
 		}
 	}
 
@@ -106,6 +110,12 @@ bool RenderPassHandle::prepare(gl::FrameHandle &frame) {
 		return false;
 	}
 
+	// framebuffers can be replaced with swapchain recreation, use one, captured on GL thread;
+	// they are owned by frame's swapchain, queue can be shared between swapchains
+	if (_swapchain) {
+		_framebuffer = _swapchain->getFramebuffer(_data, index);
+	}
+
 	// If updateAfterBind feature supported for all renderpass bindings
 	// - we can use separate thread to update them
 	// (ordering of bind|update is not defined in this case)
@@ -163,6 +173,17 @@ void RenderPassHandle::submit(gl::FrameHandle &frame, Function<void(const Rc<gl:
 	_fence->addRelease([func = move(func), pass = _renderPass] {
 		func(pass);
 	});
+	_fence->addRelease([fb = _framebuffer, swapchain = _swapchainHandle] { });
+
+	if (_data->isPresentable && _swapchain) {
+		// frame cost should include GPU time, so it's sampled when fence is signaled, not on present;
+		// release callbacks are also called on reset of unsignaled fence, those are skipped
+		_fence->addRelease([fence = _fence.get(), swapchain = Rc<Swapchain>(_swapchain), start = frame.getTimeStart()] {
+			if (fence->isSignaled()) {
+				swapchain->addFrameCost(platform::device::_clock() - start);
+			}
+		});
+	}
 
 	_pool = nullptr;
 	_sync = makeSyncInfo();
@@ -415,7 +436,7 @@ Vector<VkCommandBuffer> RenderPassHandle::doPrepareCommands(gl::FrameHandle &fra
 	auto table = _device->getTable();
 	auto buf = _pool->allocBuffer(*_device);
 
-	auto targetFb = _data->framebuffers[index].cast<Framebuffer>();
+	auto &targetFb = _framebuffer;
 	auto currentExtent = targetFb->getExtent();
 
 	VkCommandBufferBeginInfo beginInfo { };
@@ -501,13 +522,43 @@ bool RenderPassHandle::present(gl::FrameHandle &frame) {
 	presentInfo.waitSemaphoreCount = presentSem.size();
 	presentInfo.pWaitSemaphores = presentSem.data();
 
-	VkSwapchainKHR swapChains[] = {_presentAttachment->getSwapchain()->getSwapchain()};
+	VkSwapchainKHR swapChains[] = {_presentAttachment->getSwapchainHandle()->getSwapchain()};
 	presentInfo.swapchainCount = 1;
 	presentInfo.pSwapchains = swapChains;
 	presentInfo.pImageIndices = &imageIndex;
 	presentInfo.pResults = nullptr; // Optional
 
-	// auto t = platform::device::_clock();
+	auto presentTime = platform::device::_clock();
+	auto presentId = _swapchain->registerPresent(frame);
+	auto presentWaitId = _swapchain->acquirePresentWaitId();
+
+#if defined(VK_GOOGLE_display_timing)
+	VkPresentTimeGOOGLE presentTimeInfo{presentId, 0};
+	VkPresentTimesInfoGOOGLE presentTimesInfo{VK_STRUCTURE_TYPE_PRESENT_TIMES_INFO_GOOGLE, nullptr, 1, &presentTimeInfo};
+	if (presentId) {
+		presentTimesInfo.pNext = presentInfo.pNext;
+		presentInfo.pNext = &presentTimesInfo;
+	}
+#endif
+
+#if defined(VK_KHR_present_wait)
+	VkPresentIdKHR presentIdInfo{VK_STRUCTURE_TYPE_PRESENT_ID_KHR, nullptr, 1, &presentWaitId};
+	if (presentWaitId) {
+		presentIdInfo.pNext = presentInfo.pNext;
+		presentInfo.pNext = &presentIdInfo;
+	}
+#endif
+
+#if defined(VK_KHR_incremental_present)
+	VkRectLayerKHR presentRect{{int32_t(_redrawRegion.x), int32_t(_redrawRegion.y)}, {_redrawRegion.width, _redrawRegion.height}, 0};
+	VkPresentRegionKHR presentRegion{1, &presentRect};
+	VkPresentRegionsKHR presentRegions{VK_STRUCTURE_TYPE_PRESENT_REGIONS_KHR, nullptr, 1, &presentRegion};
+	if (_partialRedraw && _swapchain->hasIncrementalPresent()) {
+		presentRegions.pNext = presentInfo.pNext;
+		presentInfo.pNext = &presentRegions;
+	}
+#endif
+
 	auto result = table->vkQueuePresentKHR(_queue->getQueue(), &presentInfo);
 	if (result == VK_ERROR_OUT_OF_DATE_KHR) {
 		frame.performOnGlThread([this] (gl::FrameHandle &frame) {
@@ -518,6 +569,13 @@ bool RenderPassHandle::present(gl::FrameHandle &frame) {
 		for (auto &it : _sync.signalSwapchainSync) {
 			it->getRenderFinished()->setSignaled(false);
 		}
+		_swapchain->setImagePresented(_presentAttachment->getSwapchainHandle(), imageIndex, frame.getOrder());
+		if (presentWaitId) {
+			_swapchain->waitForPresent(frame, _presentAttachment->getSwapchainHandle(), presentWaitId);
+		} else if (!_swapchain->hasDisplayTiming()) {
+			_swapchain->addPresentEstimate(frame, presentTime);
+		}
+		_swapchain->updatePresentTiming(*_device, swapChains[0]);
 		return true;
 	} else {
 		log::vtext("VK-Error", "Fail to vkQueuePresentKHR: ", result);
@@ -630,7 +688,7 @@ Vector<VkCommandBuffer> VertexRenderPassHandle::doPrepareCommands(gl::FrameHandl
 	auto buf = _pool->allocBuffer(*_device);
 	auto pass = (RenderPassImpl *)_data->impl.get();
 
-	auto targetFb = _data->framebuffers[index].cast<Framebuffer>();
+	auto &targetFb = _framebuffer;
 	auto currentExtent = targetFb->getExtent();
 
 	VkCommandBufferBeginInfo beginInfo { };
@@ -29,6 +29,8 @@
 namespace stappler::xenolith::vk {
 
 class Device;
+class Framebuffer;
+class SwapchainHandle;
 
 class RenderPass : public gl::RenderPass {
 public:
@@ -98,6 +100,14 @@ protected:
 
 	Rc<SwapchainAttachmentHandle> _presentAttachment;
 	Sync _sync;
+
+	// retained until frame's fence is signaled, so swapchain recreation does not need to wait for device
+	Rc<Framebuffer> _framebuffer;
+	Rc<SwapchainHandle> _swapchainHandle;
+
+	// region of swapchain image, redrawn by frame, for incremental present; whole image, if not set
+	URect _redrawRegion;
+	bool _partialRedraw = false;
 };
 
 class VertexRenderPass : public RenderPass {
@@ -333,6 +333,10 @@ bool TransferResource::compile() {
 	}
 
 	_memory = VK_NULL_HANDLE;
+
+	// resource objects are available for frames now
+	markSceneDirty();
+
 	if (_callback) {
 		_callback(true);
 		_callback = nullptr;
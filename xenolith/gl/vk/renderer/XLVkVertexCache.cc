@@ -0,0 +1,323 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLVkVertexCache.h"
+#include "XLVkDevice.h"
+
+namespace stappler::xenolith::vk {
+
+void VertexRegionAllocator::reset(uint32_t capacity) {
+	_capacity = capacity;
+	_slots = 0;
+	_free.clear();
+	_freeSlots.clear();
+	if (_capacity > 0) {
+		_free.emplace(0, _capacity);
+	}
+}
+
+bool VertexRegionAllocator::allocate(uint32_t size, Block &block) {
+	block.offset = 0;
+	block.size = size;
+
+	// empty data takes only object slot; splitting free block with zero size would drop it from the list
+	if (size > 0) {
+		// first fit
+		auto it = _free.begin();
+		while (it != _free.end() && it->second < size) {
+			++ it;
+		}
+
+		if (it == _free.end()) {
+			return false;
+		}
+
+		block.offset = it->first;
+
+		auto next = it->first + size;
+		auto rest = it->second - size;
+		_free.erase(it);
+		if (rest > 0) {
+			_free.emplace(next, rest);
+		}
+	}
+
+	if (!_freeSlots.empty()) {
+		block.slot = _freeSlots.back();
+		_freeSlots.pop_back();
+	} else {
+		block.slot = _slots ++;
+	}
+
+	return true;
+}
+
+void VertexRegionAllocator::free(const Block &block) {
+	_freeSlots.emplace_back(block.slot);
+
+	if (block.size == 0) {
+		return;
+	}
+
+	auto it = _free.emplace(block.offset, block.size).first;
+
+	// merge with next block
+	auto next = std::next(it);
+	if (next != _free.end() && it->first + it->second == next->first) {
+		it->second += next->second;
+		_free.erase(next);
+	}
+
+	// merge with previous block
+	if (it != _free.begin()) {
+		auto prev = std::prev(it);
+		if (prev->first + prev->second == it->first) {
+			prev->second += it->second;
+			_free.erase(it);
+		}
+	}
+}
+
+uint32_t VertexRegionAllocator::getFreeSize() const {
+	uint32_t ret = 0;
+	for (auto &it : _free) {
+		ret += it.second;
+	}
+	return ret;
+}
+
+VertexCache::Lock::~Lock() {
+	if (_cache) {
+		_cache->unlock(_frame);
+	}
+}
+
+bool VertexCache::Lock::init(VertexCache *cache, uint64_t frame) {
+	_cache = cache;
+	_frame = frame;
+	return true;
+}
+
+VertexCache::~VertexCache() {
+	_entries.clear();
+	_retiredBuffers.clear();
+	_buffer = nullptr;
+	_pool = nullptr;
+}
+
+bool VertexCache::init(Device &dev, gl::VertexFormat format) {
+	_device = &dev;
+	_format = format;
+	_vertexSize = gl::getVertexFormatSize(format);
+	_pool = Rc<DeviceMemoryPool>::create(dev.getAllocator(), true);
+	return true;
+}
+
+Rc<VertexCache::Lock> VertexCache::lock(uint64_t frame) {
+	do {
+		std::unique_lock<Mutex> lock(_mutex);
+		++ _locked[frame];
+	} while (0);
+
+	return Rc<Lock>::create(this, frame);
+}
+
+void VertexCache::unlock(uint64_t frame) {
+	std::unique_lock<Mutex> lock(_mutex);
+	auto it = _locked.find(frame);
+	if (it != _locked.end()) {
+		if (-- it->second == 0) {
+			_locked.erase(it);
+		}
+	}
+}
+
+Rc<DeviceBuffer> VertexCache::acquire(const Lock &frameLock, SpanView<Request> requests, Vector<Result> &results,
+		uint32_t &slots, Stat &stat) {
+	std::unique_lock<Mutex> lock(_mutex);
+
+	auto frame = frameLock.getFrame();
+
+	release(frame);
+
+	uint32_t required = 0;
+	for (auto &it : requests) {
+		required += (*it.data)->data.size();
+	}
+
+	if (!_buffer || _capacity < required) {
+		reset(frame, required);
+	}
+
+	// second attempt performed on empty buffer with enough space, so it can not fail
+	for (size_t attempt = 0; attempt < 2; ++ attempt) {
+		bool success = true;
+		stat = Stat();
+		results.clear();
+		results.reserve(requests.size());
+
+		for (auto &it : requests) {
+			if (!acquireRegion(frame, it, results.emplace_back(), stat)) {
+				success = false;
+				break;
+			}
+		}
+
+		if (success) {
+			slots = _allocator.getSlots();
+			return _buffer;
+		}
+
+		// out of space or too fragmented - replace buffer, all data will be uploaded again
+		reset(frame, required);
+	}
+
+	log::vtext("vk::VertexCache", "Fail to acquire vertex regions for ", required, " vertexes");
+	return nullptr;
+}
+
+bool VertexCache::acquireRegion(uint64_t frame, const Request &req, Result &result, Stat &stat) {
+	auto &data = *req.data;
+	auto size = uint32_t(data->data.size());
+	auto bytes = size * _vertexSize;
+
+	auto it = _entries.find(data.get());
+	if (it != _entries.end()) {
+		auto &e = it->second;
+		if (e.version == data->version && e.material == req.material && e.region.size == size) {
+			if (e.region.frame != frame) {
+				e.region.frame = std::max(e.region.frame, frame);
+				result = Result{e.region.offset, e.region.slot, false};
+				stat.retained += bytes;
+				return true;
+			}
+
+			// same data drawn twice within frame: second copy requires own object slot for transform,
+			// so, it's written into transient region, released with retired regions
+			Region region;
+			if (!allocate(size, frame, region)) {
+				return false;
+			}
+			_retired.emplace_back(region);
+			result = Result{region.offset, region.slot, true};
+			stat.uploaded += bytes;
+			return true;
+		}
+
+		// data was changed, old region can still be in use by frames in flight
+		Region region;
+		if (!allocate(size, frame, region)) {
+			return false;
+		}
+		_retired.emplace_back(e.region);
+		e.region = region;
+		e.version = data->version;
+		e.material = req.material;
+		result = Result{region.offset, region.slot, true};
+		stat.uploaded += bytes;
+		return true;
+	}
+
+	Region region;
+	if (!allocate(size, frame, region)) {
+		return false;
+	}
+
+	_entries.emplace(data.get(), Entry{data, data->version, req.material, region});
+	result = Result{region.offset, region.slot, true};
+	stat.uploaded += bytes;
+	return true;
+}
+
+bool VertexCache::allocate(uint32_t size, uint64_t frame, Region &region) {
+	if (!_allocator.allocate(size, region)) {
+		return false;
+	}
+	region.frame = frame;
+	return true;
+}
+
+void VertexCache::free(const Region &region) {
+	_allocator.free(region);
+}
+
+void VertexCache::release(uint64_t frame) {
+	// frames can acquire out of order, so, use latest known frame
+	_frame = std::max(_frame, frame);
+
+	// region, last used by frame, is free on device, when all frames up to this one are completed;
+	// frame order is not GPU completion, invalidated frames also advance it
+	auto firstLocked = _locked.empty() ? maxOf<uint64_t>() : _locked.begin()->first;
+	auto isCompleted = [&] (uint64_t f) {
+		return f < firstLocked;
+	};
+
+	auto isExpired = [&] (uint64_t f) {
+		return f + config::VertexCacheRetainFrames < _frame && isCompleted(f);
+	};
+
+	auto it = _entries.begin();
+	while (it != _entries.end()) {
+		if (isExpired(it->second.region.frame)) {
+			free(it->second.region);
+			it = _entries.erase(it);
+		} else {
+			++ it;
+		}
+	}
+
+	auto rIt = _retired.begin();
+	while (rIt != _retired.end()) {
+		if (isCompleted(rIt->frame)) {
+			free(*rIt);
+			rIt = _retired.erase(rIt);
+		} else {
+			++ rIt;
+		}
+	}
+
+	auto bIt = _retiredBuffers.begin();
+	while (bIt != _retiredBuffers.end()) {
+		if (isCompleted(bIt->first)) {
+			bIt->second->invalidate(*_device);
+			bIt = _retiredBuffers.erase(bIt);
+		} else {
+			++ bIt;
+		}
+	}
+}
+
+void VertexCache::reset(uint64_t frame, uint32_t required) {
+	if (_buffer) {
+		_retiredBuffers.emplace_back(_frame, move(_buffer));
+	}
+
+	_capacity = std::max(std::max(_capacity * 2, required * 2), config::VertexCacheInitialSize);
+	_buffer = _pool->spawn(AllocationUsage::DeviceLocalHostVisible,
+			gl::BufferInfo(gl::BufferUsage::StorageBuffer, _capacity * _vertexSize));
+
+	_entries.clear();
+	_retired.clear();
+	_allocator.reset(_capacity);
+}
+
+}
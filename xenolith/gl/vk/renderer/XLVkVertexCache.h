@@ -0,0 +1,149 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#ifndef XENOLITH_GL_VK_RENDERER_XLVKVERTEXCACHE_H_
+#define XENOLITH_GL_VK_RENDERER_XLVKVERTEXCACHE_H_
+
+#include "XLVkAllocator.h"
+#include "XLVkBuffer.h"
+
+namespace stappler::xenolith::vk {
+
+// Free-list of vertex regions and object slots within VertexCache buffer, first fit, adjacent free blocks are merged
+class VertexRegionAllocator {
+public:
+	struct Block {
+		uint32_t offset = 0; // in vertexes
+		uint32_t size = 0;
+		uint32_t slot = 0;
+	};
+
+	// drop all blocks, whole capacity is free
+	void reset(uint32_t capacity);
+
+	bool allocate(uint32_t size, Block &);
+	void free(const Block &);
+
+	uint32_t getCapacity() const { return _capacity; }
+	uint32_t getFreeSize() const;
+	size_t getFreeBlocksCount() const { return _free.size(); }
+
+	// number of object slots, used since reset
+	uint32_t getSlots() const { return _slots; }
+
+protected:
+	uint32_t _capacity = 0;
+	uint32_t _slots = 0;
+	Map<uint32_t, uint32_t> _free; // offset -> size
+	Vector<uint32_t> _freeSlots;
+};
+
+// Retained storage for VertexData between frames
+// VertexData, that was not changed (same object and same version) and stamped with same material,
+// will be reused from device buffer without upload
+// Regions are immutable after write; replaced regions and buffers are released only when all frames,
+// that used them, are completed on device (see Lock); unused regions are retained for
+// config::VertexCacheRetainFrames frames
+class VertexCache : public Ref {
+public:
+	// frame's reference to cache, regions, used by frame, are not reused while lock exists;
+	// should be retained until frame's commands are completed on device (with frame's fence)
+	class Lock : public Ref {
+	public:
+		virtual ~Lock();
+
+		bool init(VertexCache *, uint64_t frame);
+
+		uint64_t getFrame() const { return _frame; }
+
+	protected:
+		Rc<VertexCache> _cache;
+		uint64_t _frame = 0;
+	};
+
+	struct Request {
+		const Rc<gl::VertexData> *data;
+		uint32_t material;
+	};
+
+	struct Result {
+		uint32_t offset; // in vertexes
+		uint32_t slot; // object index for transforms buffer
+		bool write; // data should be written into buffer with this offset
+	};
+
+	struct Stat {
+		uint64_t uploaded = 0; // bytes
+		uint64_t retained = 0; // bytes
+	};
+
+	virtual ~VertexCache();
+
+	bool init(Device &, gl::VertexFormat = gl::VertexFormat::V4F_V4F_T2F2U);
+
+	gl::VertexFormat getVertexFormat() const { return _format; }
+
+	// frame should be locked before it acquires regions
+	Rc<Lock> lock(uint64_t frame);
+
+	// acquire regions for all requests within locked frame, returns buffer, that should be used for this frame
+	Rc<DeviceBuffer> acquire(const Lock &, SpanView<Request>, Vector<Result> &, uint32_t &slots, Stat &);
+
+protected:
+	struct Region : VertexRegionAllocator::Block {
+		uint64_t frame = 0; // last frame, that used this region
+	};
+
+	struct Entry {
+		Rc<gl::VertexData> data; // holds object, so, pointer can not be reused while entry exists
+		uint64_t version = 0;
+		uint32_t material = 0;
+		Region region;
+	};
+
+	bool acquireRegion(uint64_t frame, const Request &, Result &, Stat &);
+	bool allocate(uint32_t size, uint64_t frame, Region &);
+	void free(const Region &);
+	void unlock(uint64_t frame);
+	void release(uint64_t frame);
+	void reset(uint64_t frame, uint32_t required);
+
+	Device *_device = nullptr;
+	Rc<DeviceMemoryPool> _pool;
+	Rc<DeviceBuffer> _buffer;
+	gl::VertexFormat _format = gl::VertexFormat::V4F_V4F_T2F2U;
+	size_t _vertexSize = 0;
+	uint32_t _capacity = 0;
+	uint64_t _frame = 0;
+
+	std::unordered_map<const gl::VertexData *, Entry> _entries;
+	Vector<Region> _retired;
+	Vector<Pair<uint64_t, Rc<DeviceBuffer>>> _retiredBuffers;
+	VertexRegionAllocator _allocator;
+	Map<uint64_t, uint32_t> _locked; // frames, that are not completed on device -> lock count
+
+	Mutex _mutex;
+};
+
+}
+
+#endif /* XENOLITH_GL_VK_RENDERER_XLVKVERTEXCACHE_H_ */
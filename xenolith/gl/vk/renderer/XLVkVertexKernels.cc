@@ -0,0 +1,215 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLVkVertexKernels.h"
+
+#if __x86_64__ || _M_X64
+#include <immintrin.h>
+#define XL_VK_VERTEX_SSE 1
+#elif __aarch64__
+#include <arm_neon.h>
+#define XL_VK_VERTEX_NEON 1
+#endif
+
+namespace stappler::xenolith::vk {
+
+static void VertexKernels_stampScalar(gl::Vertex_V4F_V4F_T2F2U *target, const gl::Vertex_V4F_V4F_T2F2U *source,
+		size_t count, uint32_t material, uint32_t object) {
+	for (size_t i = 0; i < count; ++ i) {
+		target[i].pos = source[i].pos;
+		target[i].color = source[i].color;
+		target[i].tex = source[i].tex;
+		target[i].material = material;
+		target[i].object = object;
+	}
+}
+
+static void VertexKernels_rebaseScalar(uint32_t *target, const uint32_t *source, size_t count, uint32_t offset) {
+	for (size_t i = 0; i < count; ++ i) {
+		target[i] = source[i] + offset;
+	}
+}
+
+static void VertexKernels_rebaseShortScalar(uint16_t *target, const uint32_t *source, size_t count, uint32_t offset) {
+	for (size_t i = 0; i < count; ++ i) {
+		target[i] = uint16_t(source[i] + offset);
+	}
+}
+
+#if XL_VK_VERTEX_SSE
+static void VertexKernels_stampSse(gl::Vertex_V4F_V4F_T2F2U *target, const gl::Vertex_V4F_V4F_T2F2U *source,
+		size_t count, uint32_t material, uint32_t object) {
+	// material and object are last 8 bytes of vertex, after texture coords
+	const __m128i ids = _mm_set_epi32(0, 0, int(object), int(material));
+
+	for (size_t i = 0; i < count; ++ i) {
+		auto src = (const __m128i *)(source + i);
+		auto dst = (__m128i *)(target + i);
+
+		_mm_storeu_si128(dst, _mm_loadu_si128(src));
+		_mm_storeu_si128(dst + 1, _mm_loadu_si128(src + 1));
+		_mm_storeu_si128(dst + 2, _mm_unpacklo_epi64(_mm_loadu_si128(src + 2), ids));
+	}
+}
+
+static void VertexKernels_rebaseSse(uint32_t *target, const uint32_t *source, size_t count, uint32_t offset) {
+	const __m128i o = _mm_set1_epi32(int(offset));
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		_mm_storeu_si128((__m128i *)(target + i), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(source + i)), o));
+	}
+
+	VertexKernels_rebaseScalar(target + i, source + i, count - i, offset);
+}
+
+static void VertexKernels_rebaseShortSse(uint16_t *target, const uint32_t *source, size_t count, uint32_t offset) {
+	// SSE2 has only signed saturation, so values are shifted into signed 16-bit range before packing
+	const __m128i o = _mm_set1_epi32(int(offset - 0x8000));
+	const __m128i bias = _mm_set1_epi16(short(0x8000));
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		auto a = _mm_add_epi32(_mm_loadu_si128((const __m128i *)(source + i)), o);
+		auto b = _mm_add_epi32(_mm_loadu_si128((const __m128i *)(source + i + 4)), o);
+		_mm_storeu_si128((__m128i *)(target + i), _mm_xor_si128(_mm_packs_epi32(a, b), bias));
+	}
+
+	VertexKernels_rebaseShortScalar(target + i, source + i, count - i, offset);
+}
+
+// two vertexes (96 bytes) per iteration: pos0, color0 | tex0 + ids0, pos1 | color1, tex1 + ids1
+__attribute__((target("avx2")))
+static void VertexKernels_stampAvx2(gl::Vertex_V4F_V4F_T2F2U *target, const gl::Vertex_V4F_V4F_T2F2U *source,
+		size_t count, uint32_t material, uint32_t object) {
+	const __m256i ids = _mm256_set1_epi64x(int64_t((uint64_t(object) << 32) | material));
+
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2) {
+		auto src = (const __m256i *)(source + i);
+		auto dst = (__m256i *)(target + i);
+
+		_mm256_storeu_si256(dst, _mm256_loadu_si256(src));
+		_mm256_storeu_si256(dst + 1, _mm256_blend_epi32(_mm256_loadu_si256(src + 1), ids, 0x0C));
+		_mm256_storeu_si256(dst + 2, _mm256_blend_epi32(_mm256_loadu_si256(src + 2), ids, 0xC0));
+	}
+
+	VertexKernels_stampSse(target + i, source + i, count - i, material, object);
+}
+
+__attribute__((target("avx2")))
+static void VertexKernels_rebaseAvx2(uint32_t *target, const uint32_t *source, size_t count, uint32_t offset) {
+	const __m256i o = _mm256_set1_epi32(int(offset));
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		_mm256_storeu_si256((__m256i *)(target + i), _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(source + i)), o));
+	}
+
+	VertexKernels_rebaseSse(target + i, source + i, count - i, offset);
+}
+
+__attribute__((target("avx2")))
+static void VertexKernels_rebaseShortAvx2(uint16_t *target, const uint32_t *source, size_t count, uint32_t offset) {
+	const __m256i o = _mm256_set1_epi32(int(offset));
+
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		auto a = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(source + i)), o);
+		auto b = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(source + i + 8)), o);
+		// values fit in 16 bits, so unsigned saturation is exact; pack works within lanes, so restore order
+		auto r = _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8);
+		_mm256_storeu_si256((__m256i *)(target + i), r);
+	}
+
+	VertexKernels_rebaseShortSse(target + i, source + i, count - i, offset);
+}
+#endif
+
+#if XL_VK_VERTEX_NEON
+static void VertexKernels_stampNeon(gl::Vertex_V4F_V4F_T2F2U *target, const gl::Vertex_V4F_V4F_T2F2U *source,
+		size_t count, uint32_t material, uint32_t object) {
+	const uint32x2_t ids = vset_lane_u32(object, vdup_n_u32(material), 1);
+
+	for (size_t i = 0; i < count; ++ i) {
+		auto src = (const uint32_t *)(source + i);
+		auto dst = (uint32_t *)(target + i);
+
+		vst1q_u32(dst, vld1q_u32(src));
+		vst1q_u32(dst + 4, vld1q_u32(src + 4));
+		vst1q_u32(dst + 8, vcombine_u32(vld1_u32(src + 8), ids));
+	}
+}
+
+static void VertexKernels_rebaseNeon(uint32_t *target, const uint32_t *source, size_t count, uint32_t offset) {
+	const uint32x4_t o = vdupq_n_u32(offset);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		vst1q_u32(target + i, vaddq_u32(vld1q_u32(source + i), o));
+	}
+
+	VertexKernels_rebaseScalar(target + i, source + i, count - i, offset);
+}
+
+static void VertexKernels_rebaseShortNeon(uint16_t *target, const uint32_t *source, size_t count, uint32_t offset) {
+	const uint32x4_t o = vdupq_n_u32(offset);
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		auto a = vmovn_u32(vaddq_u32(vld1q_u32(source + i), o));
+		auto b = vmovn_u32(vaddq_u32(vld1q_u32(source + i + 4), o));
+		vst1q_u16(target + i, vcombine_u16(a, b));
+	}
+
+	VertexKernels_rebaseShortScalar(target + i, source + i, count - i, offset);
+}
+#endif
+
+const VertexKernels &getScalarVertexKernels() {
+	static VertexKernels s_kernels{&VertexKernels_stampScalar, &VertexKernels_rebaseScalar,
+		&VertexKernels_rebaseShortScalar, "scalar"};
+	return s_kernels;
+}
+
+const VertexKernels &getVertexKernels() {
+	static VertexKernels s_kernels = [] () -> VertexKernels {
+#if XL_VK_VERTEX_SSE
+#if __GNUC__ || __clang__
+		if (__builtin_cpu_supports("avx2")) {
+			return VertexKernels{&VertexKernels_stampAvx2, &VertexKernels_rebaseAvx2,
+				&VertexKernels_rebaseShortAvx2, "avx2"};
+		}
+#endif
+		return VertexKernels{&VertexKernels_stampSse, &VertexKernels_rebaseSse,
+			&VertexKernels_rebaseShortSse, "sse2"};
+#elif XL_VK_VERTEX_NEON
+		return VertexKernels{&VertexKernels_stampNeon, &VertexKernels_rebaseNeon,
+			&VertexKernels_rebaseShortNeon, "neon"};
+#else
+		return getScalarVertexKernels();
+#endif
+	}();
+	return s_kernels;
+}
+
+}
@@ -0,0 +1,54 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#ifndef XENOLITH_GL_VK_RENDERER_XLVKVERTEXKERNELS_H_
+#define XENOLITH_GL_VK_RENDERER_XLVKVERTEXKERNELS_H_
+
+#include "XLVk.h"
+
+namespace stappler::xenolith::vk {
+
+// CPU-side part of vertex upload: vertexes are copied into mapped buffer and stamped with material
+// and object (transform slot) index, indexes are rebased to vertex region in buffer
+struct VertexKernels {
+	// target[i] = source[i] with material and object replaced
+	void (*stampVertexes) (gl::Vertex_V4F_V4F_T2F2U *target, const gl::Vertex_V4F_V4F_T2F2U *source,
+			size_t count, uint32_t material, uint32_t object);
+
+	// target[i] = source[i] + offset
+	void (*rebaseIndexes) (uint32_t *target, const uint32_t *source, size_t count, uint32_t offset);
+
+	// target[i] = uint16_t(source[i] + offset), result should fit in 16 bits
+	void (*rebaseShortIndexes) (uint16_t *target, const uint32_t *source, size_t count, uint32_t offset);
+
+	const char *name;
+};
+
+// best kernels for current CPU (SSE2/AVX2 on x86_64, NEON on aarch64), selected on first call
+const VertexKernels &getVertexKernels();
+
+// reference implementation
+const VertexKernels &getScalarVertexKernels();
+
+}
+
+#endif /* XENOLITH_GL_VK_RENDERER_XLVKVERTEXKERNELS_H_ */
@@ -50,6 +50,8 @@ void Node::setLocalZOrder(int16_t z) {
 	}
 
 	_zOrder = z;
+	invalidateRetained();
+	markDamaged();
 	if (_parent) {
 		_parent->reorderChild(this, z);
 	}
@@ -61,7 +63,7 @@ void Node::setScale(float scale) {
 	}
 
 	_scale.x = _scale.y = _scale.z = scale;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setScale(const Vec2 &scale) {
@@ -71,7 +73,7 @@ void Node::setScale(const Vec2 &scale) {
 
 	_scale.x = scale.x;
 	_scale.y = scale.y;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setScale(const Vec3 &scale) {
@@ -80,7 +82,7 @@ void Node::setScale(const Vec3 &scale) {
 	}
 
 	_scale = scale;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setScaleX(float scaleX) {
@@ -89,7 +91,7 @@ void Node::setScaleX(float scaleX) {
 	}
 
 	_scale.x = scaleX;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setScaleY(float scaleY) {
@@ -98,7 +100,7 @@ void Node::setScaleY(float scaleY) {
 	}
 
 	_scale.y = scaleY;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setScaleZ(float scaleZ) {
@@ -107,7 +109,7 @@ void Node::setScaleZ(float scaleZ) {
 	}
 
 	_scale.z = scaleZ;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setPosition(const Vec2 &position) {
@@ -117,7 +119,7 @@ void Node::setPosition(const Vec2 &position) {
 
 	_position.x = position.x;
 	_position.y = position.y;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setPosition(const Vec3 &position) {
@@ -126,7 +128,7 @@ void Node::setPosition(const Vec3 &position) {
 	}
 
 	_position = position;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setPositionX(float value) {
@@ -135,7 +137,7 @@ void Node::setPositionX(float value) {
 	}
 
 	_position.x = value;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setPositionY(float value) {
@@ -144,7 +146,7 @@ void Node::setPositionY(float value) {
 	}
 
 	_position.y = value;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setPositionZ(float value) {
@@ -153,7 +155,7 @@ void Node::setPositionZ(float value) {
 	}
 
 	_position.z = value;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setSkewX(float skewX) {
@@ -162,7 +164,7 @@ void Node::setSkewX(float skewX) {
 	}
 
 	_skew.x = skewX;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setSkewY(float skewY) {
@@ -171,7 +173,7 @@ void Node::setSkewY(float skewY) {
 	}
 
 	_skew.y = skewY;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setAnchorPoint(const Vec2 &point) {
@@ -180,7 +182,7 @@ void Node::setAnchorPoint(const Vec2 &point) {
 	}
 
 	_anchorPoint = point;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::setContentSize(const Size &size) {
@@ -189,7 +191,11 @@ void Node::setContentSize(const Size &size) {
 	}
 
 	_contentSize = size;
-	_transformDirty = _contentSizeDirty = true;
+	_contentSizeDirty = true;
+
+	// anchor point offset depends on content size, so transform in TransformStore should be rebuilt
+	markTransformDirty();
+	invalidateRetained();
 }
 
 void Node::setVisible(bool visible) {
@@ -197,8 +203,11 @@ void Node::setVisible(bool visible) {
 		return;
 	}
 	_visible = visible;
+	markSubtreeDamaged();
 	if (_visible) {
-		_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+		markTransformDirty();
+	} else if (_parent) {
+		_parent->invalidateRetained();
 	}
 }
 
@@ -208,7 +217,7 @@ void Node::setRotation(float rotation) {
 	}
 
 	_rotation = Vec3(0.0f, 0.0f, rotation);
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 	Quaternion::createFormEulerAngles(_rotation, &_rotationQuat);
 }
 
@@ -218,7 +227,7 @@ void Node::setRotation(const Vec3 &rotation) {
 	}
 
 	_rotation = rotation;
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 	Quaternion::createFormEulerAngles(_rotation, &_rotationQuat);
 }
 
@@ -229,7 +238,7 @@ void Node::setRotation(const Quaternion &quat) {
 
 	_rotationQuat = quat;
 	_rotation = _rotationQuat.toEulerAngles();
-	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markTransformDirty();
 }
 
 void Node::addChildNode(Node *child) {
@@ -252,6 +261,7 @@ void Node::addChildNode(Node *child, int32_t localZOrder, uint64_t tag) {
 
 	_reorderChildDirty = true;
 	_children.push_back(child);
+	invalidateRetained();
 	child->setLocalZOrder(localZOrder);
 	if (tag != InvalidTag) {
 		child->setTag(tag);
@@ -287,6 +297,7 @@ void Node::setParent(Node *parent) {
 	}
 	_parent = parent;
 	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markSceneDirty();
 }
 
 void Node::removeFromParent(bool cleanup) {
@@ -314,6 +325,7 @@ void Node::removeChild(Node *child, bool cleanup) {
 		// set parent nil at the end
 		child->setParent(nullptr);
 		_children.erase(it);
+		invalidateRetained();
 	}
 }
 
@@ -342,6 +354,7 @@ void Node::removeAllChildren(bool cleanup) {
 	}
 
 	_children.clear();
+	invalidateRetained();
 }
 
 void Node::reorderChild(Node * child, int32_t localZOrder) {
@@ -469,6 +482,9 @@ void Node::onEnter(Scene *scene) {
 	_director = scene->getDirector();
 	_scheduler = _director->getScheduler();
 
+	// parent is entered before children, so it's already in store
+	_transformIndex = scene->getTransformStore()->add(this, _parent ? _parent->_transformIndex : TransformStore::InvalidIndex);
+
 	if (_onEnterCallback) {
 		_onEnterCallback(scene);
 	}
@@ -511,6 +527,14 @@ void Node::onExit() {
 		_onExitCallback();
 	}
 
+	// area, drawn by node, should be cleared with next frame
+	_scene->addDamage(_damageBoundingBox);
+	_damageBoundingBox = Rect();
+	_damaged = true;
+
+	_scene->getTransformStore()->remove(_transformIndex);
+	_transformIndex = TransformStore::InvalidIndex;
+
 	_scene = nullptr;
 	_director = nullptr;
 	_scheduler = nullptr;
@@ -559,6 +583,18 @@ Rect Node::getBoundingBox() const {
 	return layout::TransformRect(rect, getNodeToParentTransform());
 }
 
+void Node::setChildrenWithinBounds(bool value) {
+	_childrenWithinBounds = value;
+}
+
+void Node::setRetainedSubtree(bool value) {
+	if (_retainedSubtree != value) {
+		_retainedSubtree = value;
+		_retainedDirty = true;
+		_retainedCommands.clear();
+	}
+}
+
 void Node::resume() {
 	if (_paused) {
 		_paused = false;
@@ -652,7 +688,16 @@ const Mat4& Node::getNodeToParentTransform() const {
 void Node::setNodeToParentTransform(const Mat4& transform) {
 	_transform = transform;
 	_transformCacheDirty = false;
+	_transformInverseDirty = true;
 	_transformDirty = true;
+	markSceneDirty();
+	if (_transformIndex != TransformStore::InvalidIndex) {
+		_scene->getTransformStore()->setLocalDirty(_transformIndex);
+	}
+	if (_parent) {
+		_parent->invalidateRetained();
+		_parent->onChildBoundsDirty(this);
+	}
 }
 
 const Mat4 &Node::getParentToNodeTransform() const {
@@ -738,6 +783,8 @@ void Node::updateDisplayedOpacity(float parentOpacity) {
 	_displayedColor.a = _realColor.a * parentOpacity;
 
 	updateColor();
+	invalidateRetained();
+	markDamaged();
 
 	if (_cascadeOpacityEnabled) {
 		for (const auto &child : _children) {
@@ -765,6 +812,8 @@ void Node::updateDisplayedColor(const Color4F &parentColor) {
 	_displayedColor.g = _realColor.g * parentColor.g;
 	_displayedColor.b = _realColor.b * parentColor.b;
 	updateColor();
+	invalidateRetained();
+	markDamaged();
 
 	if (_cascadeColorEnabled) {
 		for (const auto &child : _children) {
@@ -812,14 +861,57 @@ void Node::draw(RenderFrameInfo &info, NodeFlags flags) {
 }
 
 void Node::visit(RenderFrameInfo &info, NodeFlags parentFlags) {
-	if (!_visible) {
+	NodeFlags flags = NodeFlags::None;
+	bool visibleByCamera = false;
+	if (!prepareVisit(info, parentFlags, flags, visibleByCamera)) {
 		return;
 	}
 
-	NodeFlags flags = processParentFlags(info, parentFlags);
+	if (_retainedSubtree) {
+		visitRetained(info, flags, parentFlags, visibleByCamera);
+	} else {
+		visitContent(info, flags, parentFlags, visibleByCamera);
+	}
+}
+
+bool Node::prepareVisit(RenderFrameInfo &info, NodeFlags parentFlags, NodeFlags &flags, bool &visibleByCamera) {
+	if (!_visible) {
+		return false;
+	}
+
+	flags = processParentFlags(info, parentFlags);
 
-	bool visibleByCamera = true;
+	processDamage(info, flags);
+
+	visibleByCamera = isVisibleByCamera(info);
+	if (!visibleByCamera) {
+		++ info.culledNodes;
+		if (_childrenWithinBounds) {
+			// children transforms are not updated, so, pass dirty flags on next visit
+			_culledChildrenFlags |= (flags & NodeFlags::DirtyMask);
+			++ info.culledSubtrees;
+			return false;
+		}
+	}
+
+	if (_culledChildrenFlags != NodeFlags::None) {
+		flags |= _culledChildrenFlags;
+		_culledChildrenFlags = NodeFlags::None;
+	}
+	return true;
+}
 
+void Node::processDamage(RenderFrameInfo &info, NodeFlags flags) {
+	if (_damaged || (flags & NodeFlags::DirtyMask) != NodeFlags::None) {
+		// both previous and new node's area should be redrawn
+		info.commands->addDamage(_damageBoundingBox);
+		info.commands->addDamage(_viewBoundingBox);
+		_damageBoundingBox = _viewBoundingBox;
+		_damaged = false;
+	}
+}
+
+void Node::visitContent(RenderFrameInfo &info, NodeFlags flags, NodeFlags parentFlags, bool visibleByCamera) {
 	info.transformStack.push_back(_modelViewTransform);
 	info.zPath.push_back(getLocalZOrder());
 
@@ -863,6 +955,119 @@ void Node::visit(RenderFrameInfo &info, NodeFlags parentFlags) {
 	info.transformStack.pop_back();
 }
 
+void Node::visitRetained(RenderFrameInfo &info, NodeFlags flags, NodeFlags parentFlags, bool visibleByCamera) {
+	auto prefix = info.zPath.size();
+
+	if (!_retainedDirty) {
+		if (memcmp(_retainedTransform.m, _modelViewTransform.m, sizeof(Mat4::m)) != 0) {
+			for (auto &it : _retainedCommands) {
+				Mat4::multiply(_modelViewTransform, it.relative, &it.transform);
+			}
+			_retainedTransform = _modelViewTransform;
+
+			// own area is already damaged by visit, area of children is unknown without bounds
+			if (!_childrenWithinBounds) {
+				info.commands->setFullDamage();
+			}
+		}
+
+		for (auto &it : _retainedCommands) {
+			for (auto &z : it.zPath) {
+				info.zPath.push_back(z);
+			}
+
+			switch (it.type) {
+			case gl::CommandType::VertexArray:
+				info.commands->pushVertexArray(it.vertexes, it.transform, info.zPath, it.material);
+				break;
+			case gl::CommandType::QuadInstance:
+				info.commands->pushQuadInstance(it.transform, it.size, it.texCoords, it.color, info.zPath, it.material);
+				break;
+			default:
+				break;
+			}
+
+			info.zPath.resize(prefix);
+		}
+		info.retainedCommands += _retainedCommands.size();
+		return;
+	}
+
+	// record subtree into separate list, whole subtree should be recorded, so, culling is disabled
+	auto commands = info.commands;
+	auto viewRect = info.viewRect;
+	info.commands = Rc<gl::CommandList>::create(commands->getPool());
+	info.commands->clearDamage();
+
+	// children's bounding boxes are not updated on replay, so, subtree is damaged as a whole
+	if (_childrenWithinBounds) {
+		commands->addDamage(_viewBoundingBox);
+	} else {
+		commands->setFullDamage();
+	}
+	info.viewRect = Rect(-maxOf<float>() / 2.0f, -maxOf<float>() / 2.0f, maxOf<float>(), maxOf<float>());
+
+	// subtree can be invalidated while it's recorded
+	_retainedDirty = false;
+
+	// children transforms was not updated, while commands was replayed
+	visitContent(info, flags | NodeFlags::TransformDirty, parentFlags, true);
+
+	info.viewRect = viewRect;
+
+	_retainedCommands.clear();
+
+	// commands can not be expressed relative to degenerate transform, they will be recorded again
+	if (_modelViewTransform.determinant() == 0.0f) {
+		_retainedDirty = true;
+	}
+
+	if (!_retainedDirty) {
+		auto inverse = _modelViewTransform.getInversed();
+		auto cmd = info.commands->getFirst();
+		while (cmd) {
+			RetainedCommand retained;
+			retained.type = cmd->type;
+
+			SpanView<int16_t> zPath;
+			switch (cmd->type) {
+			case gl::CommandType::VertexArray: {
+				auto data = (const gl::CmdVertexArray *)cmd->data;
+				retained.material = data->material;
+				retained.transform = data->transform;
+				retained.vertexes = data->vertexes;
+				zPath = data->zPath;
+				break;
+			}
+			case gl::CommandType::QuadInstance: {
+				auto data = (const gl::CmdQuadInstance *)cmd->data;
+				retained.material = data->material;
+				retained.transform = data->transform;
+				retained.size = data->size;
+				retained.texCoords = data->texCoords;
+				retained.color = data->color;
+				zPath = data->zPath;
+				break;
+			}
+			default:
+				break;
+			}
+
+			retained.relative = inverse * retained.transform;
+			if (zPath.size() > prefix) {
+				retained.zPath.assign(zPath.data() + prefix, zPath.data() + zPath.size());
+			}
+
+			_retainedCommands.emplace_back(move(retained));
+			cmd = cmd->next;
+		}
+		_retainedTransform = _modelViewTransform;
+	}
+
+	commands->append(move(info.commands));
+	info.commands = move(commands);
+}
+
 void Node::scheduleUpdate() {
 	if (!_scheduled) {
 		_scheduled = true;
@@ -881,6 +1086,60 @@ void Node::unscheduleUpdate() {
 	}
 }
 
+void Node::markTransformDirty() {
+	_transformInverseDirty = _transformCacheDirty = _transformDirty = true;
+	markSceneDirty();
+	if (_transformIndex != TransformStore::InvalidIndex) {
+		_scene->getTransformStore()->setLocalDirty(_transformIndex);
+	}
+	if (_parent) {
+		// own transform change does not invalidate own retained commands, only ancestors'
+		_parent->invalidateRetained();
+		_parent->onChildBoundsDirty(this);
+	}
+}
+
+void Node::onChildBoundsDirty(Node *) { }
+
+void Node::markDamaged() {
+	_damaged = true;
+
+	// replay of retained ancestor does not visit this node, so, damage is processed only when subtree is recorded
+	invalidateRetained();
+}
+
+void Node::markSubtreeDamaged() {
+	// ancestors are invalidated once, retained nodes within subtree are invalidated on the way down
+	invalidateRetained();
+
+	auto mark = [] (Node *node, const auto &mark) -> void {
+		if (node->_scene) {
+			node->_scene->addDamage(node->_damageBoundingBox);
+		}
+		node->_damaged = true;
+		if (node->_retainedSubtree) {
+			node->_retainedDirty = true;
+		}
+		for (auto &it : node->_children) {
+			mark(it.get(), mark);
+		}
+	};
+
+	mark(this, mark);
+}
+
+void Node::invalidateRetained() {
+	markSceneDirty();
+
+	auto node = this;
+	while (node) {
+		if (node->_retainedSubtree) {
+			node->_retainedDirty = true;
+		}
+		node = node->_parent;
+	}
+}
+
 Mat4 Node::transform(const Mat4 &parentTransform) {
 	return parentTransform * this->getNodeToParentTransform();
 }
@@ -899,7 +1158,13 @@ NodeFlags Node::processParentFlags(RenderFrameInfo &info, NodeFlags parentFlags)
 	flags |= (_contentSizeDirty ? NodeFlags::ContentSizeDirty : NodeFlags::None);
 
 	if ((flags & NodeFlags::DirtyMask) != NodeFlags::None || _transformDirty || _contentSizeDirty) {
-		_modelViewTransform = this->transform(info.transformStack.back());
+		if (_transformIndex != TransformStore::InvalidIndex) {
+			// world transforms was updated by scene before visit
+			_modelViewTransform = _scene->getTransformStore()->getWorldTransform(_transformIndex);
+		} else {
+			_modelViewTransform = this->transform(info.transformStack.back());
+		}
+		_viewBoundingBox = layout::TransformRect(Rect(0, 0, _contentSize.width, _contentSize.height), _modelViewTransform);
 	}
 
 	if (_transformDirty) {
@@ -913,5 +1178,16 @@ NodeFlags Node::processParentFlags(RenderFrameInfo &info, NodeFlags parentFlags)
 
 	return flags;
 }
+bool Node::isVisibleByCamera(const RenderFrameInfo &info) const {
+	if (_contentSize.width == 0.0f || _contentSize.height == 0.0f) {
+		return true;
+	}
+
+	auto &view = info.viewRect;
+	return _viewBoundingBox.origin.x <= view.origin.x + view.size.width
+		&& _viewBoundingBox.origin.x + _viewBoundingBox.size.width >= view.origin.x
+		&& _viewBoundingBox.origin.y <= view.origin.y + view.size.height
+		&& _viewBoundingBox.origin.y + _viewBoundingBox.size.height >= view.origin.y;
+}
 
 }
@@ -24,6 +24,7 @@ THE SOFTWARE.
 #define COMPONENTS_XENOLITH_NODES_XLNODE_H_
 
 #include "XLRenderFrameInfo.h"
+#include "XLTransformStore.h"
 
 namespace stappler::xenolith {
 
@@ -33,6 +34,9 @@ class Scheduler;
 
 class Node : public Ref {
 public:
+	friend class TransformStore;
+	friend class SpatialNode;
+
 	Node();
 	virtual ~Node();
 
@@ -176,6 +180,20 @@ public:
 
 	virtual Rect getBoundingBox() const;
 
+	// bounding box of content in space of frame root transform, updated with model-view transform
+	const Rect &getViewBoundingBox() const { return _viewBoundingBox; }
+
+	// if enabled, node declares, that all children are drawn within its bounds,
+	// so, whole subtree is skipped when node is out of view
+	virtual void setChildrenWithinBounds(bool);
+	virtual bool isChildrenWithinBounds() const { return _childrenWithinBounds; }
+
+	// if enabled, commands of node's subtree are recorded once and replayed on next frames with
+	// only model-view transform update, until something within subtree is changed
+	// subtree should not produce per-frame dynamic content, culling within subtree is disabled
+	virtual void setRetainedSubtree(bool);
+	virtual bool isRetainedSubtree() const { return _retainedSubtree; }
+
 	virtual void resume();
 	virtual void pause();
 
@@ -227,9 +245,40 @@ protected:
 	virtual void disableCascadeColor();
 	virtual void updateColor() { }
 
+	// invalidates transform caches and notifies parent
+	void markTransformDirty();
+
+	// called by child, when its transform or content size was changed
+	virtual void onChildBoundsDirty(Node *);
+
+	// drop recorded commands of this node and all retained ancestors
+	void invalidateRetained();
+
+	// node's output was changed without transform change (color, vertexes, texture), so, area,
+	// drawn by node on previous frame and on next frame, should be redrawn
+	void markDamaged();
+
+	// marks node and its children for redraw, when subtree is hidden or shown
+	void markSubtreeDamaged();
+
+	// common part of visit: flags, damage and culling; returns false if content should not be visited
+	bool prepareVisit(RenderFrameInfo &, NodeFlags parentFlags, NodeFlags &flags, bool &visibleByCamera);
+
+	// add previous and current node's area into frame damage, if node was changed
+	void processDamage(RenderFrameInfo &, NodeFlags flags);
+
+	// visit children, components and self, with node's transform and z-order pushed
+	virtual void visitContent(RenderFrameInfo &, NodeFlags flags, NodeFlags parentFlags, bool visibleByCamera);
+
+	// replay recorded commands, or record them with visitContent
+	virtual void visitRetained(RenderFrameInfo &, NodeFlags flags, NodeFlags parentFlags, bool visibleByCamera);
+
 	Mat4 transform(const Mat4 &parentTransform);
 	NodeFlags processParentFlags(RenderFrameInfo &info, NodeFlags parentFlags);
 
+	// nodes without content size are always visible, their drawing area is unknown
+	virtual bool isVisibleByCamera(const RenderFrameInfo &) const;
+
 	bool _is3d = false;
 	bool _running = false;
 	bool _visible = true;
@@ -238,6 +287,11 @@ protected:
 
 	bool _cascadeColorEnabled = false;
 	bool _cascadeOpacityEnabled = true;
+	bool _childrenWithinBounds = false;
+	bool _retainedSubtree = false;
+
+	// can be set from different top-level subtrees, when scene is visited in parallel
+	std::atomic<bool> _retainedDirty = true;
 
 	bool _contentSizeDirty = true;
 	bool _reorderChildDirty = true;
@@ -265,6 +319,33 @@ protected:
 	mutable Mat4 _transform = Mat4::IDENTITY;
 	mutable Mat4 _inverse = Mat4::IDENTITY;
 	Mat4 _modelViewTransform = Mat4::IDENTITY;
+	Rect _viewBoundingBox;
+
+	// view bounding box, drawn with previous frame, it's damaged when node is changed, hidden or removed
+	Rect _damageBoundingBox;
+	bool _damaged = true;
+
+	// dirty flags, that was not passed to children, because subtree was culled
+	NodeFlags _culledChildrenFlags = NodeFlags::None;
+
+	// command of retained subtree, transform is relative to node's model-view transform
+	struct RetainedCommand {
+		gl::CommandType type;
+		gl::MaterialId material = 0;
+		Mat4 relative;
+		Mat4 transform; // for _retainedTransform
+		Rc<gl::VertexData> vertexes;
+		Size size;
+		Vec4 texCoords;
+		Color4F color;
+		Vector<int16_t> zPath; // without zPath prefix of node's parent
+	};
+
+	Vector<RetainedCommand> _retainedCommands;
+	Mat4 _retainedTransform; // model-view transform, for which commands transforms was computed
+
+	// index in scene's TransformStore, assigned while node is running
+	uint32_t _transformIndex = TransformStore::InvalidIndex;
 
 	Vector<Rc<Node>> _children;
 	Node *_parent = nullptr;
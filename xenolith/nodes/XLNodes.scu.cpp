@@ -26,3 +26,5 @@ THE SOFTWARE.
 #include "XLNode.cc"
 #include "XLResourceComponent.cc"
 #include "XLSprite.cc"
+#include "XLSpatialNode.cc"
+#include "XLTransformStore.cc"
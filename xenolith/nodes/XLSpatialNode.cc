@@ -0,0 +1,375 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLSpatialNode.h"
+#include "XLScene.h"
+#include "XLComponent.h"
+
+namespace stappler::xenolith {
+
+SpatialNode::~SpatialNode() { }
+
+void SpatialNode::addChildNode(Node *child, int32_t localZOrder, uint64_t tag) {
+	Node::addChildNode(child, localZOrder, tag);
+
+	uint32_t idx = 0;
+	if (!_freeEntries.empty()) {
+		idx = _freeEntries.back();
+		_freeEntries.pop_back();
+		_entries[idx] = Entry();
+	} else {
+		idx = _entries.size();
+		_entries.emplace_back(Entry());
+	}
+
+	auto &e = _entries[idx];
+	e.node = child;
+	e.order = _nextOrder ++;
+
+	_entriesByNode.emplace(child, idx);
+
+	// bounds will be calculated on next index update
+	markEntryDirty(idx);
+}
+
+void SpatialNode::removeChild(Node *child, bool cleanup) {
+	auto it = _entriesByNode.find(child);
+	if (it != _entriesByNode.end()) {
+		auto idx = it->second;
+		if (_entries[idx].indexed) {
+			unindexEntry(idx);
+		}
+		_entries[idx].node = nullptr;
+		_entries[idx].dirty = false;
+		_freeEntries.emplace_back(idx);
+		_entriesByNode.erase(it);
+	}
+
+	Node::removeChild(child, cleanup);
+}
+
+void SpatialNode::removeAllChildren(bool cleanup) {
+	_entries.clear();
+	_freeEntries.clear();
+	_dirtyEntries.clear();
+	_visitedEntries.clear();
+	_entriesByNode.clear();
+	_levels.clear();
+
+	Node::removeAllChildren(cleanup);
+}
+
+void SpatialNode::onContentSizeDirty() {
+	Node::onContentSizeDirty();
+
+	// cell sizes depend on content size
+	rebuildIndex();
+}
+
+void SpatialNode::visitContent(RenderFrameInfo &info, NodeFlags flags, NodeFlags parentFlags, bool visibleByCamera) {
+	if ((flags & NodeFlags::DirtyMask) != NodeFlags::None) {
+		// children, that are not visited on this frame, should update their transforms on next visit
+		++ _generation;
+	}
+
+	updateIndex();
+
+	_visitedEntries.clear();
+	if (info.viewRect.size.width >= maxOf<float>() || info.viewRect.size.height >= maxOf<float>()) {
+		// retained subtree is recorded without culling, view rect can not be transformed into node space
+		for (uint32_t idx = 0; idx < _entries.size(); ++ idx) {
+			auto &e = _entries[idx];
+			if (e.node && e.node->isVisible()) {
+				_visitedEntries.emplace_back(idx);
+			}
+		}
+	} else {
+		// query with view rect in node space
+		auto viewRect = layout::TransformRect(info.viewRect, _modelViewTransform.getInversed());
+		queryEntries(viewRect, [&] (uint32_t idx) {
+			_visitedEntries.emplace_back(idx);
+		});
+	}
+
+	std::sort(_visitedEntries.begin(), _visitedEntries.end(), [&] (uint32_t l, uint32_t r) {
+		auto &lEntry = _entries[l];
+		auto &rEntry = _entries[r];
+		if (lEntry.node->getLocalZOrder() != rEntry.node->getLocalZOrder()) {
+			return lEntry.node->getLocalZOrder() < rEntry.node->getLocalZOrder();
+		}
+		return lEntry.order < rEntry.order;
+	});
+
+	info.culledNodes += _entriesByNode.size() - _visitedEntries.size();
+
+	info.transformStack.push_back(_modelViewTransform);
+	info.zPath.push_back(getLocalZOrder());
+
+	auto visitEntry = [&] (uint32_t idx) {
+		auto &e = _entries[idx];
+		auto childFlags = flags;
+		if (e.generation != _generation) {
+			childFlags |= NodeFlags::TransformDirty;
+			e.generation = _generation;
+		}
+		e.node->visit(info, childFlags);
+	};
+
+	auto it = _visitedEntries.begin();
+
+	// draw children zOrder < 0
+	for (; it != _visitedEntries.end() && _entries[*it].node->getLocalZOrder() < 0; ++ it) {
+		visitEntry(*it);
+	}
+
+	for (auto &c : _components) {
+		c->visit(info, parentFlags);
+	}
+
+	if (visibleByCamera) {
+		this->draw(info, flags);
+	}
+
+	for (; it != _visitedEntries.end(); ++ it) {
+		visitEntry(*it);
+	}
+
+	info.zPath.pop_back();
+	info.transformStack.pop_back();
+}
+
+void SpatialNode::queryChildren(const Rect &rect, const Callback<void(Node *)> &cb) {
+	updateIndex();
+	queryEntries(rect, [&] (uint32_t idx) {
+		cb(_entries[idx].node);
+	});
+}
+
+Node *SpatialNode::getChildAt(const Vec2 &point) {
+	updateIndex();
+
+	const Entry *ret = nullptr;
+	queryEntries(Rect(point.x, point.y, 0.0f, 0.0f), [&] (uint32_t idx) {
+		auto &e = _entries[idx];
+
+		// bounding box is axis-aligned, so, check actual content rect of child
+		Vec3 local;
+		e.node->getParentToNodeTransform().transformPoint(Vec3(point.x, point.y, 0.0f), &local);
+		auto &size = e.node->getContentSize();
+		if (local.x < 0.0f || local.y < 0.0f || local.x > size.width || local.y > size.height) {
+			return;
+		}
+
+		if (!ret || ret->node->getLocalZOrder() < e.node->getLocalZOrder()
+				|| (ret->node->getLocalZOrder() == e.node->getLocalZOrder() && ret->order < e.order)) {
+			ret = &e;
+		}
+	});
+
+	return ret ? ret->node : nullptr;
+}
+
+void SpatialNode::onChildBoundsDirty(Node *child) {
+	auto it = _entriesByNode.find(child);
+	if (it != _entriesByNode.end()) {
+		markEntryDirty(it->second);
+	}
+
+	// child, moved out of view, is not visited, so, its previous area is damaged here;
+	// if it's still within view, visit damages its new area
+	if (_scene) {
+		_scene->addDamage(child->_damageBoundingBox);
+	}
+	child->_damageBoundingBox = Rect();
+	child->_damaged = true;
+}
+
+void SpatialNode::updateIndex() {
+	if (_levels.empty()) {
+		_levels.resize(config::SpatialNodeMaxDepth + 1);
+	}
+
+	for (auto &idx : _dirtyEntries) {
+		auto &e = _entries[idx];
+		if (!e.node || !e.dirty) {
+			continue;
+		}
+
+		e.dirty = false;
+		if (e.indexed) {
+			unindexEntry(idx);
+		}
+		e.bounds = e.node->getBoundingBox();
+		indexEntry(idx);
+	}
+
+	_dirtyEntries.clear();
+}
+
+void SpatialNode::rebuildIndex() {
+	_levels.clear();
+	_dirtyEntries.clear();
+	for (uint32_t idx = 0; idx < _entries.size(); ++ idx) {
+		auto &e = _entries[idx];
+		if (e.node) {
+			e.indexed = false;
+			e.dirty = false;
+			markEntryDirty(idx);
+		}
+	}
+}
+
+void SpatialNode::indexEntry(uint32_t idx) {
+	auto &e = _entries[idx];
+
+	Vec2 center(e.bounds.origin.x + e.bounds.size.width / 2.0f, e.bounds.origin.y + e.bounds.size.height / 2.0f);
+
+	uint32_t level = 0;
+	float cellWidth = _contentSize.width;
+	float cellHeight = _contentSize.height;
+
+	// with loose factor of 2, child fits into level, if its size is not larger then cell size
+	// without content size, all children are stored on level 0
+	while (cellWidth > 0.0f && cellHeight > 0.0f && level < config::SpatialNodeMaxDepth
+			&& e.bounds.size.width * 2.0f <= cellWidth && e.bounds.size.height * 2.0f <= cellHeight) {
+		cellWidth /= 2.0f;
+		cellHeight /= 2.0f;
+		++ level;
+	}
+
+	// children outside of content rect are placed into edge cells, queries are clamped to edges the same way
+	uint32_t cell = 0;
+	if (level > 0) {
+		float max = float((1 << level) - 1);
+		uint32_t x = uint32_t(std::clamp(std::floor(center.x / cellWidth), 0.0f, max));
+		uint32_t y = uint32_t(std::clamp(std::floor(center.y / cellHeight), 0.0f, max));
+		cell = (y << 16) | x;
+	}
+
+	auto &vec = _levels[level][cell];
+	e.level = level;
+	e.cell = cell;
+	e.index = vec.size();
+	e.indexed = true;
+	vec.emplace_back(idx);
+}
+
+void SpatialNode::unindexEntry(uint32_t idx) {
+	auto &e = _entries[idx];
+	auto &level = _levels[e.level];
+	auto it = level.find(e.cell);
+	if (it == level.end()) {
+		return;
+	}
+
+	auto &vec = it->second;
+	auto last = vec.back();
+	vec[e.index] = last;
+	_entries[last].index = e.index;
+	vec.pop_back();
+	if (vec.empty()) {
+		level.erase(it);
+	}
+	e.indexed = false;
+}
+
+void SpatialNode::markEntryDirty(uint32_t idx) {
+	auto &e = _entries[idx];
+	if (!e.dirty) {
+		e.dirty = true;
+		_dirtyEntries.emplace_back(idx);
+	}
+}
+
+template <typename Visitor>
+void SpatialNode::queryEntries(const Rect &rect, const Visitor &cb) const {
+	auto isVisible = [&] (const Entry &e) {
+		return e.node->isVisible()
+			&& e.bounds.origin.x <= rect.origin.x + rect.size.width
+			&& e.bounds.origin.x + e.bounds.size.width >= rect.origin.x
+			&& e.bounds.origin.y <= rect.origin.y + rect.size.height
+			&& e.bounds.origin.y + e.bounds.size.height >= rect.origin.y;
+	};
+
+	for (uint32_t l = 0; l < _levels.size(); ++ l) {
+		auto &level = _levels[l];
+		if (level.empty()) {
+			continue;
+		}
+
+		if (l == 0) {
+			for (auto &it : level) {
+				for (auto &idx : it.second) {
+					if (isVisible(_entries[idx])) {
+						cb(idx);
+					}
+				}
+			}
+			continue;
+		}
+
+		// loose cell bounds are extended by half of cell size on each side
+		float cellWidth = _contentSize.width / float(1 << l);
+		float cellHeight = _contentSize.height / float(1 << l);
+		float max = float((1 << l) - 1);
+
+		auto x0 = std::ceil((rect.origin.x - cellWidth * 1.5f) / cellWidth);
+		auto x1 = std::floor((rect.origin.x + rect.size.width + cellWidth / 2.0f) / cellWidth);
+		auto y0 = std::ceil((rect.origin.y - cellHeight * 1.5f) / cellHeight);
+		auto y1 = std::floor((rect.origin.y + rect.size.height + cellHeight / 2.0f) / cellHeight);
+
+		uint32_t minX = uint32_t(std::clamp(x0, 0.0f, max));
+		uint32_t maxX = uint32_t(std::clamp(x1, 0.0f, max));
+		uint32_t minY = uint32_t(std::clamp(y0, 0.0f, max));
+		uint32_t maxY = uint32_t(std::clamp(y1, 0.0f, max));
+
+		auto processCell = [&] (const Vector<uint32_t> &vec) {
+			for (auto &idx : vec) {
+				if (isVisible(_entries[idx])) {
+					cb(idx);
+				}
+			}
+		};
+
+		if (size_t(maxX - minX + 1) * size_t(maxY - minY + 1) > level.size()) {
+			// sparse level, iterate over existing cells
+			for (auto &it : level) {
+				uint32_t x = it.first & 0xFFFF;
+				uint32_t y = it.first >> 16;
+				if (x >= minX && x <= maxX && y >= minY && y <= maxY) {
+					processCell(it.second);
+				}
+			}
+		} else {
+			for (uint32_t y = minY; y <= maxY; ++ y) {
+				for (uint32_t x = minX; x <= maxX; ++ x) {
+					auto it = level.find((y << 16) | x);
+					if (it != level.end()) {
+						processCell(it->second);
+					}
+				}
+			}
+		}
+	}
+}
+
+}
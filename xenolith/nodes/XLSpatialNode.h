@@ -0,0 +1,97 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#ifndef XENOLITH_NODES_XLSPATIALNODE_H_
+#define XENOLITH_NODES_XLSPATIALNODE_H_
+
+#include "XLNode.h"
+
+namespace stappler::xenolith {
+
+// Container for large sets of mostly static children (maps, canvases)
+// Children are indexed with loose quadtree by their bounding boxes within node's content rect,
+// so, visit processes only children within view, and hit-test does not iterate over all children
+// Index is updated incrementally, when child's transform or content size is changed
+class SpatialNode : public Node {
+public:
+	virtual ~SpatialNode();
+
+	using Node::addChildNode;
+
+	virtual void addChildNode(Node *child, int32_t localZOrder, uint64_t tag) override;
+	virtual void removeChild(Node *child, bool cleanup = true) override;
+	virtual void removeAllChildren(bool cleanup = true) override;
+
+	virtual void onContentSizeDirty() override;
+
+	// calls callback for visible children, which bounding boxes intersect rect in node space
+	virtual void queryChildren(const Rect &, const Callback<void(Node *)> &);
+
+	// topmost visible child, that contains point in node space
+	virtual Node *getChildAt(const Vec2 &);
+
+	// children, visited on last frame
+	size_t getVisitedChildrenCount() const { return _visitedEntries.size(); }
+
+protected:
+	struct Entry {
+		Node *node = nullptr;
+		Rect bounds;
+		uint64_t order = 0; // insertion order, defines draw order within same z-order
+		uint64_t generation = 0; // transform generation, when child was visited last time
+		uint32_t level = 0;
+		uint32_t cell = 0; // cell key within level
+		uint32_t index = 0; // position within cell
+		bool indexed = false;
+		bool dirty = false;
+	};
+
+	// damage and retained subtree are processed by Node::visit, only children within view are visited here
+	virtual void visitContent(RenderFrameInfo &, NodeFlags flags, NodeFlags parentFlags, bool visibleByCamera) override;
+
+	virtual void onChildBoundsDirty(Node *) override;
+
+	void updateIndex();
+	void rebuildIndex();
+	void indexEntry(uint32_t);
+	void unindexEntry(uint32_t);
+	void markEntryDirty(uint32_t);
+
+	template <typename Visitor>
+	void queryEntries(const Rect &, const Visitor &) const;
+
+	Vector<Entry> _entries;
+	Vector<uint32_t> _freeEntries;
+	Vector<uint32_t> _dirtyEntries;
+	Vector<uint32_t> _visitedEntries;
+	std::unordered_map<const Node *, uint32_t> _entriesByNode;
+
+	// cells of loose quadtree by level, cell key is (y << 16) | x
+	Vector<std::unordered_map<uint32_t, Vector<uint32_t>>> _levels;
+
+	uint64_t _nextOrder = 0;
+	uint64_t _generation = 1;
+};
+
+}
+
+#endif /* XENOLITH_NODES_XLSPATIALNODE_H_ */
@@ -56,6 +56,7 @@ bool Sprite::init(Rc<Texture> &&texture) {
 }
 
 void Sprite::setTexture(StringView textureName) {
+	auto prev = _texture.get();
 	if (!_running) {
 		_textureName = textureName.str();
 	} else {
@@ -71,9 +72,14 @@ void Sprite::setTexture(StringView textureName) {
 			}
 		}
 	}
+	if (_texture.get() != prev) {
+		invalidateRetained();
+		markDamaged();
+	}
 }
 
 void Sprite::setTexture(Rc<Texture> &&tex) {
+	auto prev = _texture.get();
 	if (_texture) {
 		if (!tex) {
 			_texture = nullptr;
@@ -88,6 +94,10 @@ void Sprite::setTexture(Rc<Texture> &&tex) {
 			_materialDirty = true;
 		}
 	}
+	if (_texture.get() != prev) {
+		invalidateRetained();
+		markDamaged();
+	}
 }
 
 void Sprite::visit(RenderFrameInfo &info, NodeFlags parentFlags) {
@@ -110,7 +120,20 @@ void Sprite::draw(RenderFrameInfo &frame, NodeFlags flags) {
 			}
 			_materialDirty = false;
 		}
-		frame.commands->pushVertexArray(_vertexes.pop(), frame.transformStack.back(), frame.zPath, _materialId);
+		if (isInstanced()) {
+			Vec4 texCoords(_textureRect.origin.x, _textureRect.origin.y,
+					_textureRect.origin.x + _textureRect.size.width, _textureRect.origin.y + _textureRect.size.height);
+			if (_flippedX) {
+				std::swap(texCoords.x, texCoords.z);
+			}
+			if (_flippedY) {
+				std::swap(texCoords.y, texCoords.w);
+			}
+			frame.commands->pushQuadInstance(frame.transformStack.back(), _contentSize, texCoords, _displayedColor,
+					frame.zPath, _materialId);
+		} else {
+			frame.commands->pushVertexArray(_vertexes.pop(), frame.transformStack.back(), frame.zPath, _materialId);
+		}
 	}
 }
 
@@ -132,6 +155,8 @@ void Sprite::setColorMode(const ColorMode &mode) {
 	if (_colorMode != mode) {
 		_colorMode = mode;
 		_materialDirty = true;
+		invalidateRetained();
+		markDamaged();
 	}
 }
 
@@ -162,6 +187,18 @@ void Sprite::updateColor() {
 	}
 }
 
+bool Sprite::isInstanced() const {
+	// rotated texture rect can not be expressed with instance texture coords,
+	// coords are packed as unorm16, so repeating (out of [0, 1]) rects also use vertex path
+	if (_rotated) {
+		return false;
+	}
+
+	auto inRange = [] (float v) { return v >= 0.0f && v <= 1.0f; };
+	return inRange(_textureRect.origin.x) && inRange(_textureRect.origin.x + _textureRect.size.width)
+			&& inRange(_textureRect.origin.y) && inRange(_textureRect.origin.y + _textureRect.size.height);
+}
+
 void Sprite::updateVertexes() {
 	_vertexes.clear();
 	_vertexes.addQuad()
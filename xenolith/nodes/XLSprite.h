@@ -54,6 +54,9 @@ protected:
 	virtual void updateColor() override;
 	virtual void updateVertexes();
 
+	// sprite can be drawn as instance of shared unit quad instead of own vertex array
+	virtual bool isInstanced() const;
+
 	String _textureName;
 	Rc<Texture> _texture;
 	VertexArray _vertexes;
@@ -0,0 +1,164 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "XLTransformStore.h"
+#include "XLNode.h"
+
+namespace stappler::xenolith {
+
+TransformStore::~TransformStore() { }
+
+bool TransformStore::init() {
+	return true;
+}
+
+uint32_t TransformStore::add(Node *node, uint32_t parent) {
+	auto idx = uint32_t(_nodes.size());
+
+	_parents.emplace_back(parent);
+	_local.emplace_back(node->getNodeToParentTransform());
+	_world.emplace_back(Mat4::IDENTITY);
+	_dirty.emplace_back(WorldDirty);
+	_nodes.emplace_back(node);
+
+	_firstDirty = std::min(_firstDirty, idx);
+	return idx;
+}
+
+void TransformStore::remove(uint32_t idx) {
+	if (idx >= _nodes.size() || !_nodes[idx]) {
+		return;
+	}
+
+	// slot is not reused, so, new nodes are always placed after their parents
+	_nodes[idx] = nullptr;
+	_parents[idx] = InvalidIndex;
+	_dirty[idx] = 0;
+	++ _freeCount;
+}
+
+void TransformStore::setLocalDirty(uint32_t idx) {
+	if ((_dirty[idx] & LocalDirty) == 0) {
+		_dirty[idx] |= LocalDirty;
+
+		std::unique_lock<Mutex> lock(_localDirtyMutex);
+		_localDirty.emplace_back(idx);
+	}
+}
+
+void TransformStore::update(const Mat4 &root) {
+	_updatedCount = 0;
+
+	do {
+		std::unique_lock<Mutex> lock(_localDirtyMutex);
+		for (auto &idx : _localDirty) {
+			if (_nodes[idx]) {
+				_local[idx] = _nodes[idx]->getNodeToParentTransform();
+				_firstDirty = std::min(_firstDirty, idx);
+			}
+		}
+		_localDirty.clear();
+	} while (0);
+
+	if (_freeCount > 1024 && _freeCount * 2 > _nodes.size()) {
+		compact();
+	}
+
+	bool rootDirty = false;
+	if (memcmp(root.m, _root.m, sizeof(Mat4::m)) != 0) {
+		_root = root;
+		_firstDirty = 0;
+		rootDirty = true;
+	}
+
+	auto size = uint32_t(_nodes.size());
+	if (_firstDirty >= size) {
+		_firstDirty = InvalidIndex;
+		return;
+	}
+
+	// parents always precede children, so parent's dirty bit is final, when child is processed
+	auto parents = _parents.data();
+	auto local = _local.data();
+	auto world = _world.data();
+	auto dirty = _dirty.data();
+
+	for (uint32_t i = _firstDirty; i < size; ++ i) {
+		auto p = parents[i];
+		if (p == InvalidIndex) {
+			if (dirty[i] || rootDirty) {
+				Mat4::multiply(_root, local[i], &world[i]);
+				dirty[i] = WorldDirty;
+				++ _updatedCount;
+			}
+		} else if (dirty[i] || dirty[p]) {
+			Mat4::multiply(world[p], local[i], &world[i]);
+			dirty[i] = WorldDirty;
+			++ _updatedCount;
+		}
+	}
+
+	memset(dirty + _firstDirty, 0, size - _firstDirty);
+	_firstDirty = InvalidIndex;
+}
+
+void TransformStore::compact() {
+	Vector<uint32_t> remap;
+	remap.resize(_nodes.size(), InvalidIndex);
+
+	uint32_t target = 0;
+	uint32_t firstDirty = InvalidIndex;
+	for (uint32_t i = 0; i < _nodes.size(); ++ i) {
+		if (!_nodes[i]) {
+			continue;
+		}
+
+		remap[i] = target;
+		if (target != i) {
+			_local[target] = _local[i];
+			_world[target] = _world[i];
+			_dirty[target] = _dirty[i];
+			_nodes[target] = _nodes[i];
+		}
+
+		// parent is always remapped before child
+		_parents[target] = (_parents[i] == InvalidIndex) ? InvalidIndex : remap[_parents[i]];
+		_nodes[target]->_transformIndex = target;
+
+		if (_dirty[target] && firstDirty == InvalidIndex) {
+			firstDirty = target;
+		}
+
+		++ target;
+	}
+
+	_parents.resize(target);
+	_local.resize(target);
+	_world.resize(target);
+	_dirty.resize(target);
+	_nodes.resize(target);
+
+	_firstDirty = firstDirty;
+	_freeCount = 0;
+}
+
+}
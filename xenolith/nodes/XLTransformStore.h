@@ -0,0 +1,89 @@
+/**
+ Copyright (c) 2021 Roman Katuntsev <sbkarr@stappler.org>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#ifndef XENOLITH_NODES_XLTRANSFORMSTORE_H_
+#define XENOLITH_NODES_XLTRANSFORMSTORE_H_
+
+#include "XLDefine.h"
+
+namespace stappler::xenolith {
+
+class Node;
+
+// Scene-wide structure-of-arrays storage for node transforms
+// Nodes are stored in topological order (parent always precedes its children), so, all dirty
+// world transforms can be updated with single linear pass over contiguous arrays, before visit
+class TransformStore : public Ref {
+public:
+	static constexpr uint32_t InvalidIndex = maxOf<uint32_t>();
+
+	virtual ~TransformStore();
+
+	bool init();
+
+	// node should be added after its parent, returns index for node
+	uint32_t add(Node *, uint32_t parent);
+	void remove(uint32_t);
+
+	// node's local transform should be reloaded on next update
+	// can be called from parallel scene visit for different nodes
+	void setLocalDirty(uint32_t);
+
+	// recompute dirty world transforms, root is parent transform for nodes without parent
+	// pass is scalar over nodes, each product is computed with Mat4::multiply, so vectorization
+	// comes only from stappler's SIMD implementation of it
+	void update(const Mat4 &root);
+
+	const Mat4 &getWorldTransform(uint32_t idx) const { return _world[idx]; }
+
+	size_t size() const { return _nodes.size() - _freeCount; }
+
+	// transforms, recomputed on last update
+	uint32_t getUpdatedCount() const { return _updatedCount; }
+
+protected:
+	enum DirtyBits : uint8_t {
+		LocalDirty = 1,
+		WorldDirty = 2,
+	};
+
+	// remove free slots, relative order (and so, topological order) is preserved
+	void compact();
+
+	Vector<uint32_t> _parents;
+	Vector<Mat4> _local;
+	Vector<Mat4> _world;
+	Vector<uint8_t> _dirty;
+	Vector<Node *> _nodes; // only to reload local transforms and to update indexes on compaction
+
+	Mutex _localDirtyMutex;
+	Vector<uint32_t> _localDirty;
+	uint32_t _firstDirty = InvalidIndex;
+	uint32_t _freeCount = 0;
+	uint32_t _updatedCount = 0;
+
+	Mat4 _root = Mat4::IDENTITY;
+};
+
+}
+
+#endif /* XENOLITH_NODES_XLTRANSFORMSTORE_H_ */
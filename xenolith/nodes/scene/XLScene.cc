@@ -22,6 +22,8 @@ THE SOFTWARE.
 
 #include "XLScene.h"
 #include "XLDirector.h"
+#include "XLGlSwapchain.h"
+#include "XLGlView.h"
 
 namespace stappler::xenolith {
 
@@ -34,6 +36,7 @@ bool Scene::init(gl::RenderQueue::Builder &&builder) {
 		return false;
 	}
 
+	_transforms = Rc<TransformStore>::create();
 	_queue = makeQueue(move(builder));
 
 	return true;
@@ -44,14 +47,77 @@ bool Scene::init(gl::RenderQueue::Builder &&builder, Size size) {
 		return false;
 	}
 
+	_transforms = Rc<TransformStore>::create();
 	_queue = makeQueue(move(builder));
 	setContentSize(size);
 
 	return true;
 }
 
+bool Scene::init(const Rc<gl::RenderQueue> &queue) {
+	if (!Node::init()) {
+		return false;
+	}
+
+	_transforms = Rc<TransformStore>::create();
+	_queue = queue;
+
+	return true;
+}
+
+bool Scene::init(const Rc<gl::RenderQueue> &queue, Size size) {
+	if (!Node::init()) {
+		return false;
+	}
+
+	_transforms = Rc<TransformStore>::create();
+	_queue = queue;
+	setContentSize(size);
+
+	return true;
+}
+
 void Scene::render(RenderFrameInfo &info) {
-	visit(info, NodeFlags::None);
+	capture(info);
+	emit(info);
+}
+
+void Scene::capture(RenderFrameInfo &info) {
+	// update all dirty world transforms in single pass, visit only reads them
+	_transforms->update(info.transformStack.back());
+
+	// nodes add own damage on visit, changes since previous frame are tracked by them
+	info.commands->clearDamage();
+	do {
+		std::unique_lock<Mutex> lock(_pendingDamageMutex);
+		for (auto &it : _pendingDamage) {
+			info.commands->addDamage(it);
+		}
+		_pendingDamage.clear();
+	} while (0);
+}
+
+void Scene::emit(RenderFrameInfo &info) {
+	if (_parallelVisit && !_retainedSubtree && info.queue && _children.size() > 1
+			&& _transforms->size() >= config::ParallelVisitMinNodes) {
+		visitParallel(info);
+	} else {
+		visit(info, NodeFlags::None);
+	}
+
+	_culledNodes = info.culledNodes;
+	_culledSubtrees = info.culledSubtrees;
+	_retainedCommands = info.retainedCommands;
+}
+
+void Scene::addDamage(const Rect &rect) {
+	if (rect.size.width > 0.0f && rect.size.height > 0.0f) {
+		do {
+			std::unique_lock<Mutex> lock(_pendingDamageMutex);
+			_pendingDamage.emplace_back(rect);
+		} while (0);
+		markSceneDirty();
+	}
 }
 
 void Scene::onContentSizeDirty() {
@@ -92,32 +158,55 @@ void Scene::onFrameEnded(gl::FrameHandle &) {
 
 }
 
-void Scene::on2dVertexInput(gl::FrameHandle &frame, const Rc<gl::AttachmentHandle> &attachment) {
-	_director->getApplication()->performOnMainThread([this, frame = Rc<gl::FrameHandle>(&frame), attachment = attachment] {
-		RenderFrameInfo info;
-		info.director = _director;
-		info.scene = this;
-		info.pool = frame->getPool()->getPool();
-		info.transformStack.reserve(8);
-		info.zPath.reserve(8);
-		info.transformStack.push_back(_director->getGeneralProjection());
-		info.commands = Rc<gl::CommandList>::create(frame->getPool());
-
-		render(info);
-
-		frame->submitInput(attachment, move(info.commands));
-
-		// submit material updates
-		if (!_pendingMaterials.empty()) {
-			for (auto &it : _pendingMaterials) {
-				auto req = Rc<gl::MaterialInputData>::alloc();
-				req->attachment = it.first;
-				req->materials = move(it.second);
-				frame->getLoop()->compileMaterials(req);
+static Scene *Scene_getFrameScene(gl::FrameHandle &frame) {
+	if (auto swapchain = frame.getSwapchain()) {
+		if (auto view = swapchain->getView()) {
+			if (auto &dir = view->getDirector()) {
+				return dir->getScene().get();
 			}
-			_pendingMaterials.clear();
 		}
-	}, this);
+	}
+	return nullptr;
+}
+
+void Scene::on2dVertexInput(gl::FrameHandle &frame, const Rc<gl::AttachmentHandle> &attachment) {
+	// queue can be shared between views, vertexes are provided by scene, presented in frame's view
+	auto scene = Scene_getFrameScene(frame);
+	if (scene && scene != this && scene->getRenderQueue() == _queue) {
+		scene->on2dVertexInput(frame, attachment);
+		return;
+	}
+
+	// snapshot is captured on next director's update and submitted from worker, that visits scene
+	_director->requestSnapshot([scene = Rc<Scene>(this), frame = Rc<gl::FrameHandle>(&frame), attachment = attachment]
+			(Rc<FrameSnapshot> &&snapshot) {
+		scene->submitSnapshot(*frame, attachment, move(snapshot));
+	});
+
+	if (auto view = frame.getSwapchain()->getView()) {
+		view->pushEvent(AppEvent::Update);
+	}
+}
+
+void Scene::submitSnapshot(gl::FrameHandle &frame, const Rc<gl::AttachmentHandle> &attachment, Rc<FrameSnapshot> &&snapshot) {
+	frame.setInputTime(snapshot->inputTime);
+	frame.submitInput(attachment, move(snapshot->commands));
+
+	// submit material updates
+	for (auto &it : snapshot->materials) {
+		auto req = Rc<gl::MaterialInputData>::alloc();
+		req->attachment = it.first;
+		req->materials = move(it.second);
+		frame.getLoop()->compileMaterials(req);
+	}
+	snapshot->materials.clear();
+}
+
+Map<const gl::MaterialAttachment *, Vector<Rc<gl::Material>>> Scene::popPendingMaterials() {
+	std::unique_lock<Mutex> lock(_materialsMutex);
+	auto ret = move(_pendingMaterials);
+	_pendingMaterials.clear();
+	return ret;
 }
 
 void Scene::onQueueEnabled(const gl::Swapchain *) {
@@ -129,6 +218,11 @@ void Scene::onQueueDisabled() {
 }
 
 uint64_t Scene::getMaterial(const MaterialInfo &info) const {
+	std::unique_lock<Mutex> lock(_materialsMutex);
+	return findMaterial(info);
+}
+
+uint64_t Scene::findMaterial(const MaterialInfo &info) const {
 	auto it = _materials.find(info.hash());
 	if (it != _materials.end()) {
 		for (auto &m : it->second) {
@@ -141,6 +235,13 @@ uint64_t Scene::getMaterial(const MaterialInfo &info) const {
 }
 
 uint64_t Scene::acquireMaterial(const MaterialInfo &info, const Vector<const gl::ImageData *> &images) {
+	std::unique_lock<Mutex> lock(_materialsMutex);
+
+	// material can be acquired by other thread since last check
+	if (auto id = findMaterial(info)) {
+		return id;
+	}
+
 	if (auto a = getAttachmentByType(info.type)) {
 		auto pipeline = getPipelineForMaterial(a, info);
 		if (!pipeline) {
@@ -168,6 +269,152 @@ uint64_t Scene::acquireMaterial(const MaterialInfo &info, const Vector<const gl:
 	return 0;
 }
 
+// shared between calling thread and queue workers, workers can outlive Scene::visitParallel call
+struct SceneParallelVisit : public Ref {
+	struct Segment {
+		Rc<Node> node;
+		Rc<gl::CommandList> commands;
+		uint32_t culledNodes = 0;
+		uint32_t culledSubtrees = 0;
+		uint32_t retainedCommands = 0;
+	};
+
+	Rc<Director> director;
+	Rc<Scene> scene;
+	Vector<Segment> segments;
+	Vector<int16_t> zPath;
+	Mat4 transform;
+	Rect viewRect;
+	NodeFlags flags = NodeFlags::None;
+
+	std::atomic<size_t> next = 0;
+	std::atomic<size_t> completed = 0;
+	Mutex mutex;
+	std::condition_variable cond;
+
+	// visit next unprocessed segment, returns false if there is none
+	bool run() {
+		auto idx = next.fetch_add(1);
+		if (idx >= segments.size()) {
+			return false;
+		}
+
+		auto &segment = segments[idx];
+		segment.commands->getPool()->perform([&] {
+			RenderFrameInfo info;
+			info.director = director;
+			info.scene = scene;
+			info.pool = segment.commands->getPool()->getPool();
+			info.viewRect = viewRect;
+			info.commands = segment.commands;
+			info.zPath.reserve(zPath.size() + 8);
+			for (auto &it : zPath) {
+				info.zPath.push_back(it);
+			}
+			info.transformStack.reserve(8);
+			info.transformStack.push_back(transform);
+
+			segment.node->visit(info, flags);
+
+			segment.culledNodes = info.culledNodes;
+			segment.culledSubtrees = info.culledSubtrees;
+			segment.retainedCommands = info.retainedCommands;
+		});
+
+		if (completed.fetch_add(1) + 1 == segments.size()) {
+			std::unique_lock<Mutex> lock(mutex);
+			cond.notify_all();
+		}
+		return true;
+	}
+
+	void wait() {
+		std::unique_lock<Mutex> lock(mutex);
+		cond.wait(lock, [&] {
+			return completed.load() == segments.size();
+		});
+	}
+};
+
+void Scene::visitParallel(RenderFrameInfo &info) {
+	// same as Node::visit for scene node itself, children are processed by segments
+	NodeFlags flags = NodeFlags::None;
+	bool visibleByCamera = false;
+	if (!prepareVisit(info, NodeFlags::None, flags, visibleByCamera)) {
+		return;
+	}
+
+	info.transformStack.push_back(_modelViewTransform);
+	info.zPath.push_back(getLocalZOrder());
+
+	sortAllChildren();
+
+	// same order as Node::visitContent: children with zOrder < 0, components, self, other children
+	size_t i = 0;
+	while (i < _children.size() && _children[i]->getLocalZOrder() < 0) {
+		++ i;
+	}
+
+	visitSegments(info, flags, SpanView<Rc<Node>>(_children.data(), i));
+
+	for (auto &it : _components) {
+		it->visit(info, NodeFlags::None);
+	}
+
+	if (visibleByCamera) {
+		draw(info, flags);
+	}
+
+	// components can modify children, so, rest of children is taken after them, as in serial visit
+	if (i < _children.size()) {
+		visitSegments(info, flags, SpanView<Rc<Node>>(_children.data() + i, _children.size() - i));
+	}
+
+	info.zPath.pop_back();
+	info.transformStack.pop_back();
+}
+
+void Scene::visitSegments(RenderFrameInfo &info, NodeFlags flags, SpanView<Rc<Node>> nodes) {
+	if (nodes.empty()) {
+		return;
+	}
+
+	auto data = Rc<SceneParallelVisit>::alloc();
+	data->director = info.director;
+	data->scene = this;
+	data->zPath.assign(info.zPath.begin(), info.zPath.end());
+	data->transform = _modelViewTransform;
+	data->viewRect = info.viewRect;
+	data->flags = flags;
+
+	// segment's commands are allocated from its own pool, pools are retained by target command list
+	data->segments.reserve(nodes.size());
+	for (auto &it : nodes) {
+		auto commands = Rc<gl::CommandList>::create(Rc<PoolRef>::alloc());
+		commands->clearDamage();
+		data->segments.emplace_back(SceneParallelVisit::Segment{it, move(commands)});
+	}
+
+	auto workers = std::min(data->segments.size() - 1, size_t(std::thread::hardware_concurrency()));
+	for (size_t i = 0; i < workers; ++ i) {
+		info.queue->perform(Rc<thread::Task>::create([data] (const thread::Task &) -> bool {
+			while (data->run()) { }
+			return true;
+		}));
+	}
+
+	// calling thread also processes segments, so, visit is completed even if queue is busy
+	while (data->run()) { }
+	data->wait();
+
+	for (auto &segment : data->segments) {
+		info.commands->append(move(segment.commands));
+		info.culledNodes += segment.culledNodes;
+		info.culledSubtrees += segment.culledSubtrees;
+		info.retainedCommands += segment.retainedCommands;
+	}
+}
+
 Rc<gl::RenderQueue> Scene::makeQueue(gl::RenderQueue::Builder &&builder) {
 	builder.setBeginCallback([this] (gl::FrameHandle &frame) {
 		onFrameStarted(frame);
@@ -310,6 +557,8 @@ const gl::MaterialAttachment *Scene::getAttachmentByType(gl::MaterialType type)
 }
 
 void Scene::addPendingMaterial(const gl::MaterialAttachment *a, Rc<gl::Material> &&material) {
+	markSceneDirty();
+
 	auto it = _pendingMaterials.find(a);
 	if (it != _pendingMaterials.end()) {
 		it->second.emplace_back(move(material));
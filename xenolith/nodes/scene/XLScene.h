@@ -37,13 +37,45 @@ public:
 	virtual bool init(gl::RenderQueue::Builder &&);
 	virtual bool init(gl::RenderQueue::Builder &&, Size);
 
+	// use render queue, compiled for another scene; queue's callbacks stay bound to that scene,
+	// frame input is forwarded to the scene, presented in frame's view
+	virtual bool init(const Rc<gl::RenderQueue> &);
+	virtual bool init(const Rc<gl::RenderQueue> &, Size);
+
+	// capture and emit on calling thread
 	virtual void render(RenderFrameInfo &info);
 
+	// main thread part of render: recompute world transforms and collect damage, added outside of visit
+	virtual void capture(RenderFrameInfo &info);
+
+	// visit scene graph into info.commands; can be called on worker, while scene graph is not modified
+	virtual void emit(RenderFrameInfo &info);
+
 	virtual void onContentSizeDirty() override;
 
 	const Rc<gl::RenderQueue> &getRenderQueue() const { return _queue; }
 	Director *getDirector() const { return _director; }
 
+	// culling statistics for last rendered frame
+	uint32_t getCulledNodes() const { return _culledNodes; }
+	uint32_t getCulledSubtrees() const { return _culledSubtrees; }
+	uint32_t getRetainedCommands() const { return _retainedCommands; }
+
+	// world transforms, recomputed for last rendered frame
+	uint32_t getUpdatedTransforms() const { return _transforms->getUpdatedCount(); }
+
+	const Rc<TransformStore> &getTransformStore() const { return _transforms; }
+
+	// area, drawn by removed or hidden nodes, it will be redrawn with next frame
+	void addDamage(const Rect &);
+
+	// for large scenes, visit top-level subtrees in parallel on frame's task queue, disabled by default
+	// draw and node callbacks of different top-level subtrees can be called concurrently,
+	// so, node should modify only own subtree within visit in this mode
+	// retained scene is always visited serially
+	void setParallelVisit(bool value) { _parallelVisit = value; }
+	bool isParallelVisit() const { return _parallelVisit; }
+
 	virtual void onPresented(Director *);
 	virtual void onFinished(Director *);
 
@@ -51,6 +83,9 @@ public:
 	virtual void onFrameEnded(gl::FrameHandle &); // called on GL thread;
 	virtual void on2dVertexInput(gl::FrameHandle &, const Rc<gl::AttachmentHandle> &); // called on GL thread;
 
+	// materials, acquired since last call, called by director when snapshot is built
+	Map<const gl::MaterialAttachment *, Vector<Rc<gl::Material>>> popPendingMaterials();
+
 	virtual void onQueueEnabled(const gl::Swapchain *);
 	virtual void onQueueDisabled();
 
@@ -62,6 +97,15 @@ public:
 	virtual uint64_t acquireMaterial(const MaterialInfo &, const Vector<const gl::ImageData *> &images);
 
 protected:
+	// children are visited into separate command lists, that merged in children order,
+	// so, output is identical to serial visit
+	virtual void visitParallel(RenderFrameInfo &);
+
+	// visit nodes into separate command lists on queue workers and calling thread, then append them in order
+	void visitSegments(RenderFrameInfo &, NodeFlags, SpanView<Rc<Node>>);
+
+	virtual void submitSnapshot(gl::FrameHandle &, const Rc<gl::AttachmentHandle> &, Rc<FrameSnapshot> &&);
+
 	virtual Rc<gl::RenderQueue> makeQueue(gl::RenderQueue::Builder &&);
 	virtual void readInitialMaterials();
 	virtual MaterialInfo getMaterialInfo(gl::MaterialType, const Rc<gl::Material> &) const;
@@ -79,15 +123,28 @@ protected:
 
 	void addPendingMaterial(const gl::MaterialAttachment *, Rc<gl::Material> &&);
 	void addMaterial(const MaterialInfo &, gl::MaterialId);
+	uint64_t findMaterial(const MaterialInfo &) const; // should be called with _materialsMutex locked
 
 	uint32_t _refId = 0;
+	uint32_t _culledNodes = 0;
+	uint32_t _culledSubtrees = 0;
+	uint32_t _retainedCommands = 0;
+	bool _parallelVisit = false;
 	Director *_director = nullptr;
 	Rc<gl::RenderQueue> _queue;
+	Rc<TransformStore> _transforms;
+	Vector<Rect> _pendingDamage;
+
+	// damage can be added from parallel visit
+	Mutex _pendingDamageMutex;
 
 	Map<gl::MaterialType, const gl::MaterialAttachment *> _attachmentsByType;
 	std::unordered_map<uint64_t, Vector<Pair<MaterialInfo, gl::MaterialId>>> _materials;
 
 	Map<const gl::MaterialAttachment *, Vector<Rc<gl::Material>>> _pendingMaterials;
+
+	// materials can be acquired from parallel visit
+	mutable Mutex _materialsMutex;
 };
 
 }
@@ -121,6 +121,13 @@ int Application::parseOptionString(data::Value &ret, const StringView &str, int
 		ret.setString(argv[0], "package");
 	} else if (str == "fixed") {
 		ret.setBool(true, "fixed");
+	} else if (str.starts_with("views=") == 0) {
+		auto s = str.sub(6).readInteger().get(0);
+		if (s > 0) {
+			ret.setInteger(s, "views");
+		}
+	} else if (str.starts_with("test=") == 0) {
+		ret.setString(str.sub(5), "test");
 	}
 	return 1;
 }
@@ -192,6 +199,11 @@ void Application::onMemoryWarning() {
 
 }
 
+bool Application::onTest(StringView filter) {
+	log::vtext("Application", "No tests defined for: ", filter);
+	return false;
+}
+
 int Application::run(data::Value &&data) {
 	for (auto &it : data.asDict()) {
 		if (it.first == "width") {
@@ -224,9 +236,19 @@ int Application::run(data::Value &&data) {
 			_data.isPhone = it.second.getBool();
 		} else if (it.first == "fixed") {
 			_data.isFixed = it.second.getBool();
+		} else if (it.first == "views") {
+			if (it.second.isInteger() && it.second.getInteger() > 0) {
+				_data.views = uint32_t(it.second.getInteger());
+			}
+		} else if (it.first == "test") {
+			_data.test = it.second.getString();
 		}
 	}
 
+	if (!_data.test.empty()) {
+		return onTest(_data.test) ? 0 : 1;
+	}
+
 	if (!onFinishLaunching()) {
 		return 1;
 	}
@@ -234,6 +256,7 @@ int Application::run(data::Value &&data) {
 	_glLoop->begin();
 	auto ret = onMainLoop();
 
+	_views.clear();
 	_resourceCache->invalidate(*_glLoop->getDevice());
 	_glLoop->end();
 	_glLoop = nullptr;
@@ -242,6 +265,36 @@ int Application::run(data::Value &&data) {
     return ret ? 0 : -1;
 }
 
+Rc<gl::View> Application::openView(const Rc<Director> &dir, StringView name, URect rect) {
+	auto view = platform::graphic::createView(_loop, _glLoop, name, rect);
+	if (!view) {
+		log::vtext("Application", "Fail to create view: ", name);
+		return nullptr;
+	}
+
+	_views.emplace_back(view);
+
+	auto success = view->begin(dir, [this, v = view.get()] {
+		auto it = std::find(_views.begin(), _views.end(), v);
+		if (it != _views.end()) {
+			_views.erase(it);
+		}
+		if (_views.empty()) {
+			_loop->pushEvent(AppEvent::Terminate);
+		}
+	});
+
+	if (!success) {
+		auto it = std::find(_views.begin(), _views.end(), view);
+		if (it != _views.end()) {
+			_views.erase(it);
+		}
+		return nullptr;
+	}
+
+	return view;
+}
+
 bool Application::openURL(const StringView &url) {
 	return platform::interaction::_goToUrl(url, true);
 }
@@ -264,6 +317,8 @@ void Application::update(uint64_t dt) {
 
 void Application::updateQueue() {
 	if (_queue) {
+		// tasks can modify scene graph
+		waitSceneVisits();
 		_queue->update();
 	}
 }
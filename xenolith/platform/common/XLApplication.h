@@ -90,6 +90,10 @@ public:
 		bool isPhone = false;
 		bool isFixed = false;
 		float density = 1.0f;
+		uint32_t views = 1;
+
+		// run CPU-side tests, matched by name prefix, instead of main loop
+		String test;
 	};
 
 	static Application *getInstance();
@@ -104,6 +108,9 @@ public:
 	virtual bool onMainLoop();
 	virtual void onMemoryWarning();
 
+	// called instead of onFinishLaunching/onMainLoop when "test=<filter>" option is set
+	virtual bool onTest(StringView filter);
+
 	virtual void update(uint64_t dt);
 	virtual void updateQueue();
 
@@ -160,6 +167,12 @@ public: // Threading, Events
 public:
 	virtual int run(data::Value &&);
 
+	/* Creates platform view and runs director on it. All views are driven by application's gl::Loop
+	   and share its device, resources and compiled programs. Application terminates when last view is closed */
+	Rc<gl::View> openView(const Rc<Director> &, StringView name, URect rect);
+
+	const Vector<Rc<gl::View>> &getViews() const { return _views; }
+
 	virtual bool openURL(const StringView &url);
 
 	/* device information */
@@ -233,6 +246,7 @@ protected:
 
 	Rc<gl::Instance> _instance; // api instance
 	Rc<gl::Loop> _glLoop;
+	Vector<Rc<gl::View>> _views;
 	log::CustomLog _appLog;
 };
 
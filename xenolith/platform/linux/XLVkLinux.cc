@@ -28,8 +28,15 @@
 #define LINUX_XCB 1
 #endif
 
+#ifndef LINUX_XCB_XINPUT
+#define LINUX_XCB_XINPUT 1
+#endif
+
 #if LINUX_XCB
 #include <xcb/xcb.h>
+#if LINUX_XCB_XINPUT
+#include <xcb/xinput.h>
+#endif
 #endif
 
 #include "XLGlSwapchain.h"
@@ -63,11 +70,15 @@ public:
 	virtual void setIMEKeyboardState(bool open) override;
 
 	virtual void pushEvent(AppEvent::Value) const override;
+	virtual void update() override;
 	virtual bool poll() override;
 	virtual void close() override;
 
 	virtual void setScreenSize(float width, float height) override;
 
+	// swapchain deprecation (VK_ERROR_OUT_OF_DATE_KHR), that was not requested by view, follows resize debounce
+	virtual void reset(gl::SwapchanCreationMode mode) override;
+
 	virtual void setClipboardString(StringView) override;
 	virtual StringView getClipboardString() const override;
 
@@ -75,11 +86,23 @@ public:
 
 	LinuxViewInterface *getView() const { return _view; }
 
-	void recreateSwapChain();
+	// request swapchain rebuild for new window size; requests are throttled to one per frame,
+	// while resize is active, swapchain is rebuilt only when window grows over current swapchain extent
+	void recreateSwapChain(uint32_t width, uint32_t height);
+
+	// window area was exposed, presented content can not be reused for partial redraw
+	void invalidateContent();
+
+	uint64_t getSwapchainRecreationCount() const { return _swapchainRecreations; }
 
 protected:
 	virtual Rc<gl::Swapchain> makeSwapchain(const Rc<gl::RenderQueue> &) const override;
 
+	void performRecreation(uint32_t width, uint32_t height);
+
+	// rebuild swapchain and set screen size to its extent, so, projection always matches swapchain images
+	void resetSwapchain(gl::SwapchanCreationMode mode);
+
 	const vk::Instance *_vkInstance = nullptr;
 	vk::Device *_vkDevice = nullptr;
 	Rc<LinuxViewInterface> _view;
@@ -88,6 +111,17 @@ protected:
 	uint32_t _frameWidth = 0;
 	uint32_t _frameHeight = 0;
 	uint64_t _frameTimeMicroseconds = 1000'000 / 60;
+
+	bool _recreationPending = false;
+	bool _recreationAllowed = true; // false until next frame after recreation
+	bool _recreationRequested = false; // deprecation was requested by view itself
+	bool _swapchainOutOfDate = false; // swapchain was invalidated by loop, recreation is deferred
+	uint32_t _pendingWidth = 0;
+	uint32_t _pendingHeight = 0;
+	uint32_t _swapchainWidth = 0;
+	uint32_t _swapchainHeight = 0;
+	uint64_t _lastResizeTime = 0;
+	uint64_t _swapchainRecreations = 0;
 };
 
 
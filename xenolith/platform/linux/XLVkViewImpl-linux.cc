@@ -54,6 +54,8 @@ bool ViewImpl::init(const Rc<EventLoop> &ev, const Rc<gl::Loop> &loop, StringVie
 	}
 
 	_view = v.get();
+	_swapchainWidth = rect.width;
+	_swapchainHeight = rect.height;
 	return gl::View::init(ev, loop);
 }
 
@@ -100,8 +102,87 @@ StringView ViewImpl::getClipboardString() const {
 	return StringView();
 }
 
-void ViewImpl::recreateSwapChain() {
-	_glLoop->recreateSwapChain(_swapchain);
+void ViewImpl::recreateSwapChain(uint32_t width, uint32_t height) {
+	_pendingWidth = width;
+	_pendingHeight = height;
+	_lastResizeTime = platform::device::_clock();
+	_recreationPending = true;
+
+	if (_recreationAllowed && (width > _swapchainWidth || height > _swapchainHeight)) {
+		// window grows over swapchain images, content will be cropped, so, rebuild it now
+		performRecreation(width, height);
+	}
+}
+
+void ViewImpl::invalidateContent() {
+	if (_swapchain) {
+		((Swapchain *)_swapchain.get())->invalidateContent();
+	}
+
+	// scene can be idle, new frame should be drawn anyway
+	markSceneDirty();
+	pushEvent(AppEvent::Update);
+}
+
+void ViewImpl::reset(gl::SwapchanCreationMode mode) {
+	if (mode == gl::SwapchanCreationMode::Fast && !_recreationRequested) {
+		// acquire or present returned VK_ERROR_OUT_OF_DATE_KHR, usually while window is resized,
+		// so, it's throttled and debounced as resize events
+		_swapchainOutOfDate = true;
+		if (!_recreationPending) {
+			_recreationPending = true;
+			_pendingWidth = _swapchainWidth;
+			_pendingHeight = _swapchainHeight;
+		}
+		if (_recreationAllowed && platform::device::_clock() - _lastResizeTime > config::ViewResizeDebounceInterval) {
+			performRecreation(_pendingWidth, _pendingHeight);
+		}
+		return;
+	}
+
+	_recreationRequested = false;
+	resetSwapchain(mode);
+}
+
+void ViewImpl::performRecreation(uint32_t width, uint32_t height) {
+	_recreationAllowed = false;
+	_recreationPending = false;
+	_swapchainWidth = width;
+	_swapchainHeight = height;
+	++ _swapchainRecreations;
+
+	log::vtext("VkView", "Swapchain recreation #", _swapchainRecreations, ": ", width, "x", height,
+			_swapchainOutOfDate ? " (out of date)" : "");
+
+	if (_swapchainOutOfDate) {
+		// swapchain is already invalidated by loop, deprecation event will be ignored, so, rebuild it here
+		_swapchainOutOfDate = false;
+		resetSwapchain(gl::SwapchanCreationMode::Fast);
+	} else {
+		_recreationRequested = true;
+		_glLoop->recreateSwapChain(_swapchain);
+	}
+}
+
+void ViewImpl::resetSwapchain(gl::SwapchanCreationMode mode) {
+	View::reset(mode);
+
+	if (_swapchain) {
+		auto info = ((Swapchain *)_swapchain.get())->getSwapchainImageInfo();
+		_swapchainWidth = info.extent.width;
+		_swapchainHeight = info.extent.height;
+		setScreenSize(float(info.extent.width), float(info.extent.height));
+	}
+}
+
+void ViewImpl::update() {
+	View::update();
+
+	_recreationAllowed = true;
+	if (_recreationPending && platform::device::_clock() - _lastResizeTime > config::ViewResizeDebounceInterval) {
+		// resize is finished, rebuild swapchain with exact window size
+		performRecreation(_pendingWidth, _pendingHeight);
+	}
 }
 
 void ViewImpl::pushEvent(AppEvent::Value val) const {
@@ -26,6 +26,8 @@
 
 #include "XLVkDevice.h"
 #include "XLGlSwapchain.h"
+#include "XLInputQueue.h"
+#include "XLGestureData.h"
 
 #include <sys/eventfd.h>
 
@@ -61,6 +63,32 @@ public:
 	virtual int getSocketFd() const override { return _socket; }
 
 protected:
+	void updateKeysymMapping(const xcb_setup_t *);
+	gesture::KeyCode getKeyCode(xcb_keycode_t) const;
+
+	void pushInputEvent(InputEventName, uint32_t id, uint32_t state, float x, float y, float valueX = 0.0f, float valueY = 0.0f);
+
+#if LINUX_XCB_XINPUT
+	struct XInputScrollValuator {
+		uint16_t device = 0;
+		uint16_t number = 0;
+		bool vertical = true;
+		double increment = 1.0;
+		double value = 0.0;
+		bool valid = false; // false until first value received, no scroll is reported for it
+	};
+
+	// XInput2 provides smooth scrolling valuators, raw motion and touches
+	bool initXInput();
+	void updateXInputDevices();
+	void handleXInputEvent(xcb_ge_generic_event_t *);
+	void handleXInputValuators(const xcb_input_button_press_event_t *, float x, float y);
+
+	uint8_t _xinputOpcode = 0;
+	bool _xinputEnabled = false;
+	Vector<XInputScrollValuator> _scrollValuators;
+#endif
+
 	const Instance *_instance = nullptr;
 	ViewImpl *_view = nullptr;
 	// Rc<gl::Loop> _loop;
@@ -73,6 +101,10 @@ protected:
 	uint16_t _width = 0;
 	uint16_t _height = 0;
 
+	xcb_keycode_t _minKeycode = 0;
+	uint8_t _keysymsPerKeycode = 0;
+	Vector<xcb_keysym_t> _keysyms;
+
 	int _eventFd = -1;
 	int _socket = -1;
 };
@@ -134,7 +166,9 @@ XcbView::XcbView(const Instance *inst, ViewImpl *v, StringView, URect rect) {
 	uint32_t mask = /* XCB_CW_BACK_PIXEL | */ XCB_CW_EVENT_MASK;
 	uint32_t values[1];
 	//values[0] = _defaultScreen->black_pixel;
-	values[0] = XCB_EVENT_MASK_EXPOSURE | XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_STRUCTURE_NOTIFY;
+	values[0] = XCB_EVENT_MASK_EXPOSURE | XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_KEY_RELEASE | XCB_EVENT_MASK_STRUCTURE_NOTIFY
+			| XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE | XCB_EVENT_MASK_POINTER_MOTION
+			| XCB_EVENT_MASK_ENTER_WINDOW | XCB_EVENT_MASK_LEAVE_WINDOW | XCB_EVENT_MASK_FOCUS_CHANGE;
 		/*XCB_EVENT_MASK_EXPOSURE | XCB_EVENT_MASK_BUTTON_PRESS |	XCB_EVENT_MASK_BUTTON_RELEASE | XCB_EVENT_MASK_POINTER_MOTION
 			| XCB_EVENT_MASK_ENTER_WINDOW | XCB_EVENT_MASK_LEAVE_WINDOW | XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_KEY_RELEASE
 			| XCB_EVENT_MASK_VISIBILITY_CHANGE | XCB_EVENT_MASK_RESIZE_REDIRECT | XCB_EVENT_MASK_FOCUS_CHANGE
@@ -186,6 +220,14 @@ XcbView::XcbView(const Instance *inst, ViewImpl *v, StringView, URect rect) {
 
 	xcb_change_property( _connection, XCB_PROP_MODE_REPLACE, _window, _atoms[0], 4, 32, 1, &_atoms[1] );
 
+	updateKeysymMapping(connection.setup);
+
+#if LINUX_XCB_XINPUT
+	_xinputEnabled = initXInput();
+	stappler::log::vtext("XcbView", "XInput2: ", _xinputEnabled ? "enabled" : "not available",
+			", scroll valuators: ", _scrollValuators.size());
+#endif
+
 	v->setScreenSize(_width, _height);
 }
 
@@ -219,6 +261,316 @@ VkSurfaceKHR XcbView::createWindowSurface() {
 	return surface;
 }
 
+void XcbView::updateKeysymMapping(const xcb_setup_t *setup) {
+	_minKeycode = setup->min_keycode;
+	auto cookie = xcb_get_keyboard_mapping(_connection, setup->min_keycode, setup->max_keycode - setup->min_keycode + 1);
+	if (auto reply = xcb_get_keyboard_mapping_reply(_connection, cookie, nullptr)) {
+		auto keysyms = xcb_get_keyboard_mapping_keysyms(reply);
+		auto len = xcb_get_keyboard_mapping_keysyms_length(reply);
+		_keysymsPerKeycode = reply->keysyms_per_keycode;
+		_keysyms.assign(keysyms, keysyms + len);
+		free(reply);
+	}
+}
+
+gesture::KeyCode XcbView::getKeyCode(xcb_keycode_t code) const {
+	using gesture::KeyCode;
+
+	if (code < _minKeycode || _keysymsPerKeycode == 0) {
+		return KeyCode::None;
+	}
+
+	// only first (unshifted) keysym is used, case is defined by modifiers
+	auto idx = size_t(code - _minKeycode) * _keysymsPerKeycode;
+	if (idx >= _keysyms.size()) {
+		return KeyCode::None;
+	}
+
+	auto sym = _keysyms[idx];
+	if (sym >= 'a' && sym <= 'z') {
+		return KeyCode(toInt(KeyCode::Key_A) + (sym - 'a'));
+	} else if (sym >= '0' && sym <= '9') {
+		return KeyCode(toInt(KeyCode::Key_0) + (sym - '0'));
+	} else if (sym >= 0xffbe && sym <= 0xffc9) { // XK_F1 - XK_F12
+		return KeyCode(toInt(KeyCode::Key_F1) + (sym - 0xffbe));
+	}
+
+	switch (sym) {
+	case ' ': return KeyCode::Key_Space; break;
+	case ',': return KeyCode::Key_Comma; break;
+	case '-': return KeyCode::Key_Minus; break;
+	case '.': return KeyCode::Key_Period; break;
+	case '/': return KeyCode::Key_Slash; break;
+	case ';': return KeyCode::Key_Semicolon; break;
+	case '=': return KeyCode::Key_Equal; break;
+	case '[': return KeyCode::Key_LeftBracket; break;
+	case '\\': return KeyCode::Key_BackSlash; break;
+	case ']': return KeyCode::Key_RightBracket; break;
+	case '`': return KeyCode::Key_Grave; break;
+	case '\'': return KeyCode::Key_Apostrophe; break;
+	case 0xff08: return KeyCode::Key_Backspace; break;
+	case 0xff09: return KeyCode::Key_Tab; break;
+	case 0xff0d: return KeyCode::Key_Return; break;
+	case 0xff13: return KeyCode::Key_Pause; break;
+	case 0xff14: return KeyCode::Key_ScrollLock; break;
+	case 0xff1b: return KeyCode::Key_Escape; break;
+	case 0xff50: return KeyCode::Key_Home; break;
+	case 0xff51: return KeyCode::Key_LeftArrow; break;
+	case 0xff52: return KeyCode::Key_UpArrow; break;
+	case 0xff53: return KeyCode::Key_RightArrow; break;
+	case 0xff54: return KeyCode::Key_DownArrow; break;
+	case 0xff55: return KeyCode::Key_PgUp; break;
+	case 0xff56: return KeyCode::Key_PgDown; break;
+	case 0xff57: return KeyCode::Key_End; break;
+	case 0xff61: return KeyCode::Key_Print; break;
+	case 0xff63: return KeyCode::Key_Insert; break;
+	case 0xff67: return KeyCode::Key_Menu; break;
+	case 0xff7f: return KeyCode::Key_NumLock; break;
+	case 0xff8d: return KeyCode::Key_NumPadEnter; break;
+	case 0xffe1: return KeyCode::Key_LeftShift; break;
+	case 0xffe2: return KeyCode::Key_RightShift; break;
+	case 0xffe3: return KeyCode::Key_LeftCtrl; break;
+	case 0xffe4: return KeyCode::Key_RightCtrl; break;
+	case 0xffe5: return KeyCode::Key_CapsLock; break;
+	case 0xffe9: return KeyCode::Key_LeftAlt; break;
+	case 0xffea: return KeyCode::Key_RightAlt; break;
+	case 0xffff: return KeyCode::Key_Delete; break;
+	default: break;
+	}
+	return KeyCode::None;
+}
+
+void XcbView::pushInputEvent(InputEventName name, uint32_t id, uint32_t state, float x, float y, float valueX, float valueY) {
+	InputEventData event;
+	event.id = id;
+	event.event = name;
+	event.modifiers = InputModifier(state);
+	event.x = x;
+	event.y = float(_height) - y; // XCB origin is in top left corner
+	event.valueX = valueX;
+	event.valueY = valueY;
+	event.time = platform::device::_clock();
+	_view->handleInputEvent(event);
+}
+
+#if LINUX_XCB_XINPUT
+
+static double getXInputValue(const xcb_input_fp3232_t &value) {
+	return double(value.integral) + double(value.frac) / double(1ULL << 32);
+}
+
+static float getXInputValue(xcb_input_fp1616_t value) {
+	return float(value) / 65536.0f;
+}
+
+bool XcbView::initXInput() {
+	auto ext = xcb_get_extension_data(_connection, &xcb_input_id);
+	if (!ext || !ext->present) {
+		return false;
+	}
+
+	auto versionCookie = xcb_input_xi_query_version(_connection, 2, 2);
+	auto version = xcb_input_xi_query_version_reply(_connection, versionCookie, nullptr);
+	if (!version) {
+		return false;
+	}
+
+	bool supported = version->major_version > 2 || (version->major_version == 2 && version->minor_version >= 2);
+	free(version);
+	if (!supported) {
+		return false;
+	}
+
+	_xinputOpcode = ext->major_opcode;
+
+	struct {
+		xcb_input_event_mask_t head;
+		uint32_t mask;
+	} windowMask, rootMask;
+
+	// XI2 selection replaces core pointer events for this window, keys are still delivered as core events
+	windowMask.head.deviceid = XCB_INPUT_DEVICE_ALL_MASTER;
+	windowMask.head.mask_len = 1;
+	windowMask.mask = XCB_INPUT_XI_EVENT_MASK_BUTTON_PRESS | XCB_INPUT_XI_EVENT_MASK_BUTTON_RELEASE
+			| XCB_INPUT_XI_EVENT_MASK_MOTION | XCB_INPUT_XI_EVENT_MASK_DEVICE_CHANGED
+			| XCB_INPUT_XI_EVENT_MASK_TOUCH_BEGIN | XCB_INPUT_XI_EVENT_MASK_TOUCH_UPDATE | XCB_INPUT_XI_EVENT_MASK_TOUCH_END;
+	xcb_input_xi_select_events(_connection, _window, 1, &windowMask.head);
+
+	// raw events are delivered only to root window
+	rootMask.head.deviceid = XCB_INPUT_DEVICE_ALL_MASTER;
+	rootMask.head.mask_len = 1;
+	rootMask.mask = XCB_INPUT_XI_EVENT_MASK_RAW_MOTION;
+	xcb_input_xi_select_events(_connection, _defaultScreen->root, 1, &rootMask.head);
+
+	updateXInputDevices();
+	xcb_flush(_connection);
+	return true;
+}
+
+void XcbView::updateXInputDevices() {
+	_scrollValuators.clear();
+
+	auto cookie = xcb_input_xi_query_device(_connection, XCB_INPUT_DEVICE_ALL);
+	auto reply = xcb_input_xi_query_device_reply(_connection, cookie, nullptr);
+	if (!reply) {
+		return;
+	}
+
+	auto devIt = xcb_input_xi_query_device_infos_iterator(reply);
+	for (; devIt.rem; xcb_input_xi_device_info_next(&devIt)) {
+		auto info = devIt.data;
+		auto classIt = xcb_input_xi_device_info_classes_iterator(info);
+		for (; classIt.rem; xcb_input_device_class_next(&classIt)) {
+			if (classIt.data->type == XCB_INPUT_DEVICE_CLASS_TYPE_SCROLL) {
+				auto scroll = (xcb_input_scroll_class_t *)classIt.data;
+				auto &v = _scrollValuators.emplace_back(XInputScrollValuator());
+				v.device = info->deviceid;
+				v.number = scroll->number;
+				v.vertical = (scroll->scroll_type == XCB_INPUT_SCROLL_TYPE_VERTICAL);
+				v.increment = getXInputValue(scroll->increment);
+				if (v.increment == 0.0) {
+					v.increment = 1.0;
+				}
+			}
+		}
+	}
+
+	free(reply);
+}
+
+void XcbView::handleXInputValuators(const xcb_input_button_press_event_t *ev, float x, float y) {
+	auto mask = xcb_input_button_press_valuator_mask((xcb_input_button_press_event_t *)ev);
+	auto values = xcb_input_button_press_axisvalues((xcb_input_button_press_event_t *)ev);
+
+	float scrollX = 0.0f;
+	float scrollY = 0.0f;
+	size_t valueIdx = 0;
+	for (uint32_t i = 0; i < uint32_t(ev->valuators_len) * 32; ++ i) {
+		if ((mask[i / 32] & (1 << (i % 32))) == 0) {
+			continue;
+		}
+
+		auto value = getXInputValue(values[valueIdx ++]);
+		for (auto &it : _scrollValuators) {
+			if (it.device == ev->sourceid && it.number == i) {
+				if (it.valid) {
+					// positive valuator direction is down/right, engine uses up/left as positive
+					auto delta = float((value - it.value) / it.increment);
+					if (it.vertical) {
+						scrollY -= delta;
+					} else {
+						scrollX -= delta;
+					}
+				}
+				it.value = value;
+				it.valid = true;
+				break;
+			}
+		}
+	}
+
+	if (scrollX != 0.0f || scrollY != 0.0f) {
+		pushInputEvent(InputEventName::Scroll, maxOf<uint32_t>(), ev->mods.effective, x, y, scrollX, scrollY);
+	}
+}
+
+void XcbView::handleXInputEvent(xcb_ge_generic_event_t *e) {
+	switch (e->event_type) {
+	case XCB_INPUT_DEVICE_CHANGED:
+		updateXInputDevices();
+		break;
+	case XCB_INPUT_BUTTON_PRESS: {
+		auto ev = (xcb_input_button_press_event_t *)e;
+		auto x = getXInputValue(ev->event_x);
+		auto y = getXInputValue(ev->event_y);
+		if (ev->detail >= 4 && ev->detail <= 7) {
+			if ((ev->flags & XCB_INPUT_POINTER_EVENT_FLAGS_POINTER_EMULATED) != 0) {
+				break; // emulated from smooth scroll valuators, already reported
+			}
+			switch (ev->detail) {
+			case 4: pushInputEvent(InputEventName::Scroll, ev->detail, ev->mods.effective, x, y, 0.0f, 1.0f); break;
+			case 5: pushInputEvent(InputEventName::Scroll, ev->detail, ev->mods.effective, x, y, 0.0f, -1.0f); break;
+			case 6: pushInputEvent(InputEventName::Scroll, ev->detail, ev->mods.effective, x, y, -1.0f, 0.0f); break;
+			case 7: pushInputEvent(InputEventName::Scroll, ev->detail, ev->mods.effective, x, y, 1.0f, 0.0f); break;
+			}
+		} else {
+			pushInputEvent(InputEventName::Begin, ev->detail, ev->mods.effective, x, y);
+		}
+		break;
+	}
+	case XCB_INPUT_BUTTON_RELEASE: {
+		auto ev = (xcb_input_button_release_event_t *)e;
+		if (ev->detail < 4 || ev->detail > 7) {
+			pushInputEvent(InputEventName::End, ev->detail, ev->mods.effective,
+					getXInputValue(ev->event_x), getXInputValue(ev->event_y));
+		}
+		break;
+	}
+	case XCB_INPUT_MOTION: {
+		auto ev = (xcb_input_motion_event_t *)e;
+		auto x = getXInputValue(ev->event_x);
+		auto y = getXInputValue(ev->event_y);
+
+		handleXInputValuators(ev, x, y);
+
+		uint32_t button = maxOf<uint32_t>();
+		if (ev->buttons_len > 0) {
+			auto buttons = xcb_input_button_press_button_mask(ev)[0];
+			for (uint32_t i = 1; i <= 3; ++ i) {
+				if (buttons & (1 << i)) {
+					button = i;
+					break;
+				}
+			}
+		}
+
+		if (button != maxOf<uint32_t>()) {
+			pushInputEvent(InputEventName::Move, button, ev->mods.effective, x, y);
+		} else {
+			pushInputEvent(InputEventName::MouseMove, maxOf<uint32_t>(), ev->mods.effective, x, y);
+		}
+		break;
+	}
+	case XCB_INPUT_RAW_MOTION: {
+		auto ev = (xcb_input_raw_motion_event_t *)e;
+		auto mask = xcb_input_raw_button_press_valuator_mask(ev);
+		auto values = xcb_input_raw_button_press_axisvalues_raw(ev);
+
+		// valuators 0 and 1 are relative X and Y
+		float dx = 0.0f, dy = 0.0f;
+		size_t valueIdx = 0;
+		for (uint32_t i = 0; i < 2 && ev->valuators_len > 0; ++ i) {
+			if (mask[0] & (1 << i)) {
+				auto value = float(getXInputValue(values[valueIdx ++]));
+				if (i == 0) { dx = value; } else { dy = -value; }
+			}
+		}
+		if (dx != 0.0f || dy != 0.0f) {
+			InputEventData event;
+			event.event = InputEventName::RawMotion;
+			event.valueX = dx;
+			event.valueY = dy;
+			event.time = platform::device::_clock();
+			_view->handleInputEvent(event);
+		}
+		break;
+	}
+	case XCB_INPUT_TOUCH_BEGIN:
+	case XCB_INPUT_TOUCH_UPDATE:
+	case XCB_INPUT_TOUCH_END: {
+		auto ev = (xcb_input_touch_begin_event_t *)e;
+		auto name = (e->event_type == XCB_INPUT_TOUCH_BEGIN) ? InputEventName::Begin
+				: ((e->event_type == XCB_INPUT_TOUCH_END) ? InputEventName::End : InputEventName::Move);
+		pushInputEvent(name, ev->detail, ev->mods.effective, getXInputValue(ev->event_x), getXInputValue(ev->event_y));
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+#endif
+
 void print_modifiers (uint32_t mask) {
 	const char **mod, *mods[] = { "Shift", "Lock", "Ctrl", "Alt", "Mod2", "Mod3",
 			"Mod4", "Mod5", "Button1", "Button2", "Button3", "Button4", "Button5" };
@@ -232,73 +584,78 @@ void print_modifiers (uint32_t mask) {
 }
 
 bool XcbView::poll() {
+	// configure events are coalesced within single poll batch, only last size is applied
+	bool resized = false;
+
 	xcb_generic_event_t *e;
 	while ((e = xcb_poll_for_event(_connection))) {
 		auto et = e->response_type & 0x7f;
 		switch (et) {
 		case XCB_EXPOSE: {
 			xcb_expose_event_t *ev = (xcb_expose_event_t*) e;
-			printf("XCB_EXPOSE: Window %d exposed. Region to be redrawn at location (%d,%d), with dimension (%d,%d)\n",
-					ev->window, ev->x, ev->y, ev->width, ev->height);
+			// exposed area is not covered by incremental present, so, next frame is drawn and presented fully;
+			// count is a number of expose events, that follow in same series
+			if (ev->count == 0) {
+				_view->invalidateContent();
+			}
 			break;
 		}
 		case XCB_BUTTON_PRESS: {
 			xcb_button_press_event_t *ev = (xcb_button_press_event_t*) e;
-			print_modifiers(ev->state);
-
 			switch (ev->detail) {
-			case 4:
-				printf("Wheel Button up in window %d, at coordinates (%d,%d)\n", ev->event, ev->event_x, ev->event_y);
-				break;
-			case 5:
-				printf("Wheel Button down in window %d, at coordinates (%d,%d)\n", ev->event, ev->event_x, ev->event_y);
-				break;
-			default:
-				printf("Button %d pressed in window %d, at coordinates (%d,%d)\n", ev->detail, ev->event, ev->event_x, ev->event_y);
+			case 4: pushInputEvent(InputEventName::Scroll, ev->detail, ev->state, ev->event_x, ev->event_y, 0.0f, 1.0f); break;
+			case 5: pushInputEvent(InputEventName::Scroll, ev->detail, ev->state, ev->event_x, ev->event_y, 0.0f, -1.0f); break;
+			case 6: pushInputEvent(InputEventName::Scroll, ev->detail, ev->state, ev->event_x, ev->event_y, -1.0f, 0.0f); break;
+			case 7: pushInputEvent(InputEventName::Scroll, ev->detail, ev->state, ev->event_x, ev->event_y, 1.0f, 0.0f); break;
+			default: pushInputEvent(InputEventName::Begin, ev->detail, ev->state, ev->event_x, ev->event_y); break;
 			}
 			break;
 		}
 		case XCB_BUTTON_RELEASE: {
 			xcb_button_release_event_t *ev = (xcb_button_release_event_t*) e;
-			print_modifiers(ev->state);
-			printf("Button %d released in window %d, at coordinates (%d,%d)\n", ev->detail, ev->event, ev->event_x, ev->event_y);
+			if (ev->detail < 4 || ev->detail > 7) { // wheel buttons are reported with press only
+				pushInputEvent(InputEventName::End, ev->detail, ev->state, ev->event_x, ev->event_y);
+			}
 			break;
 		}
 		case XCB_MOTION_NOTIFY: {
-			// xcb_motion_notify_event_t *ev = (xcb_motion_notify_event_t*) e;
-			//printf("Mouse moved in window %ld, at coordinates (%d,%d)\n", ev->event, ev->event_x, ev->event_y);
+			xcb_motion_notify_event_t *ev = (xcb_motion_notify_event_t*) e;
+			// motion events are coalesced by Director, one sample per frame
+			auto buttons = ev->state & (XCB_BUTTON_MASK_1 | XCB_BUTTON_MASK_2 | XCB_BUTTON_MASK_3);
+			if (buttons) {
+				uint32_t button = (buttons & XCB_BUTTON_MASK_1) ? 1 : ((buttons & XCB_BUTTON_MASK_2) ? 2 : 3);
+				pushInputEvent(InputEventName::Move, button, ev->state, ev->event_x, ev->event_y);
+			} else {
+				pushInputEvent(InputEventName::MouseMove, maxOf<uint32_t>(), ev->state, ev->event_x, ev->event_y);
+			}
 			break;
 		}
 		case XCB_ENTER_NOTIFY: {
 			xcb_enter_notify_event_t *ev = (xcb_enter_notify_event_t*) e;
-			printf("Mouse entered window %d, at coordinates (%d,%d)\n", ev->event, ev->event_x, ev->event_y);
+			pushInputEvent(InputEventName::PointerEnter, maxOf<uint32_t>(), ev->state, ev->event_x, ev->event_y);
 			break;
 		}
 		case XCB_LEAVE_NOTIFY: {
 			xcb_leave_notify_event_t *ev = (xcb_leave_notify_event_t*) e;
-			printf("Mouse left window %d, at coordinates (%d,%d)\n", ev->event, ev->event_x, ev->event_y);
+			pushInputEvent(InputEventName::PointerLeave, maxOf<uint32_t>(), ev->state, ev->event_x, ev->event_y);
 			break;
 		}
 		case XCB_FOCUS_IN: {
-			xcb_focus_in_event_t *ev = (xcb_focus_in_event_t*) e;
-			printf("XCB_FOCUS_IN: %d\n", ev->event);
+			pushInputEvent(InputEventName::FocusGained, maxOf<uint32_t>(), 0, 0, _height);
 			break;
 		}
 		case XCB_FOCUS_OUT: {
-			xcb_focus_in_event_t *ev = (xcb_focus_in_event_t*) e;
-			printf("XCB_FOCUS_OUT: %d\n", ev->event);
+			pushInputEvent(InputEventName::FocusLost, maxOf<uint32_t>(), 0, 0, _height);
 			break;
 		}
 		case XCB_KEY_PRESS: {
 			xcb_key_press_event_t *ev = (xcb_key_press_event_t*) e;
-			print_modifiers(ev->state);
-			printf("Key pressed in window %d\n", ev->event);
+			pushInputEvent(InputEventName::KeyPressed, toInt(getKeyCode(ev->detail)), ev->state, ev->event_x, ev->event_y);
 			break;
 		}
 		case XCB_KEY_RELEASE: {
 			xcb_key_release_event_t *ev = (xcb_key_release_event_t*) e;
-			print_modifiers(ev->state);
-			printf("Key released in window %d\n", ev->event);
+			pushInputEvent(InputEventName::KeyReleased, toInt(getKeyCode(ev->detail)), ev->state, ev->event_x, ev->event_y);
 			break;
 		}
 		case XCB_VISIBILITY_NOTIFY: {
@@ -317,14 +674,22 @@ bool XcbView::poll() {
 			printf("XCB_REPARENT_NOTIFY: %d %d to %d\n", ev->event, ev->window, ev->parent);
 			break;
 		}
+#if LINUX_XCB_XINPUT
+		case XCB_GE_GENERIC: {
+			auto ev = (xcb_ge_generic_event_t *)e;
+			if (_xinputEnabled && ev->extension == _xinputOpcode) {
+				handleXInputEvent(ev);
+			}
+			break;
+		}
+#endif
 		case XCB_CONFIGURE_NOTIFY : {
 			xcb_configure_notify_event_t *ev = (xcb_configure_notify_event_t*) e;
 			printf("XCB_CONFIGURE_NOTIFY: %d (%d) rect:%d,%d,%d,%d border:%d override:%d\n", ev->event, ev->window,
 					ev->x, ev->y, ev->width, ev->height, uint32_t(ev->border_width), uint32_t(ev->override_redirect));
 			if (ev->width != _width || ev->height != _height) {
 				_width = ev->width; _height = ev->height;
-				_view->recreateSwapChain();
-				_view->setScreenSize(_width, _height);
+				resized = true;
 			}
 			break;
 		}
@@ -346,6 +711,11 @@ bool XcbView::poll() {
 		/* Free the Generic Event */
 		free(e);
 	}
+
+	if (resized) {
+		// screen size is updated, when swapchain is rebuilt, so, projection matches swapchain images
+		_view->recreateSwapChain(_width, _height);
+	}
 	return true;
 }
 
@@ -31,6 +31,8 @@ namespace stappler::xenolith::shaders {
 #include "compiled/shader_vertex.vert"
 #include "compiled/shader_material.frag"
 #include "compiled/shader_material.vert"
+#include "compiled/shader_material_compact2d.vert"
+#include "compiled/shader_material_compact3d.vert"
 
 SpanView<uint32_t> DefaultFrag(default_frag, sizeof(default_frag) / sizeof(uint32_t));
 SpanView<uint32_t> DefaultVert(default_vert, sizeof(default_vert) / sizeof(uint32_t));
@@ -40,5 +42,16 @@ SpanView<uint32_t> VertexVert(vertex_vert, sizeof(vertex_vert) / sizeof(uint32_t
 
 SpanView<uint32_t> MaterialFrag(material_frag, sizeof(material_frag) / sizeof(uint32_t));
 SpanView<uint32_t> MaterialVert(material_vert, sizeof(material_vert) / sizeof(uint32_t));
+SpanView<uint32_t> MaterialCompact2DVert(material_compact2d_vert, sizeof(material_compact2d_vert) / sizeof(uint32_t));
+SpanView<uint32_t> MaterialCompact3DVert(material_compact3d_vert, sizeof(material_compact3d_vert) / sizeof(uint32_t));
+
+SpanView<uint32_t> getMaterialVertexShader(gl::VertexFormat format) {
+	switch (format) {
+	case gl::VertexFormat::V4F_V4F_T2F2U: return MaterialVert; break;
+	case gl::VertexFormat::V2F_C4B_T2H_2U: return MaterialCompact2DVert; break;
+	case gl::VertexFormat::V3F_C4B_T2H_2U: return MaterialCompact3DVert; break;
+	}
+	return MaterialVert;
+}
 
 }
@@ -33,6 +33,11 @@ extern SpanView<uint32_t> VertexFrag;
 extern SpanView<uint32_t> VertexVert;
 extern SpanView<uint32_t> MaterialFrag;
 extern SpanView<uint32_t> MaterialVert;
+extern SpanView<uint32_t> MaterialCompact2DVert;
+extern SpanView<uint32_t> MaterialCompact3DVert;
+
+// material vertex shader, that reads vertexes in specified format
+SpanView<uint32_t> getMaterialVertexShader(gl::VertexFormat);
 
 }
 
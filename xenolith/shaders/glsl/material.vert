@@ -5,8 +5,17 @@ struct Vertex {
 	vec4 pos;
 	vec4 color;
 	vec2 tex;
+	uint material;
 	uint object;
+};
+
+struct QuadInstance {
+	vec4 transform;
+	vec2 origin;
+	uint color;
 	uint material;
+	uint texCoords[2];
+	uint padding[2];
 };
 
 struct Material {
@@ -16,12 +25,6 @@ struct Material {
 	uint padding0;
 };
 
-layout (push_constant) uniform pcb {
-	uint materialIdx;
-	uint padding0;
-	uint padding1;
-} pushConstants;
-
 layout (set = 0, binding = 1) readonly buffer Vertices {
 	Vertex vertices[];
 };
@@ -30,11 +33,37 @@ layout (set = 0, binding = 2) readonly buffer Materials {
 	Material materials[];
 };
 
+layout (set = 0, binding = 3) readonly buffer Transforms {
+	mat4 transforms[];
+};
+
+layout (set = 0, binding = 4) readonly buffer Instances {
+	QuadInstance instances[];
+};
+
 layout (location = 0) out vec4 fragColor;
 layout (location = 1) out vec2 fragTexCoord;
+layout (location = 2) flat out uint fragMaterial;
 
 void main() {
-	gl_Position = vec4(vertices[gl_VertexIndex].pos.xy, 0.0, 1.0);
-	fragColor = vertices[gl_VertexIndex].color;
-	fragTexCoord = vertices[gl_VertexIndex].tex;
+	if (gl_InstanceIndex > 0) {
+		// instanced quad: gl_VertexIndex is a corner of shared unit quad (tl bl tr br)
+		QuadInstance inst = instances[gl_InstanceIndex - 1];
+		uint right = uint(gl_VertexIndex) >> 1;
+		uint bottom = uint(gl_VertexIndex) & 1;
+		vec2 unit = vec2(float(right), float(1 - bottom));
+		vec2 tl = unpackUnorm2x16(inst.texCoords[0]);
+		vec2 br = unpackUnorm2x16(inst.texCoords[1]);
+
+		gl_Position = vec4(inst.transform.xy * unit.x + inst.transform.zw * unit.y + inst.origin, 0.0, 1.0);
+		fragColor = unpackUnorm4x8(inst.color);
+		fragTexCoord = vec2(right == 0 ? tl.x : br.x, bottom == 0 ? tl.y : br.y);
+		fragMaterial = inst.material;
+	} else {
+		vec4 pos = transforms[vertices[gl_VertexIndex].object] * vertices[gl_VertexIndex].pos;
+		gl_Position = vec4(pos.xy, 0.0, 1.0);
+		fragColor = vertices[gl_VertexIndex].color;
+		fragTexCoord = vertices[gl_VertexIndex].tex;
+		fragMaterial = vertices[gl_VertexIndex].material;
+	}
 }
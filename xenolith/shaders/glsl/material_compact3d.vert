@@ -0,0 +1,74 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Vertex_V3F_C4B_T2H_2U: color - RGBA8 unorm, tex - half-float pair
+// position stored as separate floats, vec3 would be 16-byte aligned in std430
+struct Vertex {
+	float x;
+	float y;
+	float z;
+	uint color;
+	uint tex;
+	uint material;
+	uint object;
+};
+
+struct QuadInstance {
+	vec4 transform;
+	vec2 origin;
+	uint color;
+	uint material;
+	uint texCoords[2];
+	uint padding[2];
+};
+
+struct Material {
+	uint samplerIdx;
+	uint textureIdx;
+	uint setIdx;
+	uint padding0;
+};
+
+layout (set = 0, binding = 1) readonly buffer Vertices {
+	Vertex vertices[];
+};
+
+layout (set = 0, binding = 2) readonly buffer Materials {
+	Material materials[];
+};
+
+layout (set = 0, binding = 3) readonly buffer Transforms {
+	mat4 transforms[];
+};
+
+layout (set = 0, binding = 4) readonly buffer Instances {
+	QuadInstance instances[];
+};
+
+layout (location = 0) out vec4 fragColor;
+layout (location = 1) out vec2 fragTexCoord;
+layout (location = 2) flat out uint fragMaterial;
+
+void main() {
+	if (gl_InstanceIndex > 0) {
+		// instanced quad: gl_VertexIndex is a corner of shared unit quad (tl bl tr br)
+		QuadInstance inst = instances[gl_InstanceIndex - 1];
+		uint right = uint(gl_VertexIndex) >> 1;
+		uint bottom = uint(gl_VertexIndex) & 1;
+		vec2 unit = vec2(float(right), float(1 - bottom));
+		vec2 tl = unpackUnorm2x16(inst.texCoords[0]);
+		vec2 br = unpackUnorm2x16(inst.texCoords[1]);
+
+		gl_Position = vec4(inst.transform.xy * unit.x + inst.transform.zw * unit.y + inst.origin, 0.0, 1.0);
+		fragColor = unpackUnorm4x8(inst.color);
+		fragTexCoord = vec2(right == 0 ? tl.x : br.x, bottom == 0 ? tl.y : br.y);
+		fragMaterial = inst.material;
+	} else {
+		Vertex v = vertices[gl_VertexIndex];
+		vec4 pos = transforms[v.object] * vec4(v.x, v.y, v.z, 1.0);
+		gl_Position = vec4(pos.xy, 0.0, 1.0);
+		fragColor = unpackUnorm4x8(v.color);
+		fragTexCoord = unpackHalf2x16(v.tex);
+		fragMaterial = v.material;
+	}
+}
@@ -34,7 +34,7 @@ XENOLITH_OUTPUT_DIR = $(abspath $(TOOLKIT_OUTPUT)/xenolith)
 XENOLITH_OUTPUT_STATIC = $(abspath $(TOOLKIT_OUTPUT)/libxenolith.a)
 
 # linker flags and extra libs (libhyphen.a and libfreetype.a from stappler)
-OSTYPE_XENOLITH_LIBS += $(OSTYPE_CLI_LIBS) -l:libhyphen.a -l:libfreetype.a -lX11 -lXrandr -lXi -lXinerama -lXcursor -lxcb
+OSTYPE_XENOLITH_LIBS += $(OSTYPE_CLI_LIBS) -l:libhyphen.a -l:libfreetype.a -lX11 -lXrandr -lXi -lXinerama -lXcursor -lxcb -lxcb-xinput
 
 # use default stappler LDFLAGS for OS
 XENOLITH_LDFLAGS := $(OSTYPE_LDFLAGS)
@@ -52,6 +52,7 @@ XENOLITH_SRCS_DIRS += \
 	$(XENOLITH_MAKEFILE_DIR)/core \
 	$(XENOLITH_MAKEFILE_DIR)/gl \
 	$(XENOLITH_MAKEFILE_DIR)/nodes \
+	$(XENOLITH_MAKEFILE_DIR)/features \
 
 # extra sources: platrom deps and shaders
 XENOLITH_SRCS_OBJS += \